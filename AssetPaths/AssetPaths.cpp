@@ -0,0 +1,70 @@
+#include "AssetPaths.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+// Set by CMake; a build without them falls back to the working directory.
+#ifndef MVK_SOURCE_DIR
+    #define MVK_SOURCE_DIR "."
+#endif
+#ifndef MVK_BINARY_DIR
+    #define MVK_BINARY_DIR "."
+#endif
+
+static std::filesystem::path DirectoryFromEnvironment(const char* variable, const char* fallback) {
+    const char* value = std::getenv(variable);
+    return value && value[0] != '\0' ? value : fallback;
+}
+
+namespace mvk {
+    void AssetPaths::TakeArguments(int& argc, char** argv) {
+        std::string asset;
+        std::string output;
+
+        int kept = 1;
+        for (int i = 1; i < argc; ++i) {
+            bool is_asset = std::strcmp(argv[i], "--assets") == 0;
+            bool is_output = std::strcmp(argv[i], "--output") == 0;
+            if (!is_asset && !is_output) {
+                argv[kept++] = argv[i];
+                continue;
+            }
+            if (i + 1 >= argc)
+                throw std::runtime_error(std::string(argv[i]) + " needs a directory.");
+            (is_asset ? asset : output) = argv[++i];
+        }
+        argc = kept;
+        argv[argc] = nullptr;
+
+        Configure(asset, output);
+    }
+
+    void AssetPaths::Configure(const std::string& asset, const std::string& output) {
+        if (!asset.empty())
+            asset_dir() = asset;
+        if (!output.empty())
+            output_dir() = output;
+    }
+
+    std::string AssetPaths::Asset(const std::string& relative_path) {
+        return (asset_dir() / relative_path).string();
+    }
+
+    std::string AssetPaths::Output(const std::string& relative_path) {
+        std::error_code error;
+        std::filesystem::create_directories(output_dir(), error);
+        return (output_dir() / relative_path).string();
+    }
+
+    std::filesystem::path& AssetPaths::asset_dir() {
+        static std::filesystem::path dir = DirectoryFromEnvironment("MVK_ASSET_DIR", MVK_SOURCE_DIR);
+        return dir;
+    }
+
+    std::filesystem::path& AssetPaths::output_dir() {
+        static std::filesystem::path dir = DirectoryFromEnvironment("MVK_OUTPUT_DIR", MVK_BINARY_DIR);
+        return dir;
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef MVK_ASSET_PATHS
+#define MVK_ASSET_PATHS
+
+#include <filesystem>
+#include <string>
+
+namespace mvk {
+    // Resolves the relative paths in MVKConstants.h. Shaders, meshes and textures are
+    // read from the asset directory; caches and traces are written to the output directory.
+    // Each directory is taken from, in order: the command line, MVK_ASSET_DIR /
+    // MVK_OUTPUT_DIR, and the source and build directories the binary was configured in.
+    class AssetPaths {
+       public:
+        // Removes --assets <dir> and --output <dir> from argv, so the remaining arguments
+        // can be parsed as before. Call before anything is loaded.
+        static void TakeArguments(int& argc, char** argv);
+        // Empty directories leave the current one in place.
+        static void Configure(const std::string& asset, const std::string& output);
+
+        static std::string Asset(const std::string& relative_path);
+        // Creates the output directory on first use.
+        static std::string Output(const std::string& relative_path);
+
+       private:
+        static std::filesystem::path& asset_dir();
+        static std::filesystem::path& output_dir();
+    };
+}
+
+#endif  // MVK_ASSET_PATHS
@@ -0,0 +1,107 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <vulkan/vulkan.hpp>
+
+#include "../DispatchTable/DispatchTable.h"
+
+// Records the same commands three ways: through a vk::DispatchLoaderDynamic built every
+// frame (what RecordCommandBuffer used to do for setPolygonModeEXT), through the loader
+// trampolines, and through the cached DispatchTable's device-level pointers. Needs no
+// window or surface.
+
+template <typename F>
+static double MeasureMicroseconds(int repeats, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i)
+        body();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::stoi(argv[1]) : 1000;
+    int commands = argc > 2 ? std::stoi(argv[2]) : 1000;
+
+    try {
+        vk::ApplicationInfo app_info;
+        app_info.setApiVersion(VK_API_VERSION_1_3);
+        vk::InstanceCreateInfo instance_info{};
+        instance_info.setPApplicationInfo(&app_info);
+        vk::Instance instance = vk::createInstance(instance_info);
+
+        auto devices = instance.enumeratePhysicalDevices();
+        if (devices.empty()) throw std::runtime_error("Supported GPU not found.");
+        vk::PhysicalDevice physical_device = devices[0];
+
+        uint32_t graphics_family = UINT32_MAX;
+        auto families = physical_device.getQueueFamilyProperties();
+        for (uint32_t i = 0; i < families.size() && graphics_family == UINT32_MAX; ++i) {
+            if (families[i].queueFlags & vk::QueueFlagBits::eGraphics)
+                graphics_family = i;
+        }
+        if (graphics_family == UINT32_MAX) throw std::runtime_error("No graphics queue.");
+
+        float priority = 1.0f;
+        vk::DeviceQueueCreateInfo queue_info{};
+        queue_info.setQueueFamilyIndex(graphics_family);
+        queue_info.setQueueCount(1);
+        queue_info.setQueuePriorities(priority);
+        vk::DeviceCreateInfo device_info{};
+        device_info.setQueueCreateInfoCount(1);
+        device_info.setPQueueCreateInfos(&queue_info);
+        vk::Device device = physical_device.createDevice(device_info);
+
+        mvk::DispatchTable table;
+        table.InitInstance(instance);
+        table.InitDevice(device);
+
+        vk::CommandPoolCreateInfo pool_info{};
+        pool_info.setQueueFamilyIndex(graphics_family);
+        pool_info.setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+        vk::CommandPool pool = device.createCommandPool(pool_info);
+
+        vk::CommandBufferAllocateInfo alloc_info{};
+        alloc_info.setCommandPool(pool);
+        alloc_info.setLevel(vk::CommandBufferLevel::ePrimary);
+        alloc_info.setCommandBufferCount(1);
+        vk::CommandBuffer command_buffer = device.allocateCommandBuffers(alloc_info)[0];
+
+        vk::Viewport viewport(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f);
+        auto Record = [&](const auto& dispatch) {
+            command_buffer.reset();
+            command_buffer.begin(vk::CommandBufferBeginInfo{}, dispatch);
+            for (int i = 0; i < commands; ++i)
+                command_buffer.setViewport(0, 1, &viewport, dispatch);
+            command_buffer.end(dispatch);
+        };
+
+        // Every variant records the same commands, so the differences are the dispatch cost alone.
+        double rebuilt = MeasureMicroseconds(frames, [&]() {
+            vk::DispatchLoaderDynamic loader(instance, vkGetInstanceProcAddr);
+            Record(loader);
+        });
+        double trampoline = MeasureMicroseconds(frames, [&]() { Record(VULKAN_HPP_DEFAULT_DISPATCHER); });
+        double direct = MeasureMicroseconds(frames, [&]() { Record(table.get()); });
+
+        // The name lives in the instance; read it before tearing down.
+        std::string device_name = physical_device.getProperties().deviceName;
+
+        device.destroyCommandPool(pool);
+        device.destroy();
+        instance.destroy();
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "device: " << device_name << '\n'
+                  << "record " << commands << " cmds, loader built per frame: " << rebuilt << " us\n"
+                  << "record " << commands << " cmds, loader trampolines:     " << trampoline << " us\n"
+                  << "record " << commands << " cmds, cached DispatchTable:   " << direct << " us\n"
+                  << "saved per frame:                          " << rebuilt - direct << " us\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return -1;
+    }
+
+    return 0;
+}
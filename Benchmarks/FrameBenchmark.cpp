@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "../AssetPaths/AssetPaths.h"
+#include "../Presenter/Presenter.h"
+
+// Renders a fixed number of frames headless along a deterministic orbit, so runs on the
+// same machine are comparable, and prints the results as JSON.
+// Usage: MVKBench [--assets dir] [--output dir] [--json report.json] [warmup frames] [measured frames]
+// The report goes to stdout without --json, and everything the renderer logs goes to
+// stderr either way so stdout stays valid JSON. A relative report path is taken from
+// the working directory, not from --output.
+
+struct Summary {
+    double mean = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+};
+
+static Summary Summarize(std::vector<double> samples) {
+    Summary summary;
+    if (samples.empty()) return summary;
+
+    std::sort(samples.begin(), samples.end());
+    auto Percentile = [&](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    };
+
+    double total = 0.0;
+    for (double sample : samples) total += sample;
+
+    summary.mean = total / samples.size();
+    summary.p50 = Percentile(50.0);
+    summary.p95 = Percentile(95.0);
+    summary.p99 = Percentile(99.0);
+    summary.max = samples.back();
+    return summary;
+}
+
+static void WriteSummary(std::ostream& out, const char* name, const Summary& summary) {
+    out << "    \"" << name << "\": {\"mean\": " << summary.mean << ", \"p50\": " << summary.p50
+        << ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max << "}";
+}
+
+static uint64_t PeakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// One orbit around the model over the measured frames, animation stepped at 60 Hz.
+static void PlaceCamera(mvk::VKPresenter& screen, uint32_t frame, uint32_t frame_count) {
+    float angle = 2.0f * 3.14159265f * frame / std::max<uint32_t>(frame_count, 1);
+    screen.set_camera(glm::vec3(5.0f * std::sin(angle), 1.5f, 5.0f * std::cos(angle)), glm::vec3(0.0f, -0.2f, 0.0f));
+    screen.set_animation_time(frame / 60.0f);
+}
+
+int main(int argc, char** argv) {
+    // INFO and WARNING lines are written to std::cout, also from worker threads and the
+    // validation callback; only the report is restored to stdout.
+    std::streambuf* stdout_buffer = std::cout.rdbuf(std::cerr.rdbuf());
+
+    uint32_t warmup = 100;
+    uint32_t measured = 1000;
+    std::string output;
+
+    try {
+        mvk::AssetPaths::TakeArguments(argc, argv);
+
+        std::vector<std::string> counts;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--json") {
+                if (i + 1 >= argc)
+                    throw std::runtime_error("--json needs a path.");
+                output = argv[++i];
+            } else {
+                counts.push_back(arg);
+            }
+        }
+        if (counts.size() > 2)
+            throw std::runtime_error("Unknown argument: " + counts[2]);
+        if (counts.size() > 0)
+            warmup = static_cast<uint32_t>(std::stoul(counts[0]));
+        if (counts.size() > 1)
+            measured = static_cast<uint32_t>(std::stoul(counts[1]));
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return -1;
+    }
+
+    mvk::VKPresenter screen;
+    std::vector<double> cpu_ms;
+    cpu_ms.reserve(measured);
+    mvk::AllocatorStatistics memory;
+
+    auto startup_begin = std::chrono::steady_clock::now();
+    double startup_ms = 0.0, measured_s = 0.0, resident_ms = -1.0;
+
+    try {
+        // GPU frame times are read back from the profiler, which has to hold every frame.
+        mvk::ProfilerSettings profiling;
+        profiling.enabled = true;
+        profiling.max_events = std::max<size_t>(mvk::PROFILER_DEFAULT_MAX_EVENTS,
+                                                static_cast<size_t>(warmup + measured) * 2 * mvk::PROFILER_MAX_GPU_SCOPES);
+        screen.set_profiling(profiling);
+        screen.Setup(nullptr);
+        startup_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startup_begin).count();
+
+        for (uint32_t i = 0; i < warmup; ++i) {
+            PlaceCamera(screen, i, warmup);
+            screen.DrawFrame();
+            if (resident_ms < 0.0 && screen.textures_resident())
+                resident_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startup_begin).count();
+        }
+
+        auto measured_begin = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < measured; ++i) {
+            PlaceCamera(screen, i, measured);
+
+            auto frame_start = std::chrono::steady_clock::now();
+            screen.DrawFrame();
+            cpu_ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame_start).count());
+        }
+        screen.get_logical_device().waitIdle();
+        measured_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - measured_begin).count();
+
+        memory = screen.memory_statistics();
+        // Resolves the last frames in flight into the profiler.
+        screen.DestroyEverything();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return -1;
+    }
+
+    // Profiler frames are numbered from 1 in DrawFrame order.
+    std::vector<double> gpu_ms;
+    for (const auto &event : screen.profiler().events()) {
+        if (event.gpu && event.name == "frame" && event.frame > warmup)
+            gpu_ms.push_back(event.duration_us / 1000.0);
+    }
+
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"warmup_frames\": " << warmup << ",\n"
+         << "  \"measured_frames\": " << measured << ",\n"
+         << "  \"fps\": " << (measured_s > 0.0 ? measured / measured_s : 0.0) << ",\n"
+         << "  \"frame_ms\": {\n";
+    WriteSummary(json, "cpu", Summarize(cpu_ms));
+    json << ",\n";
+    WriteSummary(json, "gpu", Summarize(gpu_ms));
+    json << "\n  },\n"
+         << "  \"startup_ms\": {\"total\": " << startup_ms;
+    for (const auto &[phase, ms] : screen.setup_phases())
+        json << ", \"" << phase << "\": " << ms;
+    json << "},\n"
+         << "  \"textures_resident_ms\": " << resident_ms << ",\n"
+         << "  \"memory\": {\"peak_resident_bytes\": " << PeakResidentBytes()
+         << ", \"device_bytes\": " << memory.device_bytes
+         << ", \"peak_device_bytes\": " << memory.peak_device_bytes << "}\n"
+         << "}\n";
+
+    if (output.empty()) {
+        std::cout.rdbuf(stdout_buffer);
+        std::cout << json.str();
+    } else {
+        std::ofstream file(output, std::ios::trunc);
+        file << json.str();
+        if (!file.good()) {
+            std::cerr << "Cannot write " << output << '\n';
+            return -1;
+        }
+    }
+
+    return 0;
+}
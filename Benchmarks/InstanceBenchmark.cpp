@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../AssetPaths/AssetPaths.h"
+#include "../Presenter/Presenter.h"
+
+// Draws the same grid of meshes once with a draw call per object (CPU-recorded, no
+// culling) and once as a single instanced draw, at 1k, 10k and 100k copies. Reports the
+// median CPU recording time, GPU main pass time and whole DrawFrame time. Runs headless.
+// Usage: MVKInstanceBench [--assets dir] [--output dir] [frames per run]
+
+static std::vector<glm::mat4> MakeGrid(uint32_t count) {
+    uint32_t side = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(count))));
+    float spacing = 4.0f / std::max<uint32_t>(side, 1);
+
+    std::vector<glm::mat4> transforms(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        glm::vec3 cell(i % side, (i / side) % side, i / (side * side));
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), (cell - glm::vec3(side / 2.0f)) * spacing);
+        transforms[i] = glm::scale(transform, glm::vec3(spacing * 0.4f));
+    }
+    return transforms;
+}
+
+static double Median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+struct RunResult {
+    double record_ms = 0.0;
+    double gpu_ms = 0.0;
+    double frame_ms = 0.0;
+};
+
+// Profiler frames are numbered from 1; the first quarter of each run is warm-up.
+static RunResult Run(mvk::VKPresenter& screen, uint64_t& frame, uint32_t frames) {
+    uint64_t first = frame + frames / 4 + 1;
+    for (uint32_t i = 0; i < frames; ++i, ++frame)
+        screen.DrawFrame();
+    screen.get_logical_device().waitIdle();
+
+    std::vector<double> record_ms, gpu_ms, frame_ms;
+    for (const auto &event : screen.profiler().events()) {
+        if (event.frame < first || event.frame > frame) continue;
+        if (event.gpu && event.name == "main pass")
+            gpu_ms.push_back(event.duration_us / 1000.0);
+        else if (!event.gpu && event.name == "record")
+            record_ms.push_back(event.duration_us / 1000.0);
+        else if (!event.gpu && event.name == "DrawFrame")
+            frame_ms.push_back(event.duration_us / 1000.0);
+    }
+    return {Median(record_ms), Median(gpu_ms), Median(frame_ms)};
+}
+
+int main(int argc, char** argv) {
+    mvk::AssetPaths::TakeArguments(argc, argv);
+    uint32_t frames = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 100;
+    const uint32_t counts[] = {1000, 10000, 100000};
+
+    mvk::VKPresenter screen;
+    try {
+        // Timings are read back from the profiler.
+        screen.set_profiling({true});
+        screen.Setup(nullptr);
+        screen.set_animation_time(0.0f);
+        screen.set_gpu_culling(false);
+
+        uint64_t frame = 0;
+        std::cout << frames << " frames per run\n"
+                  << "  objects  mode         record ms    gpu ms  frame ms\n" << std::fixed << std::setprecision(3);
+
+        for (uint32_t count : counts) {
+            std::vector<glm::mat4> transforms = MakeGrid(count);
+
+            std::vector<mvk::DrawCommand> draws(count);
+            std::vector<mvk::InstanceData> instances(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                draws[i].object = {transforms[i], screen.mesh_bounds()};
+                draws[i].index_count = screen.index_count();
+                instances[i] = {transforms[i]};
+            }
+
+            screen.set_instances({});
+            screen.set_draws(std::move(draws));
+            RunResult per_object = Run(screen, frame, frames);
+
+            screen.set_instances(std::move(instances));
+            RunResult instanced = Run(screen, frame, frames);
+
+            for (auto &[mode, result] : {std::make_pair("per-object", per_object), std::make_pair("instanced", instanced)}) {
+                std::cout << std::setw(9) << count << "  " << std::left << std::setw(11) << mode << std::right
+                          << std::setw(11) << result.record_ms << std::setw(10) << result.gpu_ms << std::setw(10) << result.frame_ms << '\n';
+            }
+        }
+
+        screen.DestroyEverything();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return -1;
+    }
+
+    return 0;
+}
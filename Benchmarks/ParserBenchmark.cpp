@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../ObjectLoader/ObjectLoader.h"
+#include "../ThreadPool/ThreadPool.h"
+
+// The istringstream loader ObjectLoader used before MeshParser, kept as the baseline.
+static std::vector<mvk::Vertex> LoadLegacy(const std::string& path) {
+    std::vector<mvk::Vertex> object;
+    std::ifstream f(path);
+
+    std::string line;
+    while (std::getline(f, line)) {
+        if (line == "") continue;
+        std::istringstream ss(line);
+
+        std::vector<double> nums;
+
+        double num;
+        while(ss >> num)
+            nums.push_back(num);
+
+        object.push_back({{(float)nums[0], (float)nums[1], (float)nums[2]},
+                          {(float)nums[3], (float)nums[4], (float)nums[5]},
+                          {(float)nums[6], (float)nums[7]}});
+    }
+
+    return object;
+}
+
+static void GenerateMesh(const std::string& path, size_t vertex_count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::ofstream f(path);
+    f << std::fixed << std::setprecision(6);
+    for (size_t i = 0; i < vertex_count; ++i) {
+        f << position(rng) << ' ' << position(rng) << ' ' << position(rng) << ' '
+          << unit(rng) << ' ' << unit(rng) << ' ' << unit(rng) << ' '
+          << unit(rng) << ' ' << unit(rng) << '\n';
+        if (i % 3 == 2) f << '\n';
+    }
+}
+
+template <typename F>
+static double MeasureSeconds(int repeats, F&& body) {
+    double best = 1e30;
+    for (int i = 0; i < repeats; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    size_t vertex_count = argc > 1 ? std::stoull(argv[1]) : 2000000;
+    int repeats = argc > 2 ? std::stoi(argv[2]) : 3;
+
+    std::string path = (std::filesystem::temp_directory_path() / "mvk_parser_bench.txt").string();
+    GenerateMesh(path, vertex_count);
+    double megabytes = std::filesystem::file_size(path) / (1024.0 * 1024.0);
+
+    size_t legacy_count = 0, parsed_count = 0;
+    double legacy = MeasureSeconds(repeats, [&]() { legacy_count = LoadLegacy(path).size(); });
+    double parsed = MeasureSeconds(repeats, [&]() {
+        mvk::ObjectLoader loader;
+        loader.LoadObject(path);
+        parsed_count = loader.object.size();
+    });
+
+    std::remove(path.c_str());
+
+    if (legacy_count != parsed_count) {
+        std::cerr << "Vertex count mismatch: " << legacy_count << " vs " << parsed_count << '\n';
+        return -1;
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "file:          " << megabytes << " MB, " << parsed_count << " vertices\n"
+              << "istringstream: " << megabytes / legacy << " MB/s (" << legacy * 1000.0 << " ms)\n"
+              << "MeshParser:    " << megabytes / parsed << " MB/s (" << parsed * 1000.0 << " ms), "
+              << mvk::ThreadPool::Shared().thread_count() << " threads\n"
+              << "speedup:       " << legacy / parsed << "x\n";
+
+    return 0;
+}
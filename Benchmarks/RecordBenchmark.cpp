@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../AssetPaths/AssetPaths.h"
+#include "../Presenter/Presenter.h"
+
+// CPU time of command recording (the profiler's "record" scope) for a large draw list,
+// by number of recording threads. Runs headless. Each object draws only a small slice of
+// the mesh so that GPU time does not throttle the loop on software ICDs.
+// Usage: MVKRecordBench [--assets dir] [--output dir] [draw count] [frames per thread count]
+
+static std::vector<mvk::DrawCommand> MakeGrid(uint32_t count, uint32_t index_count, glm::vec4 bounds) {
+    uint32_t side = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(count))));
+    float spacing = 4.0f / std::max<uint32_t>(side, 1);
+
+    std::vector<mvk::DrawCommand> draws(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        glm::vec3 cell(i % side, (i / side) % side, i / (side * side));
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), (cell - glm::vec3(side / 2.0f)) * spacing);
+        draws[i].object.Transform = glm::scale(transform, glm::vec3(spacing * 0.4f));
+        draws[i].object.Bounds = bounds;
+        draws[i].index_count = std::min<uint32_t>(index_count, 3 * 128);
+    }
+    return draws;
+}
+
+int main(int argc, char** argv) {
+    mvk::AssetPaths::TakeArguments(argc, argv);
+    uint32_t draw_count = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 10000;
+    uint32_t frames = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 200;
+
+    mvk::VKPresenter screen;
+    try {
+        // Timings are read back from the profiler.
+        screen.set_profiling({true});
+        screen.Setup(nullptr);
+        screen.set_draws(MakeGrid(draw_count, screen.index_count(), screen.mesh_bounds()));
+        // Measures CPU recording, so keep the GPU-driven path out of the way.
+        screen.set_gpu_culling(false);
+        screen.set_animation_time(0.0f);
+
+        // DrawFrame numbers profiler frames from 1.
+        uint64_t frame = 0;
+        double single_thread_ms = 0.0;
+        uint32_t max_threads = static_cast<uint32_t>(mvk::ThreadPool::Shared().thread_count());
+
+        std::cout << draw_count << " draws, " << frames << " frames per run\n"
+                  << "threads   record ms   speedup\n" << std::fixed << std::setprecision(3);
+
+        for (uint32_t threads = 1; threads <= max_threads; threads = threads == max_threads ? threads + 1 : std::min(threads * 2, max_threads)) {
+            screen.set_recording_threads(threads);
+
+            uint64_t first = frame + frames / 4 + 1;
+            for (uint32_t i = 0; i < frames; ++i, ++frame)
+                screen.DrawFrame();
+            screen.get_logical_device().waitIdle();
+
+            std::vector<double> record_ms;
+            for (const auto &event : screen.profiler().events()) {
+                if (!event.gpu && event.name == "record" && event.frame >= first && event.frame <= frame)
+                    record_ms.push_back(event.duration_us / 1000.0);
+            }
+            std::sort(record_ms.begin(), record_ms.end());
+            double median = record_ms.empty() ? 0.0 : record_ms[record_ms.size() / 2];
+            if (threads == 1) single_thread_ms = median;
+
+            std::cout << std::setw(7) << threads << std::setw(12) << median
+                      << std::setw(9) << (median > 0.0 ? single_thread_ms / median : 0.0) << "x\n";
+        }
+
+        screen.DestroyEverything();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return -1;
+    }
+
+    return 0;
+}
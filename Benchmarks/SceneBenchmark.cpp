@@ -0,0 +1,137 @@
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Scene/Scene.h"
+
+// Hierarchical transform update of a large scene (default 1M nodes, a tree with fanout 8)
+// per frame: the SoA/SIMD Scene against a straightforward glm pass over an array of
+// structs. Each frame ends with the world matrices stored into an ObjectData-strided
+// buffer, like the mapped object buffer of GpuCulling. Runs on the CPU only.
+// Usage: MVKSceneBench [node count] [frames]
+
+// sizeof(ObjectData): mat4 transform, vec4 bounding sphere and a padded material index.
+static constexpr size_t OBJECT_STRIDE = 96;
+static constexpr uint32_t FANOUT = 8;
+
+struct NaiveNode {
+    glm::vec3 translation;
+    glm::quat rotation;
+    glm::vec3 scale;
+    uint32_t parent;
+};
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double Median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+static glm::quat Spin(uint32_t node, uint32_t frame) {
+    return glm::angleAxis(0.01f * frame + 0.001f * node, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+}
+
+static void NaiveUpdate(const std::vector<NaiveNode>& nodes, std::vector<glm::mat4>& worlds) {
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const NaiveNode& node = nodes[i];
+        glm::mat4 local = glm::translate(glm::mat4(1.0f), node.translation) * glm::mat4_cast(node.rotation) * glm::scale(glm::mat4(1.0f), node.scale);
+        worlds[i] = node.parent == mvk::SCENE_NO_PARENT ? local : worlds[node.parent] * local;
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t count = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 1000000;
+    uint32_t frames = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 30;
+
+    mvk::Scene scene;
+    scene.Reserve(count);
+    std::vector<NaiveNode> naive(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t parent = i == 0 ? mvk::SCENE_NO_PARENT : (i - 1) / FANOUT;
+        glm::vec3 translation(0.5f * (i % 7), 0.25f * (i % 5), 0.125f * (i % 3));
+        glm::vec3 scale(0.99f);
+
+        scene.AddNode(parent);
+        scene.SetTranslation(i, translation);
+        scene.SetRotation(i, Spin(i, 0));
+        scene.SetScale(i, scale);
+        naive[i] = {translation, Spin(i, 0), scale, parent};
+    }
+
+    // Separate destinations, so the baseline's full copy does not undo the scene's
+    // dirty tracking.
+    uint8_t* gpu = static_cast<uint8_t*>(::operator new(count * OBJECT_STRIDE, std::align_val_t(64)));
+    uint8_t* naive_gpu = static_cast<uint8_t*>(::operator new(count * OBJECT_STRIDE, std::align_val_t(64)));
+    std::vector<glm::mat4> naive_worlds(count);
+    uint64_t written = 0;
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<uint32_t> pick(0, count - 1);
+
+    std::cout << count << " nodes, " << frames << " frames per run\n"
+              << "case            update ms  write ms  changed    glm ms  speedup\n" << std::fixed << std::setprecision(3);
+
+    // Every node animated, then 1% of the nodes animated, dirty subtrees included.
+    for (uint32_t percent : {100u, 1u}) {
+        std::vector<double> update_ms, write_ms, naive_ms;
+        size_t changed = 0;
+
+        for (uint32_t frame = 1; frame <= frames; ++frame) {
+            uint32_t animated = static_cast<uint32_t>(static_cast<uint64_t>(count) * percent / 100);
+            for (uint32_t i = 0; i < animated; ++i) {
+                uint32_t node = percent == 100 ? i : pick(random);
+                scene.SetRotation(node, Spin(node, frame));
+                naive[node].rotation = Spin(node, frame);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            changed = scene.Update();
+            update_ms.push_back(MillisecondsSince(start));
+
+            start = std::chrono::steady_clock::now();
+            written = scene.Write(gpu, OBJECT_STRIDE, written);
+            write_ms.push_back(MillisecondsSince(start));
+
+            // The baseline has no dirty tracking: everything is recomputed and copied.
+            start = std::chrono::steady_clock::now();
+            NaiveUpdate(naive, naive_worlds);
+            for (uint32_t i = 0; i < count; ++i)
+                std::memcpy(naive_gpu + i * OBJECT_STRIDE, &naive_worlds[i], sizeof(glm::mat4));
+            naive_ms.push_back(MillisecondsSince(start));
+        }
+
+        double simd = Median(update_ms) + Median(write_ms);
+        std::cout << std::left << std::setw(14) << (percent == 100 ? "all animated" : "1% animated") << std::right
+                  << std::setw(11) << Median(update_ms) << std::setw(10) << Median(write_ms) << std::setw(9) << changed
+                  << std::setw(10) << Median(naive_ms) << std::setw(8) << (simd > 0.0 ? Median(naive_ms) / simd : 0.0) << "x\n";
+    }
+
+    float max_error = 0.0f;
+    for (uint32_t i = 0; i < count; ++i) {
+        for (int column = 0; column < 4; ++column) {
+            glm::vec4 difference = glm::abs(scene.world(i)[column] - naive_worlds[i][column]);
+            max_error = std::max(max_error, std::max(std::max(difference.x, difference.y), std::max(difference.z, difference.w)));
+        }
+    }
+    std::cout << "max difference from glm: " << std::scientific << max_error << '\n';
+
+    ::operator delete(gpu, std::align_val_t(64));
+    ::operator delete(naive_gpu, std::align_val_t(64));
+    return 0;
+}
@@ -0,0 +1,251 @@
+#include "BindlessTable.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+static vk::DeviceSize AlignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+namespace mvk {
+    void BindlessTable::Init(vk::PhysicalDevice physical_device, vk::Device device, DeviceMemoryAllocator& allocator,
+                             uint32_t max_textures, uint32_t max_materials, uint32_t frame_count) {
+        device_ = device;
+        allocator_ = &allocator;
+        frame_count_ = frame_count;
+        texture_count_ = 0;
+        material_count_ = 0;
+        free_textures_.clear();
+        material_updates_.clear();
+
+        auto properties = physical_device.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+        const vk::PhysicalDeviceVulkan12Properties &limits = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+        max_textures_ = std::min({max_textures, limits.maxDescriptorSetUpdateAfterBindSampledImages,
+                                  limits.maxPerStageDescriptorUpdateAfterBindSampledImages});
+        max_materials_ = max_materials;
+
+        std::array<vk::DescriptorSetLayoutBinding, 3> bindings{};
+        bindings[0].setBinding(0);
+        bindings[0].setDescriptorType(vk::DescriptorType::eSampler);
+        bindings[0].setDescriptorCount(1);
+        bindings[0].setStageFlags(vk::ShaderStageFlagBits::eFragment);
+
+        bindings[1].setBinding(1);
+        bindings[1].setDescriptorType(vk::DescriptorType::eSampledImage);
+        bindings[1].setDescriptorCount(max_textures_);
+        bindings[1].setStageFlags(vk::ShaderStageFlagBits::eFragment);
+
+        bindings[2].setBinding(2);
+        bindings[2].setDescriptorType(vk::DescriptorType::eStorageBuffer);
+        bindings[2].setDescriptorCount(1);
+        bindings[2].setStageFlags(vk::ShaderStageFlagBits::eFragment);
+
+        std::array<vk::DescriptorBindingFlags, 3> binding_flags = {
+            vk::DescriptorBindingFlagBits::eUpdateAfterBind,
+            vk::DescriptorBindingFlagBits::ePartiallyBound | vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+            vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending,
+            vk::DescriptorBindingFlags{}
+        };
+
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo flags_info{};
+        flags_info.sType = vk::StructureType::eDescriptorSetLayoutBindingFlagsCreateInfo;
+        flags_info.setBindingCount(binding_flags.size());
+        flags_info.setPBindingFlags(binding_flags.data());
+
+        vk::DescriptorSetLayoutCreateInfo layout_info{};
+        layout_info.sType = vk::StructureType::eDescriptorSetLayoutCreateInfo;
+        layout_info.setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool);
+        layout_info.setBindingCount(bindings.size());
+        layout_info.setPBindings(bindings.data());
+        layout_info.setPNext(&flags_info);
+
+        layout_ = device_.createDescriptorSetLayout(layout_info);
+
+        std::array<vk::DescriptorPoolSize, 3> pool_sizes = {
+            vk::DescriptorPoolSize(vk::DescriptorType::eSampler, frame_count_),
+            vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, max_textures_ * frame_count_),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, frame_count_)
+        };
+
+        vk::DescriptorPoolCreateInfo pool_info{};
+        pool_info.sType = vk::StructureType::eDescriptorPoolCreateInfo;
+        pool_info.setFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind);
+        pool_info.setPoolSizeCount(pool_sizes.size());
+        pool_info.setPPoolSizes(pool_sizes.data());
+        pool_info.setMaxSets(frame_count_);
+
+        pool_ = device_.createDescriptorPool(pool_info);
+
+        std::vector<vk::DescriptorSetLayout> layouts(frame_count_, layout_);
+        vk::DescriptorSetAllocateInfo set_info{};
+        set_info.sType = vk::StructureType::eDescriptorSetAllocateInfo;
+        set_info.setDescriptorPool(pool_);
+        set_info.setDescriptorSetCount(frame_count_);
+        set_info.setPSetLayouts(layouts.data());
+
+        sets_ = device_.allocateDescriptorSets(set_info);
+
+        // One copy of the material records per frame, each at an offset the device can bind.
+        vk::DeviceSize alignment = physical_device.getProperties().limits.minStorageBufferOffsetAlignment;
+        materials_stride_ = AlignUp(sizeof(MaterialData) * max_materials_, alignment);
+
+        vk::BufferCreateInfo buffer_info{};
+        buffer_info.sType = vk::StructureType::eBufferCreateInfo;
+        buffer_info.setSize(materials_stride_ * frame_count_);
+        buffer_info.setUsage(vk::BufferUsageFlagBits::eStorageBuffer);
+        buffer_info.setSharingMode(vk::SharingMode::eExclusive);
+
+        materials_ = device_.createBuffer(buffer_info);
+        materials_allocation_ = allocator_->Allocate(device_.getBufferMemoryRequirements(materials_),
+                                                     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                                                     ResourceKind::eLinear);
+        device_.bindBufferMemory(materials_, materials_allocation_.memory, materials_allocation_.offset);
+
+        for (uint32_t frame = 0; frame < frame_count_; ++frame) {
+            vk::DescriptorBufferInfo materials_info{};
+            materials_info.setBuffer(materials_);
+            materials_info.setOffset(materials_stride_ * frame);
+            materials_info.setRange(sizeof(MaterialData) * max_materials_);
+
+            vk::WriteDescriptorSet write_materials{};
+            write_materials.sType = vk::StructureType::eWriteDescriptorSet;
+            write_materials.setDstSet(sets_[frame]);
+            write_materials.setDstBinding(2);
+            write_materials.setDescriptorType(vk::DescriptorType::eStorageBuffer);
+            write_materials.setDescriptorCount(1);
+            write_materials.setPBufferInfo(&materials_info);
+
+            device_.updateDescriptorSets(1, &write_materials, 0, nullptr);
+        }
+    }
+
+    void BindlessTable::Destroy() {
+        device_.destroyDescriptorPool(pool_);
+        device_.destroyDescriptorSetLayout(layout_);
+        device_.destroyBuffer(materials_);
+        allocator_->Free(materials_allocation_);
+    }
+
+    void BindlessTable::BeginFrame(uint32_t frame) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        MaterialData* materials = frame_materials(frame);
+        for (auto &update : material_updates_) {
+            if (!(update.stale_frames & (1u << frame))) continue;
+            std::memcpy(materials + update.index, &update.material, sizeof(MaterialData));
+            update.stale_frames &= ~(1u << frame);
+        }
+
+        material_updates_.erase(std::remove_if(material_updates_.begin(), material_updates_.end(),
+                                               [](const MaterialUpdate& update) { return update.stale_frames == 0; }),
+                                material_updates_.end());
+    }
+
+    void BindlessTable::SetSampler(vk::Sampler sampler) {
+        vk::DescriptorImageInfo sampler_info{};
+        sampler_info.setSampler(sampler);
+
+        std::vector<vk::WriteDescriptorSet> writes(frame_count_);
+        for (uint32_t frame = 0; frame < frame_count_; ++frame) {
+            writes[frame].sType = vk::StructureType::eWriteDescriptorSet;
+            writes[frame].setDstSet(sets_[frame]);
+            writes[frame].setDstBinding(0);
+            writes[frame].setDescriptorType(vk::DescriptorType::eSampler);
+            writes[frame].setDescriptorCount(1);
+            writes[frame].setPImageInfo(&sampler_info);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        device_.updateDescriptorSets(static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+
+    uint32_t BindlessTable::RegisterTexture(vk::ImageView view, vk::ImageLayout layout) {
+        uint32_t index;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_textures_.empty()) {
+                index = free_textures_.back();
+                free_textures_.pop_back();
+            } else if (texture_count_ == max_textures_) {
+                throw std::runtime_error("Bindless texture table is full.");
+            } else {
+                index = texture_count_++;
+            }
+        }
+
+        UpdateTexture(index, view, layout);
+        return index;
+    }
+
+    void BindlessTable::UpdateTexture(uint32_t index, vk::ImageView view, vk::ImageLayout layout) {
+        vk::DescriptorImageInfo image_info{};
+        image_info.setImageView(view);
+        image_info.setImageLayout(layout);
+
+        std::vector<vk::WriteDescriptorSet> writes(frame_count_);
+        for (uint32_t frame = 0; frame < frame_count_; ++frame) {
+            writes[frame].sType = vk::StructureType::eWriteDescriptorSet;
+            writes[frame].setDstSet(sets_[frame]);
+            writes[frame].setDstBinding(1);
+            writes[frame].setDstArrayElement(index);
+            writes[frame].setDescriptorType(vk::DescriptorType::eSampledImage);
+            writes[frame].setDescriptorCount(1);
+            writes[frame].setPImageInfo(&image_info);
+        }
+
+        // Writes to one set must be externally synchronized.
+        std::lock_guard<std::mutex> lock(mutex_);
+        device_.updateDescriptorSets(static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+
+    void BindlessTable::ReleaseTexture(uint32_t index) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_textures_.push_back(index);
+    }
+
+    uint32_t BindlessTable::RegisterMaterial(const MaterialData& material) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (material_count_ == max_materials_)
+            throw std::runtime_error("Bindless material table is full.");
+
+        // No frame reads a new index yet, so every copy can be written right away.
+        uint32_t index = material_count_++;
+        for (uint32_t frame = 0; frame < frame_count_; ++frame)
+            std::memcpy(frame_materials(frame) + index, &material, sizeof(material));
+        return index;
+    }
+
+    void BindlessTable::UpdateMaterial(uint32_t index, const MaterialData& material) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index >= material_count_)
+            throw std::runtime_error("Unknown bindless material.");
+
+        // A newer update of the same record replaces the older one in every copy.
+        material_updates_.erase(std::remove_if(material_updates_.begin(), material_updates_.end(),
+                                               [index](const MaterialUpdate& update) { return update.index == index; }),
+                                material_updates_.end());
+        material_updates_.push_back({index, material, (1u << frame_count_) - 1});
+    }
+
+    vk::DescriptorSetLayout BindlessTable::layout() const {
+        return layout_;
+    }
+
+    vk::DescriptorSet BindlessTable::descriptor_set(uint32_t frame) const {
+        return sets_[frame];
+    }
+
+    uint32_t BindlessTable::texture_count() const {
+        return texture_count_ - static_cast<uint32_t>(free_textures_.size());
+    }
+
+    MaterialData* BindlessTable::frame_materials(uint32_t frame) const {
+        return reinterpret_cast<MaterialData*>(static_cast<uint8_t*>(materials_allocation_.mapped) + materials_stride_ * frame);
+    }
+
+    uint32_t BindlessTable::material_count() const {
+        return material_count_;
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef MVK_BINDLESS_TABLE
+#define MVK_BINDLESS_TABLE
+
+#include <vulkan/vulkan.hpp>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "../MemoryAllocator/DeviceMemoryAllocator.h"
+
+namespace mvk {
+    // std430 record of the material storage buffer (set 1, binding 2).
+    struct MaterialData {
+        uint32_t BaseColorTexture = 0;
+        uint32_t padding[3] = {};
+        glm::vec4 BaseColorFactor = glm::vec4(1.0f);
+    };
+
+    // Descriptor set 1 of the graphics pipelines, shared by every draw:
+    //   binding 0: the sampler all textures are read with,
+    //   binding 1: a partially bound, update-after-bind array of sampled images,
+    //   binding 2: the material records.
+    // Textures and materials are registered once and referenced by index from shaders,
+    // so adding one never allocates or rebinds a set. Texture slots can be written while
+    // command buffers that use the set are pending, as long as they do not read that slot.
+    //
+    // Each frame slot has its own set and its own copy of the material records, so a
+    // material can be changed without touching what pending frames read: UpdateMaterial
+    // reaches a frame's copy when BeginFrame is called for that slot.
+    class BindlessTable {
+       public:
+        // max_textures is clamped to the device's update-after-bind limits.
+        void Init(vk::PhysicalDevice physical_device, vk::Device device, DeviceMemoryAllocator& allocator,
+                  uint32_t max_textures, uint32_t max_materials, uint32_t frame_count);
+        void Destroy();
+
+        // Applies material updates to frame's copy. Call once the frame's fence has signaled.
+        void BeginFrame(uint32_t frame);
+
+        // Affects every frame at once; no frame using the set may be pending.
+        void SetSampler(vk::Sampler sampler);
+        // Returns the texture's index in the image array, reusing released indices first.
+        // Throws once the table is full.
+        uint32_t RegisterTexture(vk::ImageView view, vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+        // Points an existing index at a different view. Pending frames must not read it.
+        void UpdateTexture(uint32_t index, vk::ImageView view, vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+        // Makes index available to RegisterTexture again. Pending frames must not read it.
+        void ReleaseTexture(uint32_t index);
+        // Returns the material's index in the material buffer.
+        uint32_t RegisterMaterial(const MaterialData& material);
+        // Frames pick the change up from their next BeginFrame on.
+        void UpdateMaterial(uint32_t index, const MaterialData& material);
+
+        vk::DescriptorSetLayout layout() const;
+        vk::DescriptorSet descriptor_set(uint32_t frame) const;
+        uint32_t texture_count() const;
+        uint32_t material_count() const;
+
+       private:
+        struct MaterialUpdate {
+            uint32_t index = 0;
+            MaterialData material;
+            // Bit i is set while frame i's copy still holds the old record.
+            uint32_t stale_frames = 0;
+        };
+
+        MaterialData* frame_materials(uint32_t frame) const;
+
+        vk::Device device_;
+        DeviceMemoryAllocator* allocator_ = nullptr;
+        uint32_t max_textures_ = 0;
+        uint32_t max_materials_ = 0;
+        uint32_t frame_count_ = 0;
+
+        vk::DescriptorSetLayout layout_;
+        vk::DescriptorPool pool_;
+        std::vector<vk::DescriptorSet> sets_;
+
+        vk::Buffer materials_;
+        Allocation materials_allocation_;
+        vk::DeviceSize materials_stride_ = 0;
+
+        uint32_t texture_count_ = 0;
+        std::vector<uint32_t> free_textures_;
+        uint32_t material_count_ = 0;
+        std::vector<MaterialUpdate> material_updates_;
+        std::mutex mutex_;
+    };
+}
+
+#endif  // MVK_BINDLESS_TABLE
@@ -0,0 +1,104 @@
+#include "CommandRecorder.h"
+
+#include <algorithm>
+
+namespace mvk {
+    void CommandRecorder::Init(vk::Device device, const DispatchTable& dispatch, uint32_t queue_family, uint32_t frames_in_flight,
+                               ThreadPool& pool) {
+        device_ = device;
+        dispatch_ = &dispatch;
+        pool_ = &pool;
+        worker_count_ = static_cast<uint32_t>(std::max<size_t>(pool.thread_count(), 1));
+
+        vk::CommandPoolCreateInfo pool_info{};
+        pool_info.sType = vk::StructureType::eCommandPoolCreateInfo;
+        pool_info.setFlags(vk::CommandPoolCreateFlagBits::eTransient);
+        pool_info.setQueueFamilyIndex(queue_family);
+
+        frames_.resize(frames_in_flight);
+        for (auto &frame : frames_) {
+            frame.primary_pool = device_.createCommandPool(pool_info);
+
+            vk::CommandBufferAllocateInfo primary_info{};
+            primary_info.sType = vk::StructureType::eCommandBufferAllocateInfo;
+            primary_info.setCommandPool(frame.primary_pool);
+            primary_info.setLevel(vk::CommandBufferLevel::ePrimary);
+            primary_info.setCommandBufferCount(1);
+            frame.primary = device_.allocateCommandBuffers(primary_info)[0];
+
+            frame.worker_pools.resize(worker_count_);
+            frame.secondaries.resize(worker_count_);
+            for (uint32_t i = 0; i < worker_count_; ++i) {
+                frame.worker_pools[i] = device_.createCommandPool(pool_info);
+
+                vk::CommandBufferAllocateInfo secondary_info{};
+                secondary_info.sType = vk::StructureType::eCommandBufferAllocateInfo;
+                secondary_info.setCommandPool(frame.worker_pools[i]);
+                secondary_info.setLevel(vk::CommandBufferLevel::eSecondary);
+                secondary_info.setCommandBufferCount(1);
+                frame.secondaries[i] = device_.allocateCommandBuffers(secondary_info)[0];
+            }
+        }
+    }
+
+    void CommandRecorder::Destroy() {
+        for (auto &frame : frames_) {
+            device_.destroyCommandPool(frame.primary_pool);
+            for (auto worker_pool : frame.worker_pools)
+                device_.destroyCommandPool(worker_pool);
+        }
+        frames_.clear();
+    }
+
+    vk::CommandBuffer CommandRecorder::BeginFrame(uint32_t frame_slot) {
+        slot_ = frame_slot;
+        FrameCommands &frame = frames_[slot_];
+
+        device_.resetCommandPool(frame.primary_pool, {}, dispatch_->get());
+        for (auto worker_pool : frame.worker_pools)
+            device_.resetCommandPool(worker_pool, {}, dispatch_->get());
+
+        return frame.primary;
+    }
+
+    std::vector<vk::CommandBuffer> CommandRecorder::Record(const vk::CommandBufferInheritanceInfo& inheritance, size_t draw_count,
+                                                           const RecordRange& record_range) {
+        FrameCommands &frame = frames_[slot_];
+
+        uint32_t max_ranges = worker_limit_ == 0 ? worker_count_ : std::min(worker_limit_, worker_count_);
+        size_t wanted = (draw_count + MIN_DRAWS_PER_WORKER - 1) / MIN_DRAWS_PER_WORKER;
+        uint32_t range_count = static_cast<uint32_t>(std::clamp<size_t>(wanted, 1, max_ranges));
+        size_t per_range = (draw_count + range_count - 1) / range_count;
+
+        auto RecordOne = [&](size_t i) {
+            vk::CommandBuffer command_buffer = frame.secondaries[i];
+            const vk::DispatchLoaderDynamic& dispatch = dispatch_->get();
+
+            vk::CommandBufferBeginInfo begin_info{};
+            begin_info.sType = vk::StructureType::eCommandBufferBeginInfo;
+            begin_info.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+            begin_info.setPInheritanceInfo(&inheritance);
+
+            command_buffer.begin(begin_info, dispatch);
+            size_t begin = std::min(i * per_range, draw_count);
+            record_range(command_buffer, begin, std::min(begin + per_range, draw_count));
+            command_buffer.end(dispatch);
+        };
+
+        // Index i only ever uses worker pool i, so ranges never share a pool.
+        if (range_count == 1)
+            RecordOne(0);
+        else
+            pool_->ParallelFor(range_count, RecordOne);
+
+        return std::vector<vk::CommandBuffer>(frame.secondaries.begin(), frame.secondaries.begin() + range_count);
+    }
+
+    void CommandRecorder::set_worker_limit(uint32_t limit) {
+        worker_limit_ = limit;
+    }
+
+    uint32_t CommandRecorder::worker_count() const {
+        return worker_count_;
+    }
+}
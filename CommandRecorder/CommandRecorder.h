@@ -0,0 +1,62 @@
+#ifndef MVK_COMMAND_RECORDER
+#define MVK_COMMAND_RECORDER
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "../DispatchTable/DispatchTable.h"
+#include "../ThreadPool/ThreadPool.h"
+
+namespace mvk {
+    // Splits a frame's draws into contiguous ranges recorded in parallel into secondary
+    // command buffers. Every frame slot owns one pool for the primary buffer and one per
+    // worker, so no pool is touched by two threads at once. BeginFrame resets the slot's
+    // pools wholesale, which is cheaper than resetting buffers one by one.
+    class CommandRecorder {
+       public:
+        // Records draws [begin, end) into a secondary buffer that is already begun and
+        // continues the render pass. No state is inherited, so each range binds its own.
+        using RecordRange = std::function<void(vk::CommandBuffer command_buffer, size_t begin, size_t end)>;
+
+        // Fewer draws than this per range cost more in thread handoff than they save.
+        static constexpr size_t MIN_DRAWS_PER_WORKER = 64;
+
+        void Init(vk::Device device, const DispatchTable& dispatch, uint32_t queue_family, uint32_t frames_in_flight,
+                  ThreadPool& pool = ThreadPool::Shared());
+        void Destroy();
+
+        // Resets every pool of the slot and returns its primary buffer, not yet begun.
+        // The slot's previous submission must have completed.
+        vk::CommandBuffer BeginFrame(uint32_t frame_slot);
+
+        // Returns the secondary buffers in draw order, ready for executeCommands.
+        std::vector<vk::CommandBuffer> Record(const vk::CommandBufferInheritanceInfo& inheritance, size_t draw_count,
+                                              const RecordRange& record_range);
+
+        // Caps the number of parallel ranges, e.g. to measure scaling. 0 means one per worker.
+        void set_worker_limit(uint32_t limit);
+        uint32_t worker_count() const;
+
+       private:
+        struct FrameCommands {
+            vk::CommandPool primary_pool;
+            vk::CommandBuffer primary;
+            std::vector<vk::CommandPool> worker_pools;
+            std::vector<vk::CommandBuffer> secondaries;
+        };
+
+        vk::Device device_;
+        const DispatchTable* dispatch_ = nullptr;
+        ThreadPool* pool_ = nullptr;
+
+        std::vector<FrameCommands> frames_;
+        uint32_t slot_ = 0;
+        uint32_t worker_count_ = 1;
+        uint32_t worker_limit_ = 0;
+    };
+}
+
+#endif  // MVK_COMMAND_RECORDER
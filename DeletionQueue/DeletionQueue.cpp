@@ -0,0 +1,33 @@
+#include "DeletionQueue.h"
+
+#include <utility>
+
+namespace mvk {
+    void DeletionQueue::Init(uint32_t frames_in_flight) {
+        frames_in_flight_ = frames_in_flight;
+        frame_ = 0;
+        entries_.clear();
+    }
+
+    void DeletionQueue::Flush() {
+        for (auto &entry : entries_)
+            entry.destroy();
+        entries_.clear();
+    }
+
+    void DeletionQueue::Collect(uint64_t frame) {
+        frame_ = frame;
+        while (!entries_.empty() && entries_.front().frame <= frame) {
+            entries_.front().destroy();
+            entries_.pop_front();
+        }
+    }
+
+    void DeletionQueue::Retire(std::function<void()> destroy) {
+        entries_.push_back({frame_ + frames_in_flight_, std::move(destroy)});
+    }
+
+    size_t DeletionQueue::pending() const {
+        return entries_.size();
+    }
+}
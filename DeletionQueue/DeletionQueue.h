@@ -0,0 +1,38 @@
+#ifndef MVK_DELETION_QUEUE
+#define MVK_DELETION_QUEUE
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace mvk {
+    // Destroys objects once no frame in flight can still use them. Frames count up by
+    // one per DrawFrame. Whatever is retired while frame N is recorded was used by frame
+    // N at the latest, and frame N's fence has signalled by the time frame
+    // N + frames_in_flight begins, so that frame runs the destruction.
+    class DeletionQueue {
+       public:
+        void Init(uint32_t frames_in_flight);
+        // Runs every pending destruction. The device must be idle.
+        void Flush();
+
+        // Once per frame, after waiting on the frame slot's fence.
+        void Collect(uint64_t frame);
+        void Retire(std::function<void()> destroy);
+
+        size_t pending() const;
+
+       private:
+        struct Entry {
+            uint64_t frame = 0;
+            std::function<void()> destroy;
+        };
+
+        std::deque<Entry> entries_;
+        uint64_t frame_ = 0;
+        uint32_t frames_in_flight_ = 0;
+    };
+}
+
+#endif  // MVK_DELETION_QUEUE
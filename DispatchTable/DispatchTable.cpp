@@ -0,0 +1,15 @@
+#include "DispatchTable.h"
+
+namespace mvk {
+    void DispatchTable::InitInstance(vk::Instance instance) {
+        loader_.init(instance, vkGetInstanceProcAddr);
+    }
+
+    void DispatchTable::InitDevice(vk::Device device) {
+        loader_.init(device);
+    }
+
+    const vk::DispatchLoaderDynamic& DispatchTable::get() const {
+        return loader_;
+    }
+}
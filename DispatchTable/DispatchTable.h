@@ -0,0 +1,24 @@
+#ifndef MVK_DISPATCH_TABLE
+#define MVK_DISPATCH_TABLE
+
+#include <vulkan/vulkan.hpp>
+
+namespace mvk {
+    // Function pointers for extension entry points, resolved once instead of per call.
+    // After InitDevice, device-level functions come from vkGetDeviceProcAddr and call
+    // straight into the driver, bypassing the loader's dispatch trampolines.
+    class DispatchTable {
+       public:
+        // Instance-level functions, e.g. the debug messenger. Call right after vkCreateInstance.
+        void InitInstance(vk::Instance instance);
+        // Call right after vkCreateDevice; the instance must already be loaded.
+        void InitDevice(vk::Device device);
+
+        const vk::DispatchLoaderDynamic& get() const;
+
+       private:
+        vk::DispatchLoaderDynamic loader_;
+    };
+}
+
+#endif  // MVK_DISPATCH_TABLE
@@ -13,10 +13,25 @@ namespace mvk {
         CleanUp();      
     }
 
+    void DisplayWindow::RunHeadless(uint32_t frame_count) {
+        window_ = nullptr;
+        InitVulkan();
+        HeadlessLoop(frame_count);
+        CleanUp();
+    }
+
     void DisplayWindow::SetResizeTrigger() {
         return screen.set_window_resize();
     }
 
+    void DisplayWindow::SetFramePacing(const FramePacingSettings& settings) {
+        screen.set_frame_pacing(settings);
+    }
+
+    void DisplayWindow::SetProfiling(const ProfilerSettings& settings) {
+        screen.set_profiling(settings);
+    }
+
     void DisplayWindow::InitWindow() {
         if (glfwInit() == GLFW_FALSE)
             throw std::runtime_error("Cannot initialize GLFW.");
@@ -39,14 +54,47 @@ namespace mvk {
 
     void DisplayWindow::MainLoop() {
         while(!glfwWindowShouldClose(window_)) {
+            // Input is polled after the wait for a free frame slot, so it is as fresh as it can be.
+            screen.WaitForFrame();
             glfwPollEvents();
             screen.DrawFrame();
         }
         screen.get_logical_device().waitIdle();
+
+        FramePacingStatistics pacing = screen.frame_pacing_statistics();
+        std::cout << "\u001b[32mINFO: " << pacing.presented << " frames presented with " << vk::to_string(pacing.present_mode)
+                  << ", " << pacing.swapchain_images << " swapchain images, " << pacing.frames_in_flight << " frames in flight\u001b[0m\n";
+        if (pacing.latency_samples > 0)
+            std::cout << "\u001b[32mINFO: Input to present latency min/avg/max " << pacing.latency_min_ms << "/"
+                      << pacing.latency_avg_ms << "/" << pacing.latency_max_ms << " ms\u001b[0m\n";
+    }
+
+    void DisplayWindow::HeadlessLoop(uint32_t frame_count) {
+        double min_ms = 0.0, max_ms = 0.0, total_ms = 0.0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < frame_count; ++i) {
+            auto frame_start = std::chrono::steady_clock::now();
+            screen.DrawFrame();
+            double frame_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame_start).count();
+
+            min_ms = i == 0 ? frame_ms : std::min(min_ms, frame_ms);
+            max_ms = std::max(max_ms, frame_ms);
+            total_ms += frame_ms;
+        }
+        screen.get_logical_device().waitIdle();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (frame_count == 0) return;
+        std::cout << "\u001b[32mINFO: Headless: " << frame_count << " frames in " << elapsed << " s, "
+                  << frame_count / elapsed << " fps, DrawFrame min/avg/max "
+                  << min_ms << "/" << total_ms / frame_count << "/" << max_ms << " ms\u001b[0m\n";
     }
 
     void DisplayWindow::CleanUp() {
         screen.DestroyEverything();
+        if (window_ == nullptr) return;
+
         glfwDestroyWindow(window_);
         glfwTerminate();
     }
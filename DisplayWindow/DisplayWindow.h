@@ -5,6 +5,11 @@
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
 #include "../Presenter/Presenter.h"
 #include "../MVKConstants.h"
 
@@ -12,15 +17,22 @@ namespace mvk {
     class DisplayWindow {
        public:
         void Run();
+        // Renders frame_count frames without GLFW or a surface and prints timings.
+        void RunHeadless(uint32_t frame_count);
         void SetResizeTrigger();
+        // Applied by Setup; see VKPresenter::set_frame_pacing.
+        void SetFramePacing(const FramePacingSettings& settings);
+        // Applied by Setup; see VKPresenter::set_profiling.
+        void SetProfiling(const ProfilerSettings& settings);
 
        private:
         void InitWindow();
         void InitVulkan();
         void MainLoop();
+        void HeadlessLoop(uint32_t frame_count);
         void CleanUp();
 
-        GLFWwindow* window_;
+        GLFWwindow* window_ = nullptr;
         mvk::VKPresenter screen; 
     };
 }
@@ -0,0 +1,26 @@
+#include "Fnv1a.h"
+
+#include <cstring>
+
+namespace mvk {
+    // FNV-1a over 64-bit words: good enough to catch truncated or stale caches
+    // and several times faster than the byte-wise variant on large blobs.
+    uint64_t Fnv1a::Hash(const void* data, size_t size, uint64_t seed) {
+        constexpr uint64_t offset_basis = 0xCBF29CE484222325ull;
+        constexpr uint64_t prime = 0x100000001B3ull;
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = seed ^ offset_basis;
+
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            hash = (hash ^ word) * prime;
+        }
+        for (; i < size; ++i)
+            hash = (hash ^ bytes[i]) * prime;
+
+        return hash;
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef MVK_FNV1A
+#define MVK_FNV1A
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mvk {
+    // The one hash used for cache keys, checksums and hash maps. Not for anything that
+    // has to resist deliberate collisions.
+    class Fnv1a {
+       public:
+        // seed chains calls: passing the previous result hashes several buffers as one key.
+        static uint64_t Hash(const void* data, size_t size, uint64_t seed = 0);
+    };
+}
+
+#endif  // MVK_FNV1A
@@ -0,0 +1,179 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// vkWaitForPresentKHR timeout; bounds how long ReleaseSwapchain and Destroy wait for the
+// latency thread to let go of a swapchain whose presents never complete.
+static constexpr uint64_t PRESENT_WAIT_TIMEOUT_NS = 10'000'000;
+
+static double MillisecondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+namespace mvk {
+    void FramePacer::Init(vk::Device device, const DispatchTable& dispatch, const FramePacingSettings& settings, bool present_wait) {
+        if (settings.frames_in_flight == 0 || settings.frames_in_flight > MAX_FRAMES_IN_FLIGHT)
+            throw std::runtime_error("Frames in flight must be between 1 and " + std::to_string(MAX_FRAMES_IN_FLIGHT) + ".");
+
+        device_ = device;
+        dispatch_ = &dispatch;
+        present_wait_ = present_wait;
+        frames_in_flight_ = settings.frames_in_flight;
+        next_present_id_ = 1;
+        present_id_ = 0;
+        stop_ = false;
+        stats_ = FramePacingStatistics{};
+        stats_.frames_in_flight = frames_in_flight_;
+        latency_total_ms_ = 0.0;
+
+        set_frame_rate_limit(settings.max_fps);
+        next_frame_ = std::chrono::steady_clock::now();
+        input_ = next_frame_;
+
+        if (present_wait_)
+            waiter_ = std::thread(&FramePacer::WaitForPresents, this);
+    }
+
+    void FramePacer::Destroy() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+            pending_.clear();
+        }
+        wake_.notify_all();
+
+        if (waiter_.joinable())
+            waiter_.join();
+    }
+
+    // The latency thread picks the new swapchain up with the next present it is handed;
+    // a wait still running on the old one finishes on its own and is then discarded.
+    void FramePacer::SetSwapchain(vk::SwapchainKHR swapchain, vk::PresentModeKHR present_mode, uint32_t image_count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        swapchain_ = swapchain;
+        pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                      [swapchain](const PendingPresent& present) { return present.swapchain != swapchain; }),
+                       pending_.end());
+
+        stats_.present_mode = present_mode;
+        stats_.swapchain_images = image_count;
+    }
+
+    void FramePacer::ReleaseSwapchain(vk::SwapchainKHR swapchain) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this, swapchain]() { return waiting_on_ != swapchain; });
+    }
+
+    void FramePacer::set_frame_rate_limit(double max_fps) {
+        if (max_fps <= 0.0) {
+            frame_interval_ = std::chrono::steady_clock::duration::zero();
+            return;
+        }
+        frame_interval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / max_fps));
+    }
+
+    void FramePacer::Throttle() {
+        if (frame_interval_ == std::chrono::steady_clock::duration::zero())
+            return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (next_frame_ > now) {
+            std::this_thread::sleep_until(next_frame_);
+            auto woke = std::chrono::steady_clock::now();
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.throttled_ms += MillisecondsBetween(now, woke);
+            now = woke;
+        }
+
+        // Lateness within one interval keeps the cadence; a longer stall starts it over
+        // instead of rushing the following frames to catch up.
+        auto base = now - next_frame_ > frame_interval_ ? now : next_frame_;
+        next_frame_ = base + frame_interval_;
+    }
+
+    void FramePacer::MarkInput() {
+        input_ = std::chrono::steady_clock::now();
+    }
+
+    void FramePacer::PreparePresent(vk::PresentInfoKHR& present, vk::PresentIdKHR& present_id) {
+        present_id_ = 0;
+        if (!present_wait_) return;
+
+        present_id_ = next_present_id_++;
+        present_id.sType = vk::StructureType::ePresentIdKHR;
+        present_id.setSwapchainCount(1);
+        present_id.setPPresentIds(&present_id_);
+        present_id.setPNext(present.pNext);
+        present.setPNext(&present_id);
+    }
+
+    void FramePacer::Presented(bool queued) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!queued) return;
+
+            stats_.presented++;
+            if (present_id_ == 0) return;
+            pending_.push_back({swapchain_, present_id_, input_});
+        }
+        wake_.notify_one();
+    }
+
+    uint32_t FramePacer::frames_in_flight() const {
+        return frames_in_flight_;
+    }
+
+    bool FramePacer::measures_latency() const {
+        return present_wait_;
+    }
+
+    FramePacingStatistics FramePacer::statistics() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        FramePacingStatistics stats = stats_;
+        stats.latency_avg_ms = stats.latency_samples > 0 ? latency_total_ms_ / stats.latency_samples : 0.0;
+        return stats;
+    }
+
+    // Present ids complete in order, so waiting on the oldest pending one at a time
+    // observes each of them.
+    void FramePacer::WaitForPresents() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this]() { return stop_ || !pending_.empty(); });
+            if (stop_) return;
+
+            PendingPresent present = pending_.front();
+            waiting_on_ = present.swapchain;
+            lock.unlock();
+
+            VkResult result = dispatch_->get().vkWaitForPresentKHR(static_cast<VkDevice>(device_), static_cast<VkSwapchainKHR>(present.swapchain),
+                                                                   present.id, PRESENT_WAIT_TIMEOUT_NS);
+            auto shown = std::chrono::steady_clock::now();
+
+            lock.lock();
+            waiting_on_ = nullptr;
+            idle_.notify_all();
+
+            // SetSwapchain may have dropped it in the meantime.
+            if (pending_.empty() || pending_.front().id != present.id)
+                continue;
+            if (result == VK_TIMEOUT)
+                continue;
+
+            pending_.pop_front();
+            // Out of date or lost surfaces never show the frame; there is nothing to measure.
+            if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+                continue;
+
+            double latency_ms = MillisecondsBetween(present.input, shown);
+            stats_.latency_min_ms = stats_.latency_samples == 0 ? latency_ms : std::min(stats_.latency_min_ms, latency_ms);
+            stats_.latency_max_ms = std::max(stats_.latency_max_ms, latency_ms);
+            stats_.latency_last_ms = latency_ms;
+            stats_.latency_samples++;
+            latency_total_ms_ += latency_ms;
+        }
+    }
+}
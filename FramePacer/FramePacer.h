@@ -0,0 +1,117 @@
+#ifndef MVK_FRAME_PACER
+#define MVK_FRAME_PACER
+
+#include <vulkan/vulkan.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "../DispatchTable/DispatchTable.h"
+#include "../MVKConstants.h"
+
+namespace mvk {
+    struct FramePacingSettings {
+        // Falls back to FIFO when the surface does not offer it.
+        vk::PresentModeKHR present_mode = vk::PresentModeKHR::eMailbox;
+        // 0 asks for one image more than the surface minimum.
+        uint32_t swapchain_images = 0;
+        // Frames the CPU may record ahead of the GPU; fixed once Setup has run.
+        uint32_t frames_in_flight = DEFAULT_FRAMES_IN_FLIGHT;
+        // Frame-rate cap; 0 renders as fast as the present mode allows.
+        double max_fps = 0.0;
+    };
+
+    struct FramePacingStatistics {
+        vk::PresentModeKHR present_mode = vk::PresentModeKHR::eFifo;
+        uint32_t swapchain_images = 0;
+        uint32_t frames_in_flight = 0;
+        uint64_t presented = 0;
+        // Slept to hold the frame-rate cap.
+        double throttled_ms = 0.0;
+        // From MarkInput until the frame is on screen. Stays at 0 samples without
+        // VK_KHR_present_wait.
+        uint64_t latency_samples = 0;
+        double latency_last_ms = 0.0;
+        double latency_min_ms = 0.0;
+        double latency_avg_ms = 0.0;
+        double latency_max_ms = 0.0;
+    };
+
+    // Paces the present loop: sleeps out an optional frame-rate cap and, where
+    // VK_KHR_present_id and VK_KHR_present_wait are enabled, measures how long each
+    // frame's input takes to reach the display. vkWaitForPresentKHR blocks, so it is
+    // called from a thread of its own and the render thread only hands over present ids.
+    class FramePacer {
+       public:
+        // present_wait: both extensions and their features are enabled on device.
+        void Init(vk::Device device, const DispatchTable& dispatch, const FramePacingSettings& settings, bool present_wait);
+        // Stops the latency thread. Call before the swapchain is destroyed.
+        void Destroy();
+
+        // Measures presents to swapchain from now on. Presents still pending on the
+        // previous swapchain are dropped. Does not block: the latency thread may still be
+        // waiting on the previous swapchain when this returns.
+        void SetSwapchain(vk::SwapchainKHR swapchain, vk::PresentModeKHR present_mode, uint32_t image_count);
+        // Call right before destroying a swapchain that was replaced with SetSwapchain.
+        // Returns once the latency thread is no longer waiting on it, which it normally is
+        // not by the time the old swapchain's frames have retired.
+        void ReleaseSwapchain(vk::SwapchainKHR swapchain);
+        void set_frame_rate_limit(double max_fps);
+
+        // Sleeps until the next frame is due under the cap.
+        void Throttle();
+        // The coming frame samples its input now; its latency is measured from here.
+        void MarkInput();
+        // Chains present_id into present when latency is measured; present_id has to
+        // outlive the vkQueuePresentKHR call.
+        void PreparePresent(vk::PresentInfoKHR& present, vk::PresentIdKHR& present_id);
+        // After vkQueuePresentKHR; queued is false when the present was rejected.
+        void Presented(bool queued);
+
+        uint32_t frames_in_flight() const;
+        bool measures_latency() const;
+        FramePacingStatistics statistics();
+
+       private:
+        struct PendingPresent {
+            vk::SwapchainKHR swapchain;
+            uint64_t id = 0;
+            std::chrono::steady_clock::time_point input;
+        };
+
+        void WaitForPresents();
+
+        vk::Device device_;
+        const DispatchTable* dispatch_ = nullptr;
+        bool present_wait_ = false;
+        uint32_t frames_in_flight_ = 0;
+
+        std::chrono::steady_clock::duration frame_interval_{0};
+        std::chrono::steady_clock::time_point next_frame_;
+        std::chrono::steady_clock::time_point input_;
+
+        vk::SwapchainKHR swapchain_;
+        uint64_t next_present_id_ = 1;
+        // Id chained by the last PreparePresent, 0 when none was.
+        uint64_t present_id_ = 0;
+
+        std::thread waiter_;
+        std::mutex mutex_;
+        // New presents to wait on, or stop_.
+        std::condition_variable wake_;
+        // The waiter returned from vkWaitForPresentKHR.
+        std::condition_variable idle_;
+        std::deque<PendingPresent> pending_;
+        vk::SwapchainKHR waiting_on_;
+        bool stop_ = false;
+
+        FramePacingStatistics stats_;
+        double latency_total_ms_ = 0.0;
+    };
+}
+
+#endif  // MVK_FRAME_PACER
@@ -0,0 +1,246 @@
+#include "GpuCulling.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#include "../Shaders/ShadersHelper.h"
+
+static constexpr uint32_t CULL_GROUP_SIZE = 64;
+
+// Gribb-Hartmann: the planes of a view-projection frustum are sums and differences of its
+// rows. Vulkan clip depth is [0, w], so near is the third row alone.
+static void ExtractPlanes(const glm::mat4& m, glm::vec4 planes[6]) {
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; ++i)
+        rows[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+    planes[0] = rows[3] + rows[0];
+    planes[1] = rows[3] - rows[0];
+    planes[2] = rows[3] + rows[1];
+    planes[3] = rows[3] - rows[1];
+    planes[4] = rows[2];
+    planes[5] = rows[3] - rows[2];
+
+    for (int i = 0; i < 6; ++i)
+        planes[i] /= glm::length(glm::vec3(planes[i]));
+}
+
+namespace mvk {
+    void GpuCulling::Init(vk::Device device, DeviceMemoryAllocator& allocator, const DispatchTable& dispatch,
+                          vk::PipelineCache cache, uint32_t max_objects, uint32_t frames_in_flight) {
+        device_ = device;
+        allocator_ = &allocator;
+        dispatch_ = &dispatch;
+        max_objects_ = max_objects;
+
+        vk::MemoryPropertyFlags host = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        vk::MemoryPropertyFlags local = vk::MemoryPropertyFlagBits::eDeviceLocal;
+        vk::DeviceSize commands_size = sizeof(VkDrawIndexedIndirectCommand) * max_objects_;
+
+        frames_.resize(frames_in_flight);
+        for (auto &frame : frames_) {
+            frame.params = CreateBuffer(sizeof(CullParams), vk::BufferUsageFlagBits::eUniformBuffer, host, frame.params_allocation);
+            frame.objects = CreateBuffer(object_buffer_size(), vk::BufferUsageFlagBits::eStorageBuffer, host, frame.objects_allocation);
+            frame.commands = CreateBuffer(commands_size, vk::BufferUsageFlagBits::eStorageBuffer, host, frame.commands_allocation);
+            frame.visible = CreateBuffer(commands_size, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+                                         local, frame.visible_allocation);
+            frame.count = CreateBuffer(sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer |
+                                       vk::BufferUsageFlagBits::eTransferDst, local, frame.count_allocation);
+        }
+
+        CreatePipeline(cache);
+        CreateDescriptorSets();
+    }
+
+    void GpuCulling::Destroy() {
+        device_.destroyPipeline(pipeline_);
+        device_.destroyPipelineLayout(layout_);
+        device_.destroyDescriptorPool(descriptor_pool_);
+        device_.destroyDescriptorSetLayout(set_layout_);
+
+        for (auto &frame : frames_) {
+            device_.destroyBuffer(frame.params);
+            device_.destroyBuffer(frame.objects);
+            device_.destroyBuffer(frame.commands);
+            device_.destroyBuffer(frame.visible);
+            device_.destroyBuffer(frame.count);
+            allocator_->Free(frame.params_allocation);
+            allocator_->Free(frame.objects_allocation);
+            allocator_->Free(frame.commands_allocation);
+            allocator_->Free(frame.visible_allocation);
+            allocator_->Free(frame.count_allocation);
+        }
+        frames_.clear();
+    }
+
+    bool GpuCulling::Update(uint32_t frame_slot, const std::vector<DrawCommand>& draws, uint64_t version) {
+        FrameBuffers &frame = frames_[frame_slot];
+        if (frame.version == version) return false;
+
+        if (draws.size() > max_objects_)
+            throw std::runtime_error("Draw list exceeds MAX_DRAW_OBJECTS.");
+
+        ObjectData* objects = static_cast<ObjectData*>(frame.objects_allocation.mapped);
+        VkDrawIndexedIndirectCommand* commands = static_cast<VkDrawIndexedIndirectCommand*>(frame.commands_allocation.mapped);
+        for (size_t i = 0; i < draws.size(); ++i) {
+            objects[i] = draws[i].object;
+            commands[i].indexCount = draws[i].index_count;
+            commands[i].instanceCount = 1;
+            commands[i].firstIndex = draws[i].first_index;
+            commands[i].vertexOffset = draws[i].vertex_offset;
+            commands[i].firstInstance = static_cast<uint32_t>(i);
+        }
+
+        frame.object_count = static_cast<uint32_t>(draws.size());
+        frame.version = version;
+        return true;
+    }
+
+    void GpuCulling::Dispatch(vk::CommandBuffer command_buffer, uint32_t frame_slot, const glm::mat4& model, const glm::mat4& view_projection) {
+        FrameBuffers &frame = frames_[frame_slot];
+        const vk::DispatchLoaderDynamic& dispatch = dispatch_->get();
+
+        CullParams params{};
+        params.Model = model;
+        ExtractPlanes(view_projection, params.Planes);
+        params.ObjectCount = frame.object_count;
+        std::memcpy(frame.params_allocation.mapped, &params, sizeof(params));
+
+        command_buffer.fillBuffer(frame.count, 0, sizeof(uint32_t), 0, dispatch);
+
+        vk::MemoryBarrier clear_barrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {},
+                                       1, &clear_barrier, 0, nullptr, 0, nullptr, dispatch);
+
+        command_buffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline_, dispatch);
+        command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, layout_, 0, 1, &frame.descriptor_set, 0, nullptr, dispatch);
+        command_buffer.dispatch((frame.object_count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1, dispatch);
+
+        vk::MemoryBarrier cull_barrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eIndirectCommandRead);
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect, {},
+                                       1, &cull_barrier, 0, nullptr, 0, nullptr, dispatch);
+    }
+
+    void GpuCulling::Draw(vk::CommandBuffer command_buffer, uint32_t frame_slot) {
+        FrameBuffers &frame = frames_[frame_slot];
+        command_buffer.drawIndexedIndirectCount(frame.visible, 0, frame.count, 0, frame.object_count,
+                                                sizeof(VkDrawIndexedIndirectCommand), dispatch_->get());
+    }
+
+    vk::Buffer GpuCulling::object_buffer(uint32_t frame_slot) const {
+        return frames_[frame_slot].objects;
+    }
+
+    vk::DeviceSize GpuCulling::object_buffer_size() const {
+        return sizeof(ObjectData) * max_objects_;
+    }
+
+    ObjectData* GpuCulling::object_data(uint32_t frame_slot) const {
+        return static_cast<ObjectData*>(frames_[frame_slot].objects_allocation.mapped);
+    }
+
+    vk::Buffer GpuCulling::CreateBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, Allocation& allocation) {
+        vk::BufferCreateInfo buffer_info{};
+        buffer_info.sType = vk::StructureType::eBufferCreateInfo;
+        buffer_info.setSize(size);
+        buffer_info.setUsage(usage);
+        buffer_info.setSharingMode(vk::SharingMode::eExclusive);
+
+        vk::Buffer buffer = device_.createBuffer(buffer_info);
+        allocation = allocator_->Allocate(device_.getBufferMemoryRequirements(buffer), properties, ResourceKind::eLinear);
+        device_.bindBufferMemory(buffer, allocation.memory, allocation.offset);
+        return buffer;
+    }
+
+    void GpuCulling::CreatePipeline(vk::PipelineCache cache) {
+        std::array<vk::DescriptorSetLayoutBinding, 5> bindings;
+        for (uint32_t i = 0; i < bindings.size(); ++i) {
+            bindings[i].setBinding(i);
+            bindings[i].setDescriptorCount(1);
+            bindings[i].setDescriptorType(i == 0 ? vk::DescriptorType::eUniformBuffer : vk::DescriptorType::eStorageBuffer);
+            bindings[i].setStageFlags(vk::ShaderStageFlagBits::eCompute);
+        }
+
+        vk::DescriptorSetLayoutCreateInfo set_layout_info{};
+        set_layout_info.sType = vk::StructureType::eDescriptorSetLayoutCreateInfo;
+        set_layout_info.setBindingCount(bindings.size());
+        set_layout_info.setPBindings(bindings.data());
+        set_layout_ = device_.createDescriptorSetLayout(set_layout_info);
+
+        vk::PipelineLayoutCreateInfo layout_info{};
+        layout_info.sType = vk::StructureType::ePipelineLayoutCreateInfo;
+        layout_info.setSetLayoutCount(1);
+        layout_info.setPSetLayouts(&set_layout_);
+        layout_ = device_.createPipelineLayout(layout_info);
+
+        vk::ShaderModule module = device_.createShaderModule(ShadersHelper::LoadCullShader());
+
+        vk::PipelineShaderStageCreateInfo stage_info{};
+        stage_info.sType = vk::StructureType::ePipelineShaderStageCreateInfo;
+        stage_info.setStage(vk::ShaderStageFlagBits::eCompute);
+        stage_info.setModule(module);
+        stage_info.setPName("main");
+
+        vk::ComputePipelineCreateInfo pipeline_info{};
+        pipeline_info.sType = vk::StructureType::eComputePipelineCreateInfo;
+        pipeline_info.setStage(stage_info);
+        pipeline_info.setLayout(layout_);
+
+        auto res = device_.createComputePipeline(cache, pipeline_info);
+        device_.destroyShaderModule(module);
+
+        if (res.result != vk::Result::eSuccess)
+            throw std::runtime_error("Cannot create culling pipeline.");
+        pipeline_ = res.value;
+    }
+
+    void GpuCulling::CreateDescriptorSets() {
+        uint32_t frame_count = static_cast<uint32_t>(frames_.size());
+
+        std::array<vk::DescriptorPoolSize, 2> pool_sizes = {
+            vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, frame_count),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 4 * frame_count)
+        };
+
+        vk::DescriptorPoolCreateInfo pool_info{};
+        pool_info.sType = vk::StructureType::eDescriptorPoolCreateInfo;
+        pool_info.setPoolSizeCount(pool_sizes.size());
+        pool_info.setPPoolSizes(pool_sizes.data());
+        pool_info.setMaxSets(frame_count);
+        descriptor_pool_ = device_.createDescriptorPool(pool_info);
+
+        std::vector<vk::DescriptorSetLayout> layouts(frame_count, set_layout_);
+        vk::DescriptorSetAllocateInfo alloc_info{};
+        alloc_info.sType = vk::StructureType::eDescriptorSetAllocateInfo;
+        alloc_info.setDescriptorPool(descriptor_pool_);
+        alloc_info.setDescriptorSetCount(frame_count);
+        alloc_info.setPSetLayouts(layouts.data());
+        std::vector<vk::DescriptorSet> sets = device_.allocateDescriptorSets(alloc_info);
+
+        for (uint32_t i = 0; i < frame_count; ++i) {
+            FrameBuffers &frame = frames_[i];
+            frame.descriptor_set = sets[i];
+
+            std::array<vk::DescriptorBufferInfo, 5> buffer_infos = {
+                vk::DescriptorBufferInfo(frame.params, 0, VK_WHOLE_SIZE),
+                vk::DescriptorBufferInfo(frame.objects, 0, VK_WHOLE_SIZE),
+                vk::DescriptorBufferInfo(frame.commands, 0, VK_WHOLE_SIZE),
+                vk::DescriptorBufferInfo(frame.visible, 0, VK_WHOLE_SIZE),
+                vk::DescriptorBufferInfo(frame.count, 0, VK_WHOLE_SIZE)
+            };
+
+            std::array<vk::WriteDescriptorSet, 5> writes;
+            for (uint32_t binding = 0; binding < writes.size(); ++binding) {
+                writes[binding].sType = vk::StructureType::eWriteDescriptorSet;
+                writes[binding].setDstSet(frame.descriptor_set);
+                writes[binding].setDstBinding(binding);
+                writes[binding].setDescriptorCount(1);
+                writes[binding].setDescriptorType(binding == 0 ? vk::DescriptorType::eUniformBuffer : vk::DescriptorType::eStorageBuffer);
+                writes[binding].setPBufferInfo(&buffer_infos[binding]);
+            }
+
+            device_.updateDescriptorSets(writes.size(), writes.data(), 0, nullptr);
+        }
+    }
+}
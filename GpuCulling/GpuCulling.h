@@ -0,0 +1,75 @@
+#ifndef MVK_GPU_CULLING
+#define MVK_GPU_CULLING
+
+#include <vulkan/vulkan.hpp>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "../DispatchTable/DispatchTable.h"
+#include "../MemoryAllocator/DeviceMemoryAllocator.h"
+#include "../ObjectLoader/ObjectLoader.h"
+
+namespace mvk {
+    // std140 uniform block of CullShader.glsl.
+    struct CullParams {
+        glm::mat4 Model;
+        glm::vec4 Planes[6];
+        uint32_t ObjectCount;
+        uint32_t padding[3];
+    };
+
+    // GPU-driven path: every frame slot holds the object records and one indirect draw
+    // per object in host-visible storage buffers. A compute pass frustum-culls them and
+    // compacts the survivors, which are drawn with one drawIndexedIndirectCount. CPU time
+    // per frame does not depend on the object count; the draw list is only copied again
+    // into slots that have not seen its latest version.
+    class GpuCulling {
+       public:
+        void Init(vk::Device device, DeviceMemoryAllocator& allocator, const DispatchTable& dispatch,
+                  vk::PipelineCache cache, uint32_t max_objects, uint32_t frames_in_flight);
+        void Destroy();
+
+        // version changes whenever draws does; throws if draws exceeds max_objects.
+        // Returns whether the slot was rewritten.
+        bool Update(uint32_t frame_slot, const std::vector<DrawCommand>& draws, uint64_t version);
+        // Outside of a render pass, before Draw.
+        void Dispatch(vk::CommandBuffer command_buffer, uint32_t frame_slot, const glm::mat4& model, const glm::mat4& view_projection);
+        // Inside the render pass, with the graphics pipeline and buffers bound.
+        void Draw(vk::CommandBuffer command_buffer, uint32_t frame_slot);
+
+        // Bound to the graphics descriptor set so vertex shaders can read transforms.
+        vk::Buffer object_buffer(uint32_t frame_slot) const;
+        vk::DeviceSize object_buffer_size() const;
+        // Persistently mapped ObjectData array of the slot, for writers that skip Update.
+        ObjectData* object_data(uint32_t frame_slot) const;
+
+       private:
+        struct FrameBuffers {
+            vk::Buffer params, objects, commands, visible, count;
+            Allocation params_allocation, objects_allocation, commands_allocation, visible_allocation, count_allocation;
+            vk::DescriptorSet descriptor_set;
+            uint64_t version = UINT64_MAX;
+            uint32_t object_count = 0;
+        };
+
+        vk::Buffer CreateBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, Allocation& allocation);
+        void CreatePipeline(vk::PipelineCache cache);
+        void CreateDescriptorSets();
+
+        vk::Device device_;
+        DeviceMemoryAllocator* allocator_ = nullptr;
+        const DispatchTable* dispatch_ = nullptr;
+        uint32_t max_objects_ = 0;
+
+        std::vector<FrameBuffers> frames_;
+        vk::DescriptorSetLayout set_layout_;
+        vk::DescriptorPool descriptor_pool_;
+        vk::PipelineLayout layout_;
+        vk::Pipeline pipeline_;
+    };
+}
+
+#endif  // MVK_GPU_CULLING
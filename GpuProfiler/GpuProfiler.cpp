@@ -0,0 +1,250 @@
+#include "GpuProfiler.h"
+
+#include <fstream>
+#include <iostream>
+
+// Query layout of a frame: the frame itself, then one begin/end pair per scope.
+static constexpr uint32_t FRAME_BEGIN_QUERY = 0;
+static constexpr uint32_t FRAME_END_QUERY = 1;
+static constexpr uint32_t TIMESTAMP_QUERY_COUNT = 2 + 2 * mvk::PROFILER_MAX_GPU_SCOPES;
+
+static constexpr vk::QueryPipelineStatisticFlags STATISTICS =
+    vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+    vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+
+static void WriteEscaped(std::ofstream& file, std::string_view text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') file << '\\';
+        file << c;
+    }
+}
+
+namespace mvk {
+    void GpuProfiler::Init(vk::PhysicalDevice physical_device, vk::Device device, const DispatchTable& dispatch,
+                           uint32_t graphics_family, uint32_t frames_in_flight, bool inherited_queries,
+                           const ProfilerSettings& settings) {
+        device_ = device;
+        dispatch_ = &dispatch;
+        origin_ = std::chrono::steady_clock::now();
+        enabled_ = settings.enabled;
+        events_.Reset(settings.max_events);
+        counters_.Reset(settings.max_events);
+        if (!enabled_) return;
+
+        vk::PhysicalDeviceProperties properties = physical_device.getProperties();
+        uint32_t valid_bits = physical_device.getQueueFamilyProperties()[graphics_family].timestampValidBits;
+
+        timestamps_supported_ = valid_bits > 0 && properties.limits.timestampPeriod > 0.0f;
+        timestamp_mask_ = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+        timestamp_period_ns_ = properties.limits.timestampPeriod;
+        statistics_supported_ = physical_device.getFeatures().pipelineStatisticsQuery;
+        inherited_queries_ = inherited_queries;
+
+        if (!timestamps_supported_)
+            std::cout << "\u001b[33mWARNING: Graphics queue has no timestamps, GPU scopes are disabled.\u001b[0m\n";
+
+        frames_.resize(frames_in_flight);
+        for (auto &queries : frames_) {
+            if (timestamps_supported_) {
+                vk::QueryPoolCreateInfo timestamp_info{};
+                timestamp_info.sType = vk::StructureType::eQueryPoolCreateInfo;
+                timestamp_info.setQueryType(vk::QueryType::eTimestamp);
+                timestamp_info.setQueryCount(TIMESTAMP_QUERY_COUNT);
+                queries.timestamps = device_.createQueryPool(timestamp_info);
+            }
+
+            if (statistics_supported_) {
+                vk::QueryPoolCreateInfo statistics_info{};
+                statistics_info.sType = vk::StructureType::eQueryPoolCreateInfo;
+                statistics_info.setQueryType(vk::QueryType::ePipelineStatistics);
+                statistics_info.setQueryCount(1);
+                statistics_info.setPipelineStatistics(STATISTICS);
+                queries.statistics = device_.createQueryPool(statistics_info);
+            }
+        }
+    }
+
+    void GpuProfiler::Destroy() {
+        for (auto &queries : frames_) {
+            if (queries.pending)
+                Resolve(queries);
+            device_.destroyQueryPool(queries.timestamps);
+            device_.destroyQueryPool(queries.statistics);
+        }
+        frames_.clear();
+    }
+
+    void GpuProfiler::BeginFrame(uint32_t frame_slot) {
+        slot_ = frame_slot;
+        frame_++;
+    }
+
+    void GpuProfiler::BeginCpuScope(const char* name) {
+        if (!enabled_) return;
+        cpu_stack_.emplace_back(name, NowUs());
+    }
+
+    void GpuProfiler::EndCpuScope() {
+        if (cpu_stack_.empty()) return;
+
+        auto [name, start] = cpu_stack_.back();
+        cpu_stack_.pop_back();
+        AddEvent(name, frame_, start, NowUs() - start, false);
+    }
+
+    void GpuProfiler::BeginCommands(vk::CommandBuffer command_buffer, bool secondaries) {
+        if (frames_.empty()) return;
+
+        FrameQueries &queries = frames_[slot_];
+        // The caller has waited on this slot's fence, so its last results are final.
+        if (queries.pending)
+            Resolve(queries);
+
+        queries.frame = frame_;
+        queries.scope_names.clear();
+        queries.pending = true;
+        // Executing secondaries inside an active query needs inheritedQueries.
+        queries.statistics_active = statistics_supported_ && (!secondaries || inherited_queries_);
+
+        if (timestamps_supported_) {
+            command_buffer.resetQueryPool(queries.timestamps, 0, TIMESTAMP_QUERY_COUNT, dispatch_->get());
+            command_buffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, queries.timestamps, FRAME_BEGIN_QUERY, dispatch_->get());
+        }
+        if (queries.statistics_active) {
+            command_buffer.resetQueryPool(queries.statistics, 0, 1, dispatch_->get());
+            command_buffer.beginQuery(queries.statistics, 0, {}, dispatch_->get());
+        }
+    }
+
+    void GpuProfiler::EndCommands(vk::CommandBuffer command_buffer) {
+        if (frames_.empty()) return;
+
+        FrameQueries &queries = frames_[slot_];
+        if (queries.statistics_active)
+            command_buffer.endQuery(queries.statistics, 0, dispatch_->get());
+        if (timestamps_supported_)
+            command_buffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, queries.timestamps, FRAME_END_QUERY, dispatch_->get());
+    }
+
+    uint32_t GpuProfiler::BeginGpuScope(vk::CommandBuffer command_buffer, const char* name) {
+        if (frames_.empty() || !timestamps_supported_) return UINT32_MAX;
+
+        FrameQueries &queries = frames_[slot_];
+        if (queries.scope_names.size() == PROFILER_MAX_GPU_SCOPES) return UINT32_MAX;
+
+        uint32_t scope = static_cast<uint32_t>(queries.scope_names.size());
+        queries.scope_names.push_back(name);
+        command_buffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, queries.timestamps, 2 + 2 * scope, dispatch_->get());
+        return scope;
+    }
+
+    void GpuProfiler::EndGpuScope(vk::CommandBuffer command_buffer, uint32_t scope) {
+        if (scope == UINT32_MAX) return;
+        command_buffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, frames_[slot_].timestamps, 3 + 2 * scope, dispatch_->get());
+    }
+
+    vk::QueryPipelineStatisticFlags GpuProfiler::inherited_statistics() const {
+        if (frames_.empty() || !frames_[slot_].statistics_active) return {};
+        return STATISTICS;
+    }
+
+    void GpuProfiler::MarkSubmit() {
+        if (frames_.empty()) return;
+        frames_[slot_].submit_us = NowUs();
+    }
+
+    bool GpuProfiler::WriteChromeTrace(const std::string& path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cout << "\u001b[33mWARNING: Cannot write trace: " << path << "\u001b[0m\n";
+            return false;
+        }
+
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+        for (const auto &event : events_.Items()) {
+            file << ",\n{\"name\":\"";
+            WriteEscaped(file, event.name);
+            file << "\",\"cat\":\"" << (event.gpu ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (event.gpu ? 2 : 1)
+                 << ",\"ts\":" << event.start_us << ",\"dur\":" << event.duration_us
+                 << ",\"args\":{\"frame\":" << event.frame << "}}";
+        }
+
+        for (const auto &counter : counters_.Items()) {
+            file << ",\n{\"name\":\"pipeline statistics\",\"ph\":\"C\",\"pid\":1,\"ts\":" << counter.time_us
+                 << ",\"args\":{\"vertex_invocations\":" << counter.vertex_invocations
+                 << ",\"clipping_primitives\":" << counter.clipping_primitives
+                 << ",\"fragment_invocations\":" << counter.fragment_invocations << "}}";
+        }
+
+        file << "\n]}\n";
+        return file.good();
+    }
+
+    bool GpuProfiler::enabled() const {
+        return enabled_;
+    }
+
+    std::vector<ProfilerEvent> GpuProfiler::events() const {
+        return events_.Items();
+    }
+
+    std::vector<ProfilerCounters> GpuProfiler::counters() const {
+        return counters_.Items();
+    }
+
+    void GpuProfiler::Resolve(FrameQueries& queries) {
+        queries.pending = false;
+
+        if (timestamps_supported_) {
+            uint32_t query_count = 2 + 2 * static_cast<uint32_t>(queries.scope_names.size());
+            std::vector<uint64_t> ticks(query_count);
+            vk::Result res = device_.getQueryPoolResults(queries.timestamps, 0, query_count, ticks.size() * sizeof(uint64_t),
+                                                         ticks.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+
+            // eNotReady only happens if the slot was never submitted; drop it rather than wait.
+            if (res == vk::Result::eSuccess) {
+                uint64_t origin = ticks[FRAME_BEGIN_QUERY] & timestamp_mask_;
+                auto ToUs = [&](uint64_t tick) {
+                    return queries.submit_us + static_cast<double>(((tick & timestamp_mask_) - origin) & timestamp_mask_) * timestamp_period_ns_ / 1000.0;
+                };
+
+                AddEvent("frame", queries.frame, ToUs(ticks[FRAME_BEGIN_QUERY]), ToUs(ticks[FRAME_END_QUERY]) - ToUs(ticks[FRAME_BEGIN_QUERY]), true);
+                for (uint32_t i = 0; i < queries.scope_names.size(); ++i) {
+                    double start = ToUs(ticks[2 + 2 * i]);
+                    AddEvent(queries.scope_names[i], queries.frame, start, ToUs(ticks[3 + 2 * i]) - start, true);
+                }
+            }
+        }
+
+        if (queries.statistics_active) {
+            uint64_t values[3] = {};
+            vk::Result res = device_.getQueryPoolResults(queries.statistics, 0, 1, sizeof(values), values, sizeof(values),
+                                                         vk::QueryResultFlagBits::e64);
+            // Results are ordered by flag bit: vertex, clipping, fragment.
+            if (res == vk::Result::eSuccess)
+                counters_.Push({queries.frame, queries.submit_us, values[0], values[1], values[2]});
+        }
+    }
+
+    void GpuProfiler::AddEvent(const char* name, uint64_t frame, double start_us, double duration_us, bool gpu) {
+        events_.Push({name, frame, start_us, duration_us, gpu});
+        if (events_.overwritten() == 1)
+            std::cout << "\u001b[33mWARNING: Profiler event buffer is full, overwriting the oldest events.\u001b[0m\n";
+    }
+
+    double GpuProfiler::NowUs() const {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origin_).count();
+    }
+
+    CpuScope::CpuScope(GpuProfiler& profiler, const char* name) : profiler_(profiler) {
+        profiler_.BeginCpuScope(name);
+    }
+
+    CpuScope::~CpuScope() {
+        profiler_.EndCpuScope();
+    }
+}
@@ -0,0 +1,175 @@
+#ifndef MVK_GPU_PROFILER
+#define MVK_GPU_PROFILER
+
+#include <vulkan/vulkan.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../DispatchTable/DispatchTable.h"
+
+namespace mvk {
+    constexpr uint32_t PROFILER_MAX_GPU_SCOPES = 32;
+    constexpr size_t PROFILER_DEFAULT_MAX_EVENTS = 1 << 16;
+
+    struct ProfilerSettings {
+        // Off unless asked for here or with the MVK_PROFILE environment variable.
+        bool enabled = false;
+        // Past this many events or counter samples the oldest ones are overwritten.
+        size_t max_events = PROFILER_DEFAULT_MAX_EVENTS;
+    };
+
+    struct ProfilerEvent {
+        // Scope names are string literals, so events only point at them.
+        std::string_view name;
+        uint64_t frame;
+        double start_us;
+        double duration_us;
+        bool gpu;
+    };
+
+    struct ProfilerCounters {
+        uint64_t frame;
+        double time_us;
+        uint64_t vertex_invocations;
+        uint64_t clipping_primitives;
+        uint64_t fragment_invocations;
+    };
+
+    // Fixed-capacity log that overwrites its oldest entries once full.
+    template <typename T>
+    class ProfilerRing {
+       public:
+        void Reset(size_t capacity) {
+            items_.clear();
+            capacity_ = capacity;
+            head_ = 0;
+            overwritten_ = 0;
+        }
+
+        void Push(T item) {
+            if (capacity_ == 0) return;
+            if (items_.size() < capacity_) {
+                items_.push_back(std::move(item));
+                return;
+            }
+            items_[head_] = std::move(item);
+            head_ = (head_ + 1) % capacity_;
+            overwritten_++;
+        }
+
+        // Oldest first.
+        std::vector<T> Items() const {
+            std::vector<T> items(items_.begin() + head_, items_.end());
+            items.insert(items.end(), items_.begin(), items_.begin() + head_);
+            return items;
+        }
+
+        uint64_t overwritten() const { return overwritten_; }
+
+       private:
+        std::vector<T> items_;
+        size_t capacity_ = 0;
+        // Oldest entry once the ring is full.
+        size_t head_ = 0;
+        uint64_t overwritten_ = 0;
+    };
+
+    // Per-frame GPU timestamps and pipeline statistics next to CPU scopes, on one
+    // timeline. Each frame slot owns its query pools; the slot is resolved when it is
+    // recorded again, after its fence has been waited on, so reading results never stalls.
+    //
+    // GPU time is placed on the CPU timeline by aligning the first timestamp of a frame
+    // with the moment it was submitted. The GPU cannot start earlier, so scopes may
+    // appear slightly early but never overlap the CPU work that produced them.
+    //
+    // A disabled profiler creates no query pools and records nothing; every call returns
+    // right away.
+    class GpuProfiler {
+       public:
+        // inherited_queries: the inheritedQueries feature is enabled, so secondary buffers
+        // may run while the statistics query is active.
+        void Init(vk::PhysicalDevice physical_device, vk::Device device, const DispatchTable& dispatch,
+                  uint32_t graphics_family, uint32_t frames_in_flight, bool inherited_queries,
+                  const ProfilerSettings& settings);
+        // Resolves frames still pending; the device must be idle.
+        void Destroy();
+
+        void BeginFrame(uint32_t frame_slot);
+        void BeginCpuScope(const char* name);
+        void EndCpuScope();
+
+        // Must be recorded outside of a render pass. secondaries: the frame executes secondary
+        // buffers; without inheritedQueries its pipeline statistics are then not collected.
+        void BeginCommands(vk::CommandBuffer command_buffer, bool secondaries = false);
+        void EndCommands(vk::CommandBuffer command_buffer);
+        // Returns an id for EndGpuScope, or UINT32_MAX once the frame is out of queries.
+        uint32_t BeginGpuScope(vk::CommandBuffer command_buffer, const char* name);
+        void EndGpuScope(vk::CommandBuffer command_buffer, uint32_t scope);
+        // Statistics secondary buffers of the frame being recorded must declare in their
+        // inheritance info; empty when no statistics query is active.
+        vk::QueryPipelineStatisticFlags inherited_statistics() const;
+        // Call just before the frame's command buffer is submitted.
+        void MarkSubmit();
+
+        bool WriteChromeTrace(const std::string& path) const;
+
+        bool enabled() const;
+        // The most recent max_events of each, oldest first.
+        std::vector<ProfilerEvent> events() const;
+        std::vector<ProfilerCounters> counters() const;
+
+       private:
+        struct FrameQueries {
+            vk::QueryPool timestamps;
+            vk::QueryPool statistics;
+            std::vector<const char*> scope_names;
+            uint64_t frame = 0;
+            double submit_us = 0.0;
+            bool pending = false;
+            // The statistics query was recorded for this frame.
+            bool statistics_active = false;
+        };
+
+        void Resolve(FrameQueries& queries);
+        void AddEvent(const char* name, uint64_t frame, double start_us, double duration_us, bool gpu);
+        double NowUs() const;
+
+        vk::Device device_;
+        const DispatchTable* dispatch_ = nullptr;
+        std::vector<FrameQueries> frames_;
+        uint32_t slot_ = 0;
+        uint64_t frame_ = 0;
+
+        bool enabled_ = false;
+        bool timestamps_supported_ = false;
+        bool statistics_supported_ = false;
+        bool inherited_queries_ = false;
+        uint64_t timestamp_mask_ = 0;
+        double timestamp_period_ns_ = 1.0;
+
+        std::chrono::steady_clock::time_point origin_;
+        std::vector<std::pair<const char*, double>> cpu_stack_;
+        ProfilerRing<ProfilerEvent> events_;
+        ProfilerRing<ProfilerCounters> counters_;
+    };
+
+    // Times the enclosing block as a CPU scope, closing it on early returns too.
+    class CpuScope {
+       public:
+        CpuScope(GpuProfiler& profiler, const char* name);
+        ~CpuScope();
+
+        CpuScope(const CpuScope&) = delete;
+        CpuScope& operator=(const CpuScope&) = delete;
+
+       private:
+        GpuProfiler& profiler_;
+    };
+}
+
+#endif  // MVK_GPU_PROFILER
@@ -1,5 +1,9 @@
 #include "GraphicsSettings.h"
 
+#include <tuple>
+
+#include "../Fnv1a/Fnv1a.h"
+
 std::vector<vk::PipelineShaderStageCreateInfo> mvk::GraphicsSettings::CreateShadersStages(std::vector<vk::ShaderModule> shaders) {
     std::vector<vk::PipelineShaderStageCreateInfo> shader_stages;
 
@@ -125,7 +129,116 @@ vk::PipelineDynamicStateCreateInfo mvk::GraphicsSettings::CreateDynamicStates()
     return dynamic_state_info;
 }
 
-vk::SamplerCreateInfo mvk::GraphicsSettings::SetupTextureSettings(vk::PhysicalDevice& phys_device) {
+mvk::PipelineDescription mvk::GraphicsSettings::CreateDescription() {
+    PipelineDescription description;
+
+    vk::ShaderModuleCreateInfo vertex_info = ShadersHelper::LoadVertexShader();
+    vk::ShaderModuleCreateInfo fragment_info = ShadersHelper::LoadFragmentShader();
+    description.vertex_code.assign(vertex_info.pCode, vertex_info.pCode + vertex_info.codeSize / sizeof(uint32_t));
+    description.fragment_code.assign(fragment_info.pCode, fragment_info.pCode + fragment_info.codeSize / sizeof(uint32_t));
+
+    description.bindings = {ObjectLoader::GetVerticesBindingDescription()};
+    description.attributes = ObjectLoader::GetVerticesAttributeDescription();
+
+    description.input_assembly = CreateInputAssembly();
+    description.rasterizer = CreateRasterizer();
+    description.multisampling = CreateMultisampling();
+    description.colorblend = CreateColorBlend();
+
+    return description;
+}
+
+mvk::PipelineDescription mvk::GraphicsSettings::CreateInstancedDescription() {
+    PipelineDescription description = CreateDescription();
+
+    vk::ShaderModuleCreateInfo vertex_info = ShadersHelper::LoadInstancedVertexShader();
+    description.vertex_code.assign(vertex_info.pCode, vertex_info.pCode + vertex_info.codeSize / sizeof(uint32_t));
+
+    description.bindings.push_back(ObjectLoader::GetInstanceBindingDescription());
+    auto instance_attributes = ObjectLoader::GetInstanceAttributeDescription();
+    description.attributes.insert(description.attributes.end(), instance_attributes.begin(), instance_attributes.end());
+
+    return description;
+}
+
+// Hashes field by field: the create infos carry sType/pNext and padding that must not take part.
+uint64_t mvk::PipelineDescription::Hash() const {
+    uint64_t hash = 0;
+    auto mix = [&hash](const void* data, size_t size) { hash = Fnv1a::Hash(data, size, hash); };
+    auto mix_value = [&mix](auto value) { mix(&value, sizeof(value)); };
+
+    mix_value(vertex_code.size());
+    mix(vertex_code.data(), vertex_code.size() * sizeof(uint32_t));
+    mix_value(fragment_code.size());
+    mix(fragment_code.data(), fragment_code.size() * sizeof(uint32_t));
+
+    for (auto &binding : bindings) {
+        mix_value(binding.binding);
+        mix_value(binding.stride);
+        mix_value(binding.inputRate);
+    }
+    for (auto &attribute : attributes) {
+        mix_value(attribute.location);
+        mix_value(attribute.binding);
+        mix_value(attribute.format);
+        mix_value(attribute.offset);
+    }
+
+    mix_value(input_assembly.topology);
+    mix_value(input_assembly.primitiveRestartEnable);
+
+    mix_value(rasterizer.depthClampEnable);
+    mix_value(rasterizer.rasterizerDiscardEnable);
+    mix_value(rasterizer.polygonMode);
+    mix_value(static_cast<VkCullModeFlags>(rasterizer.cullMode));
+    mix_value(rasterizer.frontFace);
+    mix_value(rasterizer.depthBiasEnable);
+    mix_value(rasterizer.depthBiasConstantFactor);
+    mix_value(rasterizer.depthBiasClamp);
+    mix_value(rasterizer.depthBiasSlopeFactor);
+    mix_value(rasterizer.lineWidth);
+
+    mix_value(multisampling.rasterizationSamples);
+    mix_value(multisampling.sampleShadingEnable);
+    mix_value(multisampling.minSampleShading);
+    mix_value(multisampling.alphaToCoverageEnable);
+    mix_value(multisampling.alphaToOneEnable);
+
+    mix_value(colorblend.blendEnable);
+    mix_value(colorblend.srcColorBlendFactor);
+    mix_value(colorblend.dstColorBlendFactor);
+    mix_value(colorblend.colorBlendOp);
+    mix_value(colorblend.srcAlphaBlendFactor);
+    mix_value(colorblend.dstAlphaBlendFactor);
+    mix_value(colorblend.alphaBlendOp);
+    mix_value(static_cast<VkColorComponentFlags>(colorblend.colorWriteMask));
+
+    return hash;
+}
+
+bool mvk::PipelineDescription::operator==(const PipelineDescription& other) const {
+    auto input_assembly_fields = [](const vk::PipelineInputAssemblyStateCreateInfo& info) {
+        return std::tie(info.topology, info.primitiveRestartEnable);
+    };
+    auto rasterizer_fields = [](const vk::PipelineRasterizationStateCreateInfo& info) {
+        return std::tie(info.depthClampEnable, info.rasterizerDiscardEnable, info.polygonMode, info.cullMode, info.frontFace,
+                        info.depthBiasEnable, info.depthBiasConstantFactor, info.depthBiasClamp, info.depthBiasSlopeFactor,
+                        info.lineWidth);
+    };
+    auto multisampling_fields = [](const vk::PipelineMultisampleStateCreateInfo& info) {
+        return std::tie(info.rasterizationSamples, info.sampleShadingEnable, info.minSampleShading,
+                        info.alphaToCoverageEnable, info.alphaToOneEnable);
+    };
+
+    return vertex_code == other.vertex_code && fragment_code == other.fragment_code &&
+           bindings == other.bindings && attributes == other.attributes &&
+           input_assembly_fields(input_assembly) == input_assembly_fields(other.input_assembly) &&
+           rasterizer_fields(rasterizer) == rasterizer_fields(other.rasterizer) &&
+           multisampling_fields(multisampling) == multisampling_fields(other.multisampling) &&
+           colorblend == other.colorblend;
+}
+
+vk::SamplerCreateInfo mvk::GraphicsSettings::SetupTextureSettings(vk::PhysicalDevice& phys_device, float max_lod) {
     vk::SamplerCreateInfo sampler_info{};
     sampler_info.sType = vk::StructureType::eSamplerCreateInfo;
     sampler_info.setMagFilter(vk::Filter::eLinear);
@@ -147,7 +260,7 @@ vk::SamplerCreateInfo mvk::GraphicsSettings::SetupTextureSettings(vk::PhysicalDe
     sampler_info.setMipmapMode(vk::SamplerMipmapMode::eLinear);
     sampler_info.setMipLodBias(0.0f);
     sampler_info.setMinLod(0.0f);
-    sampler_info.setMaxLod(0.0f);
+    sampler_info.setMaxLod(max_lod);
 
     return sampler_info;
 }
@@ -9,6 +9,26 @@
 #include "../Shaders/ShadersHelper.h"
 
 namespace mvk {
+    // Everything that distinguishes one graphics pipeline from another, with the
+    // arrays the create infos point into owned here. Viewport, scissor and the
+    // dynamic states are the same for every pipeline and are not part of it.
+    struct PipelineDescription {
+        std::vector<uint32_t> vertex_code;
+        std::vector<uint32_t> fragment_code;
+
+        std::vector<vk::VertexInputBindingDescription> bindings;
+        std::vector<vk::VertexInputAttributeDescription> attributes;
+
+        vk::PipelineInputAssemblyStateCreateInfo input_assembly;
+        vk::PipelineRasterizationStateCreateInfo rasterizer;
+        vk::PipelineMultisampleStateCreateInfo multisampling;
+        vk::PipelineColorBlendAttachmentState colorblend;
+
+        uint64_t Hash() const;
+        // Compares the fields Hash covers.
+        bool operator==(const PipelineDescription& other) const;
+    };
+
     class GraphicsSettings {
        public:
         std::vector<vk::PipelineShaderStageCreateInfo> CreateShadersStages(std::vector<vk::ShaderModule> shaders);
@@ -21,7 +41,13 @@ namespace mvk {
         vk::PipelineColorBlendStateCreateInfo CreateColorBlendInfo(vk::PipelineColorBlendAttachmentState& colorblend);
         vk::PipelineDynamicStateCreateInfo CreateDynamicStates();
 
-        static vk::SamplerCreateInfo SetupTextureSettings(vk::PhysicalDevice& phys_device);
+        // The default pipeline state, ready to be tweaked into a variant.
+        PipelineDescription CreateDescription();
+        // The default state with a second, per-instance vertex stream (see InstanceData).
+        PipelineDescription CreateInstancedDescription();
+
+        // max_lod 0 restricts sampling to the base level.
+        static vk::SamplerCreateInfo SetupTextureSettings(vk::PhysicalDevice& phys_device, float max_lod = VK_LOD_CLAMP_NONE);
     };
 }
 
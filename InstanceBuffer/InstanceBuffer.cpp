@@ -0,0 +1,61 @@
+#include "InstanceBuffer.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace mvk {
+    void InstanceBuffer::Init(vk::Device device, DeviceMemoryAllocator& allocator, uint32_t max_instances, uint32_t frames_in_flight) {
+        device_ = device;
+        allocator_ = &allocator;
+        max_instances_ = max_instances;
+
+        frames_.resize(frames_in_flight);
+        for (auto &frame : frames_) {
+            vk::BufferCreateInfo buffer_info{};
+            buffer_info.sType = vk::StructureType::eBufferCreateInfo;
+            buffer_info.setSize(sizeof(InstanceData) * max_instances_);
+            buffer_info.setUsage(vk::BufferUsageFlagBits::eVertexBuffer);
+            buffer_info.setSharingMode(vk::SharingMode::eExclusive);
+
+            frame.buffer = device_.createBuffer(buffer_info);
+            frame.allocation = allocator_->Allocate(device_.getBufferMemoryRequirements(frame.buffer),
+                                                    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                                                    ResourceKind::eLinear);
+            device_.bindBufferMemory(frame.buffer, frame.allocation.memory, frame.allocation.offset);
+        }
+    }
+
+    void InstanceBuffer::Destroy() {
+        for (auto &frame : frames_) {
+            device_.destroyBuffer(frame.buffer);
+            allocator_->Free(frame.allocation);
+        }
+        frames_.clear();
+    }
+
+    void InstanceBuffer::Update(uint32_t frame_slot, const std::vector<InstanceData>& instances, uint64_t version) {
+        FrameStream &frame = frames_[frame_slot];
+        if (frame.version == version) return;
+
+        if (instances.size() > max_instances_)
+            throw std::runtime_error("Instance list exceeds MAX_INSTANCES.");
+
+        std::memcpy(frame.allocation.mapped, instances.data(), instances.size() * sizeof(InstanceData));
+        frame.count = static_cast<uint32_t>(instances.size());
+        frame.version = version;
+    }
+
+    void InstanceBuffer::Bind(vk::CommandBuffer command_buffer, uint32_t frame_slot, const vk::DispatchLoaderDynamic& dispatch) const {
+        vk::Buffer instance_buff[] = {frames_[frame_slot].buffer};
+        vk::DeviceSize offsets[] = {0};
+        command_buffer.bindVertexBuffers(1, 1, instance_buff, offsets, dispatch);
+    }
+
+    uint32_t InstanceBuffer::instance_count(uint32_t frame_slot) const {
+        return frames_[frame_slot].count;
+    }
+
+    uint32_t InstanceBuffer::capacity() const {
+        return max_instances_;
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef MVK_INSTANCE_BUFFER
+#define MVK_INSTANCE_BUFFER
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "../MemoryAllocator/DeviceMemoryAllocator.h"
+#include "../ObjectLoader/ObjectLoader.h"
+
+namespace mvk {
+    // Per-instance vertex stream of the instanced pipeline. Each frame slot owns a
+    // host-visible vertex buffer that stays mapped for its whole lifetime, so filling
+    // it is a plain memcpy; the slot's in-flight fence keeps the GPU off it while it
+    // is written. Like GpuCulling::Update, a slot is only rewritten when the instance
+    // list has changed since it was last filled.
+    class InstanceBuffer {
+       public:
+        void Init(vk::Device device, DeviceMemoryAllocator& allocator, uint32_t max_instances, uint32_t frames_in_flight);
+        void Destroy();
+
+        // version changes whenever instances does; throws if instances exceeds max_instances.
+        void Update(uint32_t frame_slot, const std::vector<InstanceData>& instances, uint64_t version);
+        // Binds the slot's stream to vertex binding 1.
+        void Bind(vk::CommandBuffer command_buffer, uint32_t frame_slot, const vk::DispatchLoaderDynamic& dispatch) const;
+
+        uint32_t instance_count(uint32_t frame_slot) const;
+        uint32_t capacity() const;
+
+       private:
+        struct FrameStream {
+            vk::Buffer buffer;
+            Allocation allocation;
+            uint64_t version = UINT64_MAX;
+            uint32_t count = 0;
+        };
+
+        vk::Device device_;
+        DeviceMemoryAllocator* allocator_ = nullptr;
+        uint32_t max_instances_ = 0;
+
+        std::vector<FrameStream> frames_;
+    };
+}
+
+#endif  // MVK_INSTANCE_BUFFER
@@ -2,6 +2,7 @@
 #define MVK_CONSTANTS
 
 #include <vulkan/vulkan.hpp>
+#include "AssetPaths/AssetPaths.h"
 #include "ObjectLoader/ObjectLoader.h"
 
 namespace mvk {
@@ -14,10 +15,20 @@ namespace mvk {
         constexpr bool ENABLE_VALIDATION_LAYERS = true;
     #endif 
 
-    const std::string VERTEX_SHADER_PATH = "C:\\Coding\\Projects\\VulkanTesting\\Shaders\\VertexShader.glsl";
-    const std::string FRAGMENT_SHADER_PATH = "C:\\Coding\\Projects\\VulkanTesting\\Shaders\\FragmentShader.glsl";
-    const std::string TEXTURE_IMAGE_PATH = "C:\\Coding\\Projects\\VulkanTesting\\obamna\\obamna.jpg";
-    const std::string OBJECT_PATH = "C:\\Coding\\Projects\\VulkanTesting\\obamna\\obamna.txt";
+    // Relative to AssetPaths::Asset.
+    const std::string VERTEX_SHADER_PATH = "Shaders/VertexShader.glsl";
+    const std::string FRAGMENT_SHADER_PATH = "Shaders/FragmentShader.glsl";
+    const std::string INSTANCED_VERTEX_SHADER_PATH = "Shaders/InstancedVertexShader.glsl";
+    const std::string CULL_SHADER_PATH = "Shaders/CullShader.glsl";
+    const std::string TEXTURE_IMAGE_PATH = "obamna/obamna.jpg";
+    // Preferred over TEXTURE_IMAGE_PATH when present and usable on the device.
+    const std::string TEXTURE_KTX2_PATH = "obamna/obamna.ktx2";
+    const std::string OBJECT_PATH = "obamna/obamna.txt";
+    const std::string OBJECT_CACHE_PATH = "obamna/obamna.mvkmesh";
+    // Relative to AssetPaths::Output.
+    const std::string SHADER_CACHE_DIR = "shader_cache";
+    const std::string PIPELINE_CACHE_PATH = "pipeline.cache";
+    const std::string PROFILER_TRACE_PATH = "mvk_trace.json";
 
     const std::vector<const char*> VALIDATION_LAYERS = {
         "VK_LAYER_KHRONOS_validation",
@@ -29,6 +40,18 @@ namespace mvk {
         "VK_EXT_extended_dynamic_state3"
     };
 
+    // Enabled together when available; frame latency is measured with them.
+    const std::vector<const char*> DEVICE_PRESENT_WAIT_EXTENSIONS = {
+        VK_KHR_PRESENT_ID_EXTENSION_NAME,
+        VK_KHR_PRESENT_WAIT_EXTENSION_NAME
+    };
+
+    // Core in Vulkan 1.3; enabled on older devices that list it so pipeline creation
+    // can report pipeline cache hits.
+    const std::vector<const char*> DEVICE_CREATION_FEEDBACK_EXTENSIONS = {
+        VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME
+    };
+
     const std::vector<const char*> INSTANCE_REQUIRED_EXTENSIONS = {
         "VK_KHR_get_physical_device_properties2",
         "VK_EXT_validation_features"
@@ -40,7 +63,22 @@ namespace mvk {
         vk::DynamicState::ePolygonModeEXT
     };
 
-    constexpr uint32_t MAX_FRAMES = 2;
+    // Frames the CPU may record ahead of the GPU unless FramePacingSettings asks otherwise.
+    constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+    constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 8;
+    // Capacity of the per-frame object and indirect draw buffers.
+    constexpr uint32_t MAX_DRAW_OBJECTS = 1 << 17;
+    // Capacity of the per-frame instance stream.
+    constexpr uint32_t MAX_INSTANCES = 1 << 17;
+    // Uniform data each frame slot can hand out through dynamic offsets.
+    constexpr vk::DeviceSize UNIFORM_BYTES_PER_FRAME = 1 << 20;
+    // Capacity of the bindless table; textures are clamped to the device limits.
+    constexpr uint32_t MAX_BINDLESS_TEXTURES = 4096;
+    constexpr uint32_t MAX_MATERIALS = 4096;
+
+    // Headless mode renders into an offscreen ring instead of a swapchain, with one
+    // image more than there are frames in flight.
+    constexpr vk::Format HEADLESS_FORMAT = vk::Format::eB8G8R8A8Srgb;
     
     // const std::vector<Vertex> VERTICES = {
     //     {{-1.281770, -1.018835,  1.287239}, {1.0, 0.0, 1.0}, {0.196212, 0.507752}},
@@ -67,17 +105,6 @@ namespace mvk {
     //     {{ 1.287239, -1.018835,  1.287239}, {0.0, 0.0, 1.0}, {0.809375, 0.528434}},
     //     {{-1.281770, -1.018835,  1.287239}, {1.0, 0.0, 1.0}, {0.504687, 0.810561}}
     // };
-
-
-
-    const std::vector<uint32_t> INDICES = {
-        0, 1, 2,
-        3, 4, 5,
-        6, 7, 8,
-        9, 10, 11,
-        12, 13, 14,
-        15, 16, 17
-    };
 }
 
 #endif  // MVK_CONSTANTS
@@ -0,0 +1,387 @@
+#include "AllocationStrategy.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+static uint32_t HighestBit(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+static uint32_t LowestBit(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return index;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return alignment > 1 ? (value + alignment - 1) & ~(alignment - 1) : value;
+}
+
+namespace mvk {
+    float AllocationStatistics::Fragmentation() const {
+        if (free_bytes == 0) return 0.0f;
+        return 1.0f - static_cast<float>(largest_free_block) / static_cast<float>(free_bytes);
+    }
+
+    AllocationStatistics& AllocationStatistics::operator+=(const AllocationStatistics& other) {
+        capacity += other.capacity;
+        used_bytes += other.used_bytes;
+        free_bytes += other.free_bytes;
+        largest_free_block = std::max(largest_free_block, other.largest_free_block);
+        allocation_count += other.allocation_count;
+        free_block_count += other.free_block_count;
+        return *this;
+    }
+
+    LinearStrategy::LinearStrategy(uint64_t capacity) : capacity_(capacity) {}
+
+    uint64_t LinearStrategy::Allocate(uint64_t size, uint64_t alignment) {
+        uint64_t offset = AlignUp(head_, alignment);
+        if (offset > capacity_ || size > capacity_ - offset)
+            return INVALID_OFFSET;
+
+        head_ = offset + size;
+        used_ += size;
+        sizes_[offset] = size;
+        return offset;
+    }
+
+    void LinearStrategy::Free(uint64_t offset) {
+        auto it = sizes_.find(offset);
+        if (it == sizes_.end())
+            throw std::runtime_error("Freeing unknown linear allocation.");
+
+        used_ -= it->second;
+        sizes_.erase(it);
+        if (sizes_.empty())
+            head_ = 0;
+    }
+
+    void LinearStrategy::Reset() {
+        head_ = 0;
+        used_ = 0;
+        sizes_.clear();
+    }
+
+    AllocationStatistics LinearStrategy::GetStatistics() const {
+        AllocationStatistics stats;
+        stats.capacity = capacity_;
+        stats.used_bytes = used_;
+        stats.free_bytes = capacity_ - head_;
+        stats.largest_free_block = capacity_ - head_;
+        stats.allocation_count = static_cast<uint32_t>(sizes_.size());
+        stats.free_block_count = head_ < capacity_ ? 1 : 0;
+        return stats;
+    }
+
+    BuddyStrategy::BuddyStrategy(uint64_t capacity) {
+        capacity_ = capacity >= MIN_BLOCK_SIZE ? 1ull << HighestBit(capacity) : 0;
+        max_order_ = capacity_ ? HighestBit(capacity_ / MIN_BLOCK_SIZE) : 0;
+        free_lists_.resize(max_order_ + 1);
+        Reset();
+    }
+
+    uint64_t BuddyStrategy::BlockSize(uint32_t order) const {
+        return MIN_BLOCK_SIZE << order;
+    }
+
+    uint64_t BuddyStrategy::Allocate(uint64_t size, uint64_t alignment) {
+        uint64_t needed = std::max({size, alignment, MIN_BLOCK_SIZE});
+        if (needed > capacity_)
+            return INVALID_OFFSET;
+
+        uint32_t order = HighestBit(needed / MIN_BLOCK_SIZE);
+        if (BlockSize(order) < needed)
+            order++;
+        if (order > max_order_)
+            return INVALID_OFFSET;
+
+        uint32_t available = order;
+        while (available <= max_order_ && free_lists_[available].empty())
+            available++;
+        if (available > max_order_)
+            return INVALID_OFFSET;
+
+        uint64_t offset = *free_lists_[available].begin();
+        free_lists_[available].erase(free_lists_[available].begin());
+
+        while (available > order) {
+            available--;
+            free_lists_[available].insert(offset + BlockSize(available));
+        }
+
+        allocated_[offset] = order;
+        return offset;
+    }
+
+    void BuddyStrategy::Free(uint64_t offset) {
+        auto it = allocated_.find(offset);
+        if (it == allocated_.end())
+            throw std::runtime_error("Freeing unknown buddy allocation.");
+
+        uint32_t order = it->second;
+        allocated_.erase(it);
+
+        while (order < max_order_) {
+            uint64_t buddy = offset ^ BlockSize(order);
+            auto buddy_it = free_lists_[order].find(buddy);
+            if (buddy_it == free_lists_[order].end())
+                break;
+
+            free_lists_[order].erase(buddy_it);
+            offset = std::min(offset, buddy);
+            order++;
+        }
+
+        free_lists_[order].insert(offset);
+    }
+
+    void BuddyStrategy::Reset() {
+        for (auto &list : free_lists_)
+            list.clear();
+        allocated_.clear();
+
+        if (capacity_)
+            free_lists_[max_order_].insert(0);
+    }
+
+    AllocationStatistics BuddyStrategy::GetStatistics() const {
+        AllocationStatistics stats;
+        stats.capacity = capacity_;
+        stats.allocation_count = static_cast<uint32_t>(allocated_.size());
+
+        for (auto &[offset, order] : allocated_)
+            stats.used_bytes += BlockSize(order);
+
+        for (uint32_t order = 0; order <= max_order_; ++order) {
+            stats.free_bytes += free_lists_[order].size() * BlockSize(order);
+            stats.free_block_count += static_cast<uint32_t>(free_lists_[order].size());
+            if (!free_lists_[order].empty())
+                stats.largest_free_block = BlockSize(order);
+        }
+
+        return stats;
+    }
+
+    TlsfStrategy::TlsfStrategy(uint64_t capacity) : capacity_(capacity) {
+        Reset();
+    }
+
+    void TlsfStrategy::Mapping(uint64_t size, uint32_t& fl, uint32_t& sl) {
+        if (size < SMALL_BLOCK_SIZE) {
+            fl = 0;
+            sl = static_cast<uint32_t>(size / (SMALL_BLOCK_SIZE / SL_COUNT));
+        } else {
+            uint32_t bit = HighestBit(size);
+            sl = static_cast<uint32_t>(size >> (bit - SL_LOG2)) ^ SL_COUNT;
+            fl = bit - (FL_SHIFT - 1);
+        }
+    }
+
+    uint32_t TlsfStrategy::FindFreeBlock(uint64_t size) const {
+        // Round up to the next list boundary so any block in the list found is large enough.
+        if (size < SMALL_BLOCK_SIZE)
+            size = AlignUp(size, SMALL_BLOCK_SIZE / SL_COUNT);
+        else
+            size += (1ull << (HighestBit(size) - SL_LOG2)) - 1;
+
+        uint32_t fl, sl;
+        Mapping(size, fl, sl);
+        if (fl >= FL_COUNT)
+            return NONE;
+
+        uint32_t sl_map = sl < SL_COUNT ? sl_bitmaps_[fl] & (~0u << sl) : 0;
+        if (!sl_map) {
+            uint64_t fl_map = fl + 1 < 64 ? fl_bitmap_ & (~0ull << (fl + 1)) : 0;
+            if (!fl_map)
+                return NONE;
+
+            fl = LowestBit(fl_map);
+            sl_map = sl_bitmaps_[fl];
+        }
+
+        return heads_[fl][LowestBit(sl_map)];
+    }
+
+    void TlsfStrategy::InsertFree(uint32_t block) {
+        uint32_t fl, sl;
+        Mapping(blocks_[block].size, fl, sl);
+
+        uint32_t head = heads_[fl][sl];
+        blocks_[block].free = true;
+        blocks_[block].prev_free = NONE;
+        blocks_[block].next_free = head;
+        if (head != NONE)
+            blocks_[head].prev_free = block;
+
+        heads_[fl][sl] = block;
+        fl_bitmap_ |= 1ull << fl;
+        sl_bitmaps_[fl] |= 1u << sl;
+    }
+
+    void TlsfStrategy::RemoveFree(uint32_t block) {
+        uint32_t fl, sl;
+        Mapping(blocks_[block].size, fl, sl);
+
+        uint32_t prev = blocks_[block].prev_free;
+        uint32_t next = blocks_[block].next_free;
+        if (prev != NONE)
+            blocks_[prev].next_free = next;
+        if (next != NONE)
+            blocks_[next].prev_free = prev;
+
+        if (heads_[fl][sl] == block) {
+            heads_[fl][sl] = next;
+            if (next == NONE) {
+                sl_bitmaps_[fl] &= ~(1u << sl);
+                if (!sl_bitmaps_[fl])
+                    fl_bitmap_ &= ~(1ull << fl);
+            }
+        }
+
+        blocks_[block].free = false;
+    }
+
+    uint32_t TlsfStrategy::NewBlock(uint64_t offset, uint64_t size) {
+        Block block{offset, size, NONE, NONE, NONE, NONE, false};
+
+        if (!unused_blocks_.empty()) {
+            uint32_t index = unused_blocks_.back();
+            unused_blocks_.pop_back();
+            blocks_[index] = block;
+            return index;
+        }
+
+        blocks_.push_back(block);
+        return static_cast<uint32_t>(blocks_.size() - 1);
+    }
+
+    void TlsfStrategy::ReleaseBlock(uint32_t block) {
+        unused_blocks_.push_back(block);
+    }
+
+    uint32_t TlsfStrategy::Split(uint32_t block, uint64_t size) {
+        uint32_t rest = NewBlock(blocks_[block].offset + size, blocks_[block].size - size);
+
+        blocks_[rest].prev_physical = block;
+        blocks_[rest].next_physical = blocks_[block].next_physical;
+        if (blocks_[rest].next_physical != NONE)
+            blocks_[blocks_[rest].next_physical].prev_physical = rest;
+
+        blocks_[block].next_physical = rest;
+        blocks_[block].size = size;
+        return rest;
+    }
+
+    uint32_t TlsfStrategy::Merge(uint32_t left, uint32_t right) {
+        blocks_[left].size += blocks_[right].size;
+        blocks_[left].next_physical = blocks_[right].next_physical;
+        if (blocks_[left].next_physical != NONE)
+            blocks_[blocks_[left].next_physical].prev_physical = left;
+
+        ReleaseBlock(right);
+        return left;
+    }
+
+    uint64_t TlsfStrategy::Allocate(uint64_t size, uint64_t alignment) {
+        size = std::max<uint64_t>(size, 1);
+        uint64_t padded = size + (alignment > 1 ? alignment - 1 : 0);
+
+        uint32_t block = FindFreeBlock(padded);
+        if (block == NONE || blocks_[block].size < padded)
+            return INVALID_OFFSET;
+
+        RemoveFree(block);
+
+        uint64_t offset = AlignUp(blocks_[block].offset, alignment);
+        uint64_t padding = offset - blocks_[block].offset;
+        if (padding > 0) {
+            uint32_t aligned = Split(block, padding);
+            InsertFree(block);
+            block = aligned;
+        }
+
+        if (blocks_[block].size > size)
+            InsertFree(Split(block, size));
+
+        allocated_[offset] = block;
+        used_ += size;
+        allocation_count_++;
+        return offset;
+    }
+
+    void TlsfStrategy::Free(uint64_t offset) {
+        auto it = allocated_.find(offset);
+        if (it == allocated_.end())
+            throw std::runtime_error("Freeing unknown TLSF allocation.");
+
+        uint32_t block = it->second;
+        allocated_.erase(it);
+        used_ -= blocks_[block].size;
+        allocation_count_--;
+
+        uint32_t prev = blocks_[block].prev_physical;
+        if (prev != NONE && blocks_[prev].free) {
+            RemoveFree(prev);
+            block = Merge(prev, block);
+        }
+
+        uint32_t next = blocks_[block].next_physical;
+        if (next != NONE && blocks_[next].free) {
+            RemoveFree(next);
+            block = Merge(block, next);
+        }
+
+        InsertFree(block);
+    }
+
+    void TlsfStrategy::Reset() {
+        blocks_.clear();
+        unused_blocks_.clear();
+        allocated_.clear();
+        used_ = 0;
+        allocation_count_ = 0;
+
+        fl_bitmap_ = 0;
+        for (uint32_t fl = 0; fl < FL_COUNT; ++fl) {
+            sl_bitmaps_[fl] = 0;
+            for (uint32_t sl = 0; sl < SL_COUNT; ++sl)
+                heads_[fl][sl] = NONE;
+        }
+
+        if (capacity_ > 0)
+            InsertFree(NewBlock(0, capacity_));
+    }
+
+    AllocationStatistics TlsfStrategy::GetStatistics() const {
+        AllocationStatistics stats;
+        stats.capacity = capacity_;
+        stats.used_bytes = used_;
+        stats.allocation_count = allocation_count_;
+
+        // Block 0 always starts at offset 0: splits keep the front part and merges keep the left one.
+        for (uint32_t block = blocks_.empty() ? NONE : 0; block != NONE; block = blocks_[block].next_physical) {
+            if (!blocks_[block].free) continue;
+
+            stats.free_bytes += blocks_[block].size;
+            stats.free_block_count++;
+            stats.largest_free_block = std::max(stats.largest_free_block, blocks_[block].size);
+        }
+
+        return stats;
+    }
+}
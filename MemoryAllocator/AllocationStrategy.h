@@ -0,0 +1,130 @@
+#ifndef MVK_ALLOCATION_STRATEGY
+#define MVK_ALLOCATION_STRATEGY
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// CPU-side sub-allocation of a fixed range [0, capacity). No Vulkan types here,
+// so strategies can be exercised without a device.
+namespace mvk {
+    constexpr uint64_t INVALID_OFFSET = std::numeric_limits<uint64_t>::max();
+
+    struct AllocationStatistics {
+        uint64_t capacity = 0;
+        uint64_t used_bytes = 0;
+        uint64_t free_bytes = 0;
+        uint64_t largest_free_block = 0;
+        uint32_t allocation_count = 0;
+        uint32_t free_block_count = 0;
+
+        // 0 when all free space is one contiguous range, approaching 1 as it splinters.
+        float Fragmentation() const;
+        AllocationStatistics& operator+=(const AllocationStatistics& other);
+    };
+
+    class AllocationStrategy {
+       public:
+        virtual ~AllocationStrategy() {}
+
+        // Returns INVALID_OFFSET when the request does not fit. alignment must be a power of two.
+        virtual uint64_t Allocate(uint64_t size, uint64_t alignment) = 0;
+        virtual void Free(uint64_t offset) = 0;
+        virtual void Reset() = 0;
+        virtual AllocationStatistics GetStatistics() const = 0;
+    };
+
+    // Bump allocator. Space is reclaimed only once every allocation has been freed.
+    class LinearStrategy : public AllocationStrategy {
+       public:
+        explicit LinearStrategy(uint64_t capacity);
+
+        uint64_t Allocate(uint64_t size, uint64_t alignment) override;
+        void Free(uint64_t offset) override;
+        void Reset() override;
+        AllocationStatistics GetStatistics() const override;
+
+       private:
+        uint64_t capacity_;
+        uint64_t head_ = 0;
+        uint64_t used_ = 0;
+        std::unordered_map<uint64_t, uint64_t> sizes_;
+    };
+
+    // Power-of-two buddy allocator. Blocks are naturally aligned to their size.
+    class BuddyStrategy : public AllocationStrategy {
+       public:
+        static constexpr uint64_t MIN_BLOCK_SIZE = 256;
+
+        // capacity is rounded down to a power of two.
+        explicit BuddyStrategy(uint64_t capacity);
+
+        uint64_t Allocate(uint64_t size, uint64_t alignment) override;
+        void Free(uint64_t offset) override;
+        void Reset() override;
+        AllocationStatistics GetStatistics() const override;
+
+       private:
+        uint64_t BlockSize(uint32_t order) const;
+
+        uint64_t capacity_;
+        uint32_t max_order_;
+        std::vector<std::unordered_set<uint64_t>> free_lists_;
+        std::unordered_map<uint64_t, uint32_t> allocated_;
+    };
+
+    // Two-level segregated fit (Masmano et al. 2004): O(1) allocate and free with
+    // immediate coalescing of physically adjacent free blocks.
+    class TlsfStrategy : public AllocationStrategy {
+       public:
+        explicit TlsfStrategy(uint64_t capacity);
+
+        uint64_t Allocate(uint64_t size, uint64_t alignment) override;
+        void Free(uint64_t offset) override;
+        void Reset() override;
+        AllocationStatistics GetStatistics() const override;
+
+       private:
+        static constexpr uint32_t SL_LOG2 = 5;
+        static constexpr uint32_t SL_COUNT = 1u << SL_LOG2;
+        static constexpr uint32_t FL_SHIFT = SL_LOG2 + 3;
+        static constexpr uint64_t SMALL_BLOCK_SIZE = 1ull << FL_SHIFT;
+        static constexpr uint32_t FL_COUNT = 64 - FL_SHIFT + 1;
+        static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+        struct Block {
+            uint64_t offset;
+            uint64_t size;
+            uint32_t prev_physical;
+            uint32_t next_physical;
+            uint32_t prev_free;
+            uint32_t next_free;
+            bool free;
+        };
+
+        static void Mapping(uint64_t size, uint32_t& fl, uint32_t& sl);
+        uint32_t FindFreeBlock(uint64_t size) const;
+        void InsertFree(uint32_t block);
+        void RemoveFree(uint32_t block);
+        uint32_t NewBlock(uint64_t offset, uint64_t size);
+        void ReleaseBlock(uint32_t block);
+        uint32_t Split(uint32_t block, uint64_t size);
+        uint32_t Merge(uint32_t left, uint32_t right);
+
+        uint64_t capacity_;
+        uint64_t used_ = 0;
+        uint32_t allocation_count_ = 0;
+
+        uint64_t fl_bitmap_ = 0;
+        uint32_t sl_bitmaps_[FL_COUNT] = {};
+        uint32_t heads_[FL_COUNT][SL_COUNT];
+
+        std::vector<Block> blocks_;
+        std::vector<uint32_t> unused_blocks_;
+        std::unordered_map<uint64_t, uint32_t> allocated_;
+    };
+}
+
+#endif  // MVK_ALLOCATION_STRATEGY
@@ -0,0 +1,158 @@
+#include "DeviceMemoryAllocator.h"
+#include "../VulkanValidator/VulkanValidator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace mvk {
+    void DeviceMemoryAllocator::Init(vk::PhysicalDevice physical_device, vk::Device device, vk::DeviceSize block_size) {
+        physical_device_ = physical_device;
+        device_ = device;
+        block_size_ = block_size;
+        memory_properties_ = physical_device.getMemoryProperties();
+    }
+
+    void DeviceMemoryAllocator::Destroy() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (auto &block : blocks_)
+            DestroyBlock(block);
+
+        blocks_.clear();
+        unused_blocks_.clear();
+    }
+
+    Allocation DeviceMemoryAllocator::Allocate(const vk::MemoryRequirements& requirements,
+                                               vk::MemoryPropertyFlags properties,
+                                               ResourceKind kind,
+                                               AllocationStrategyType strategy) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        uint32_t memory_type = VulkanValidator::ChooseDeviceMemoryType(requirements.memoryTypeBits, properties, physical_device_);
+        uint32_t block_index = UINT32_MAX;
+        uint64_t offset = INVALID_OFFSET;
+
+        if (requirements.size > block_size_ / 2) {
+            block_index = CreateBlock(requirements.size, memory_type, kind, AllocationStrategyType::eLinear, true);
+            offset = blocks_[block_index].strategy->Allocate(requirements.size, requirements.alignment);
+        } else {
+            for (uint32_t i = 0; i < blocks_.size() && offset == INVALID_OFFSET; ++i) {
+                Block& block = blocks_[i];
+                if (!block.strategy || block.dedicated || block.memory_type != memory_type ||
+                    block.kind != kind || block.strategy_type != strategy)
+                    continue;
+
+                offset = block.strategy->Allocate(requirements.size, requirements.alignment);
+                block_index = i;
+            }
+
+            if (offset == INVALID_OFFSET) {
+                block_index = CreateBlock(block_size_, memory_type, kind, strategy, false);
+                offset = blocks_[block_index].strategy->Allocate(requirements.size, requirements.alignment);
+            }
+        }
+
+        if (offset == INVALID_OFFSET)
+            throw std::runtime_error("Cannot sub-allocate device memory.");
+
+        Block& block = blocks_[block_index];
+        Allocation allocation;
+        allocation.memory = block.memory;
+        allocation.offset = offset;
+        allocation.size = requirements.size;
+        allocation.mapped = block.mapped ? static_cast<uint8_t*>(block.mapped) + offset : nullptr;
+        allocation.block = block_index;
+        return allocation;
+    }
+
+    void DeviceMemoryAllocator::Free(Allocation& allocation) {
+        if (allocation.block == UINT32_MAX) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        Block& block = blocks_[allocation.block];
+        block.strategy->Free(allocation.offset);
+
+        if (block.dedicated) {
+            DestroyBlock(block);
+            unused_blocks_.push_back(allocation.block);
+        }
+
+        allocation = Allocation{};
+    }
+
+    AllocatorStatistics DeviceMemoryAllocator::GetStatistics() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        AllocatorStatistics stats;
+        for (auto &block : blocks_) {
+            if (!block.strategy) continue;
+
+            AllocationStatistics block_stats = block.strategy->GetStatistics();
+            stats.total += block_stats;
+            stats.blocks.push_back(block_stats);
+        }
+
+        stats.block_count = static_cast<uint32_t>(stats.blocks.size());
+        stats.device_allocation_count = stats.block_count;
+        stats.device_bytes = device_bytes_;
+        stats.peak_device_bytes = peak_device_bytes_;
+        return stats;
+    }
+
+    uint32_t DeviceMemoryAllocator::CreateBlock(vk::DeviceSize size, uint32_t memory_type, ResourceKind kind, AllocationStrategyType strategy, bool dedicated) {
+        vk::MemoryAllocateInfo alloc_info{};
+        alloc_info.sType = vk::StructureType::eMemoryAllocateInfo;
+        alloc_info.setAllocationSize(size);
+        alloc_info.setMemoryTypeIndex(memory_type);
+
+        Block block;
+        block.memory = device_.allocateMemory(alloc_info);
+        block.size = size;
+        block.memory_type = memory_type;
+        block.kind = kind;
+        block.strategy_type = strategy;
+        block.dedicated = dedicated;
+
+        device_bytes_ += size;
+        peak_device_bytes_ = std::max(peak_device_bytes_, device_bytes_);
+
+        if (memory_properties_.memoryTypes[memory_type].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)
+            block.mapped = device_.mapMemory(block.memory, 0, VK_WHOLE_SIZE);
+
+        switch (strategy) {
+            case AllocationStrategyType::eLinear:
+                block.strategy = std::make_unique<LinearStrategy>(size);
+                break;
+            case AllocationStrategyType::eBuddy:
+                block.strategy = std::make_unique<BuddyStrategy>(size);
+                break;
+            case AllocationStrategyType::eTlsf:
+                block.strategy = std::make_unique<TlsfStrategy>(size);
+                break;
+        }
+
+        if (!unused_blocks_.empty()) {
+            uint32_t index = unused_blocks_.back();
+            unused_blocks_.pop_back();
+            blocks_[index] = std::move(block);
+            return index;
+        }
+
+        blocks_.push_back(std::move(block));
+        return static_cast<uint32_t>(blocks_.size() - 1);
+    }
+
+    void DeviceMemoryAllocator::DestroyBlock(Block& block) {
+        if (!block.strategy) return;
+
+        if (block.mapped)
+            device_.unmapMemory(block.memory);
+        device_.freeMemory(block.memory);
+        device_bytes_ -= block.size;
+
+        block.memory = nullptr;
+        block.mapped = nullptr;
+        block.strategy.reset();
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef MVK_DEVICE_MEMORY_ALLOCATOR
+#define MVK_DEVICE_MEMORY_ALLOCATOR
+
+#include <vulkan/vulkan.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "AllocationStrategy.h"
+
+namespace mvk {
+    enum class AllocationStrategyType {
+        eLinear,
+        eBuddy,
+        eTlsf
+    };
+
+    // Buffers and linear images versus optimal-tiling images. The two kinds never share a
+    // block, which keeps them bufferImageGranularity apart without per-allocation padding.
+    enum class ResourceKind {
+        eLinear,
+        eOptimal
+    };
+
+    struct Allocation {
+        vk::DeviceMemory memory;
+        vk::DeviceSize offset = 0;
+        vk::DeviceSize size = 0;
+        void* mapped = nullptr;
+        uint32_t block = UINT32_MAX;
+    };
+
+    struct AllocatorStatistics {
+        uint32_t block_count = 0;
+        uint32_t device_allocation_count = 0;
+        // vkAllocateMemory totals, including unused space inside blocks.
+        uint64_t device_bytes = 0;
+        uint64_t peak_device_bytes = 0;
+        AllocationStatistics total;
+        std::vector<AllocationStatistics> blocks;
+    };
+
+    // Hands out ranges of large vk::DeviceMemory blocks, one set of blocks per
+    // (memory type, resource kind, strategy). Host-visible blocks stay mapped.
+    class DeviceMemoryAllocator {
+       public:
+        static constexpr vk::DeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+        void Init(vk::PhysicalDevice physical_device, vk::Device device, vk::DeviceSize block_size = DEFAULT_BLOCK_SIZE);
+        void Destroy();
+
+        Allocation Allocate(const vk::MemoryRequirements& requirements,
+                            vk::MemoryPropertyFlags properties,
+                            ResourceKind kind,
+                            AllocationStrategyType strategy = AllocationStrategyType::eTlsf);
+        void Free(Allocation& allocation);
+
+        AllocatorStatistics GetStatistics();
+
+       private:
+        struct Block {
+            vk::DeviceMemory memory;
+            vk::DeviceSize size = 0;
+            uint32_t memory_type = 0;
+            ResourceKind kind = ResourceKind::eLinear;
+            AllocationStrategyType strategy_type = AllocationStrategyType::eTlsf;
+            bool dedicated = false;
+            void* mapped = nullptr;
+            std::unique_ptr<AllocationStrategy> strategy;
+        };
+
+        uint32_t CreateBlock(vk::DeviceSize size, uint32_t memory_type, ResourceKind kind, AllocationStrategyType strategy, bool dedicated);
+        void DestroyBlock(Block& block);
+
+        vk::PhysicalDevice physical_device_;
+        vk::Device device_;
+        vk::DeviceSize block_size_ = DEFAULT_BLOCK_SIZE;
+        vk::PhysicalDeviceMemoryProperties memory_properties_;
+
+        std::vector<Block> blocks_;
+        std::vector<uint32_t> unused_blocks_;
+        uint64_t device_bytes_ = 0;
+        uint64_t peak_device_bytes_ = 0;
+        std::mutex mutex_;
+    };
+}
+
+#endif  // MVK_DEVICE_MEMORY_ALLOCATOR
@@ -0,0 +1,252 @@
+#include "MeshCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include "../Fnv1a/Fnv1a.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Written so that neither side can wrap around.
+static bool SectionFits(uint64_t offset, uint64_t size, uint64_t file_size) {
+    return offset <= file_size && size <= file_size - offset;
+}
+
+static bool IsArraySize(uint64_t size, uint64_t count, uint64_t element_size) {
+    return element_size != 0 && size % element_size == 0 && size / element_size == count;
+}
+
+static uint64_t HeaderChecksum(mvk::MeshFileHeader header) {
+    header.checksum = 0;
+    return mvk::Fnv1a::Hash(&header, sizeof(header));
+}
+
+namespace mvk {
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this == &other) return *this;
+
+        Close();
+    #ifdef _WIN32
+        std::swap(file_, other.file_);
+        std::swap(mapping_, other.mapping_);
+    #else
+        std::swap(fd_, other.fd_);
+    #endif
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    void MappedFile::Open(const std::string& path) {
+        Close();
+
+    #ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            file_ = nullptr;
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_, &file_size)) {
+            Close();
+            throw std::runtime_error("Cannot get size of file: " + path);
+        }
+        size_ = static_cast<size_t>(file_size.QuadPart);
+        if (size_ == 0) return;
+
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ == nullptr) {
+            Close();
+            throw std::runtime_error("Cannot map file: " + path);
+        }
+
+        data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    #else
+        fd_ = open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+            throw std::runtime_error("Cannot open file: " + path);
+
+        struct stat st;
+        if (fstat(fd_, &st) != 0) {
+            Close();
+            throw std::runtime_error("Cannot get size of file: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0) return;
+
+        void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (mapped != MAP_FAILED) {
+            madvise(mapped, size_, MADV_WILLNEED);
+            data_ = static_cast<const uint8_t*>(mapped);
+        }
+    #endif
+
+        if (data_ == nullptr) {
+            Close();
+            throw std::runtime_error("Cannot map file: " + path);
+        }
+    }
+
+    void MappedFile::Close() {
+    #ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_) CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = nullptr;
+    #else
+        if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+        if (fd_ >= 0) close(fd_);
+        fd_ = -1;
+    #endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    bool MappedFile::is_open() const {
+        return data_ != nullptr;
+    }
+
+    const uint8_t* MappedFile::data() const {
+        return data_;
+    }
+
+    size_t MappedFile::size() const {
+        return size_;
+    }
+
+    void MeshCache::Write(const std::string& path,
+                          const void* vertices, uint64_t vertex_count, uint32_t vertex_stride,
+                          const std::vector<vk::VertexInputAttributeDescription>& attributes,
+                          const std::vector<uint32_t>& indices,
+                          const PositionQuantization& quantization) {
+        std::vector<MeshFileAttribute> file_attributes;
+        for (auto& attribute : attributes)
+            file_attributes.push_back({attribute.location, static_cast<uint32_t>(attribute.format), attribute.offset, 0});
+
+        MeshFileHeader header{};
+        header.magic = MESH_FILE_MAGIC;
+        header.version = MESH_FILE_VERSION;
+        header.header_size = sizeof(MeshFileHeader);
+        header.vertex_count = vertex_count;
+        header.index_count = indices.size();
+        header.vertex_stride = vertex_stride;
+        header.index_size = sizeof(uint32_t);
+        header.attribute_count = static_cast<uint32_t>(file_attributes.size());
+
+        header.attributes_offset = AlignUp(sizeof(MeshFileHeader), MESH_FILE_ALIGNMENT);
+        header.vertex_data_offset = AlignUp(header.attributes_offset + file_attributes.size() * sizeof(MeshFileAttribute), MESH_FILE_ALIGNMENT);
+        header.vertex_data_size = vertex_count * vertex_stride;
+        header.index_data_offset = AlignUp(header.vertex_data_offset + header.vertex_data_size, MESH_FILE_ALIGNMENT);
+        header.index_data_size = indices.size() * sizeof(uint32_t);
+
+        for (int i = 0; i < 3; ++i) {
+            header.position_offset[i] = quantization.offset[i];
+            header.position_scale[i] = quantization.scale[i];
+        }
+
+        uint64_t checksum = HeaderChecksum(header);
+        checksum = Fnv1a::Hash(file_attributes.data(), file_attributes.size() * sizeof(MeshFileAttribute), checksum);
+        checksum = Fnv1a::Hash(vertices, header.vertex_data_size, checksum);
+        header.checksum = Fnv1a::Hash(indices.data(), header.index_data_size, checksum);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            throw std::runtime_error("Cannot open file for writing: " + path);
+
+        const char padding[MESH_FILE_ALIGNMENT] = {};
+        auto write_section = [&](uint64_t offset, const void* data, uint64_t size) {
+            uint64_t position = static_cast<uint64_t>(file.tellp());
+            file.write(padding, offset - position);
+            file.write(static_cast<const char*>(data), size);
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write_section(header.attributes_offset, file_attributes.data(), file_attributes.size() * sizeof(MeshFileAttribute));
+        write_section(header.vertex_data_offset, vertices, header.vertex_data_size);
+        write_section(header.index_data_offset, indices.data(), header.index_data_size);
+
+        if (!file.good())
+            throw std::runtime_error("Failed to write mesh cache: " + path);
+    }
+
+    MeshView MeshCache::Open(const MappedFile& file) {
+        if (file.size() < sizeof(MeshFileHeader))
+            throw std::runtime_error("Mesh cache is truncated.");
+
+        MeshView view;
+        view.header = reinterpret_cast<const MeshFileHeader*>(file.data());
+        const MeshFileHeader& header = *view.header;
+
+        if (header.magic != MESH_FILE_MAGIC)
+            throw std::runtime_error("Mesh cache has wrong magic.");
+        if (header.version != MESH_FILE_VERSION || header.header_size != sizeof(MeshFileHeader))
+            throw std::runtime_error("Mesh cache version " + std::to_string(header.version) + " is not supported.");
+        if (header.index_size != sizeof(uint32_t))
+            throw std::runtime_error("Mesh cache has unsupported index size.");
+
+        uint64_t attributes_size = header.attribute_count * sizeof(MeshFileAttribute);
+        if (!SectionFits(header.attributes_offset, attributes_size, file.size()) ||
+            !SectionFits(header.vertex_data_offset, header.vertex_data_size, file.size()) ||
+            !SectionFits(header.index_data_offset, header.index_data_size, file.size()) ||
+            !IsArraySize(header.vertex_data_size, header.vertex_count, header.vertex_stride) ||
+            !IsArraySize(header.index_data_size, header.index_count, header.index_size) ||
+            header.attributes_offset % MESH_FILE_ALIGNMENT != 0 ||
+            header.vertex_data_offset % MESH_FILE_ALIGNMENT != 0 ||
+            header.index_data_offset % MESH_FILE_ALIGNMENT != 0)
+            throw std::runtime_error("Mesh cache sections are out of bounds.");
+
+        view.attributes = reinterpret_cast<const MeshFileAttribute*>(file.data() + header.attributes_offset);
+        view.vertices = file.data() + header.vertex_data_offset;
+        view.indices = reinterpret_cast<const uint32_t*>(file.data() + header.index_data_offset);
+
+        uint64_t checksum = HeaderChecksum(header);
+        checksum = Fnv1a::Hash(view.attributes, attributes_size, checksum);
+        checksum = Fnv1a::Hash(view.vertices, header.vertex_data_size, checksum);
+        checksum = Fnv1a::Hash(view.indices, header.index_data_size, checksum);
+        if (checksum != header.checksum)
+            throw std::runtime_error("Mesh cache checksum mismatch.");
+
+        return view;
+    }
+
+    bool MeshCache::MatchesLayout(const MeshView& view, uint32_t vertex_stride,
+                                  const std::vector<vk::VertexInputAttributeDescription>& attributes) {
+        if (view.header->vertex_stride != vertex_stride || view.header->attribute_count != attributes.size())
+            return false;
+
+        for (size_t i = 0; i < attributes.size(); ++i) {
+            const MeshFileAttribute& attribute = view.attributes[i];
+            if (attribute.location != attributes[i].location ||
+                attribute.format != static_cast<uint32_t>(attributes[i].format) ||
+                attribute.offset != attributes[i].offset)
+                return false;
+        }
+
+        return true;
+    }
+}
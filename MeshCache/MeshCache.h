@@ -0,0 +1,108 @@
+#ifndef MVK_MESH_CACHE
+#define MVK_MESH_CACHE
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mvk {
+    // On-disk layout: MeshFileHeader, attribute descriptors, vertex blob, index blob.
+    // Every section starts on a MESH_FILE_ALIGNMENT boundary so a mapped file can be
+    // read in place. All fields are little-endian. The checksum covers the header (with
+    // the checksum field zeroed) and every section.
+    constexpr uint32_t MESH_FILE_MAGIC = 0x4D4B564D;  // "MVKM"
+    constexpr uint32_t MESH_FILE_VERSION = 3;
+    constexpr uint64_t MESH_FILE_ALIGNMENT = 16;
+
+    struct MeshFileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t header_size;
+        uint32_t flags;
+
+        uint64_t vertex_count;
+        uint64_t index_count;
+        uint32_t vertex_stride;
+        uint32_t index_size;
+        uint32_t attribute_count;
+        uint32_t reserved;
+
+        uint64_t attributes_offset;
+        uint64_t vertex_data_offset;
+        uint64_t vertex_data_size;
+        uint64_t index_data_offset;
+        uint64_t index_data_size;
+
+        float position_offset[3];
+        float position_scale[3];
+
+        uint64_t checksum;
+    };
+
+    // Object space position = stored position * scale + offset.
+    struct PositionQuantization {
+        float offset[3] = {0.0f, 0.0f, 0.0f};
+        float scale[3] = {1.0f, 1.0f, 1.0f};
+    };
+
+    struct MeshFileAttribute {
+        uint32_t location;
+        uint32_t format;
+        uint32_t offset;
+        uint32_t reserved;
+    };
+
+    class MappedFile {
+       public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        void Open(const std::string& path);
+        void Close();
+
+        bool is_open() const;
+        const uint8_t* data() const;
+        size_t size() const;
+
+       private:
+    #ifdef _WIN32
+        void* file_ = nullptr;
+        void* mapping_ = nullptr;
+    #else
+        int fd_ = -1;
+    #endif
+        const uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    struct MeshView {
+        const MeshFileHeader* header = nullptr;
+        const MeshFileAttribute* attributes = nullptr;
+        const void* vertices = nullptr;
+        const uint32_t* indices = nullptr;
+    };
+
+    class MeshCache {
+       public:
+        static void Write(const std::string& path,
+                          const void* vertices, uint64_t vertex_count, uint32_t vertex_stride,
+                          const std::vector<vk::VertexInputAttributeDescription>& attributes,
+                          const std::vector<uint32_t>& indices,
+                          const PositionQuantization& quantization);
+
+        // Validates the mapped file and returns pointers into it. Throws on any mismatch.
+        static MeshView Open(const MappedFile& file);
+
+        static bool MatchesLayout(const MeshView& view, uint32_t vertex_stride,
+                                  const std::vector<vk::VertexInputAttributeDescription>& attributes);
+    };
+}
+
+#endif  // MVK_MESH_CACHE
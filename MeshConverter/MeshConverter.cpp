@@ -0,0 +1,42 @@
+#include <iostream>
+
+#include "../ObjectLoader/ObjectLoader.h"
+#include "../MeshCache/MeshCache.h"
+#include "../VertexLayout/VertexLayout.h"
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.txt> <output.mvkmesh>\n";
+        return -1;
+    }
+
+    try {
+        mvk::ObjectLoader loader;
+        loader.LoadObject(argv[1]);
+
+        mvk::MeshCache::Write(argv[2],
+                              loader.vertex_data(),
+                              loader.object.size(),
+                              mvk::ActiveVertexLayout::STRIDE,
+                              mvk::ObjectLoader::GetVerticesAttributeDescription(),
+                              loader.indices,
+                              loader.quantization());
+
+        const mvk::MeshOptimizationStats& stats = loader.optimization_stats();
+        std::cout << "Converted " << loader.object.size() << " vertices, " << loader.indices.size() << " indices.\n"
+                  << "ACMR " << stats.before.acmr << " -> " << stats.after.acmr
+                  << ", ATVR " << stats.before.atvr << " -> " << stats.after.atvr
+                  << ", " << stats.before.memory_bytes << " -> " << stats.after.memory_bytes << " bytes\n";
+
+        const mvk::QuantizationReport& report = loader.quantization_report();
+        std::cout << "Vertex layout " << report.source_bytes << " -> " << report.packed_bytes << " bytes"
+                  << ", max error position " << report.position_error << " (bound " << report.position_bound << ")"
+                  << ", color " << report.color_error << " (bound " << report.color_bound << ")"
+                  << ", uv " << report.uv_error << " (bound " << report.uv_bound << ")\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include "MeshOptimizer.h"
+
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+#include "../Fnv1a/Fnv1a.h"
+
+namespace {
+    struct VertexHash {
+        size_t operator()(const mvk::Vertex& vertex) const {
+            return static_cast<size_t>(mvk::Fnv1a::Hash(&vertex, sizeof(mvk::Vertex)));
+        }
+    };
+
+    struct VertexEqual {
+        bool operator()(const mvk::Vertex& a, const mvk::Vertex& b) const {
+            return std::memcmp(&a, &b, sizeof(mvk::Vertex)) == 0;
+        }
+    };
+
+    constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+}
+
+namespace mvk {
+    MeshOptimizationStats MeshOptimizer::Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        MeshOptimizationStats stats;
+
+        std::vector<uint32_t> unindexed(vertices.size());
+        for (uint32_t i = 0; i < unindexed.size(); ++i)
+            unindexed[i] = i;
+        stats.before = AnalyzeVertexCache(unindexed, vertices.size());
+
+        indices = WeldVertices(vertices);
+        OptimizeVertexCache(indices, vertices.size());
+        OptimizeVertexFetch(vertices, indices);
+
+        stats.after = AnalyzeVertexCache(indices, vertices.size());
+        return stats;
+    }
+
+    std::vector<uint32_t> MeshOptimizer::WeldVertices(std::vector<Vertex>& vertices) {
+        std::unordered_map<Vertex, uint32_t, VertexHash, VertexEqual> unique;
+        unique.reserve(vertices.size());
+
+        std::vector<uint32_t> indices(vertices.size());
+        uint32_t next = 0;
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            auto [it, inserted] = unique.try_emplace(vertices[i], next);
+            if (inserted)
+                vertices[next++] = vertices[i];
+            indices[i] = it->second;
+        }
+
+        vertices.resize(next);
+        return indices;
+    }
+
+    void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size) {
+        size_t triangle_count = indices.size() / 3;
+        if (triangle_count == 0) return;
+
+        // Vertex -> triangle adjacency in CSR form. Trailing indices that do not form a
+        // whole triangle are dropped; counting them would leave vertices that never die.
+        indices.resize(triangle_count * 3);
+        std::vector<uint32_t> live(vertex_count, 0);
+        for (uint32_t index : indices)
+            live[index]++;
+
+        std::vector<uint32_t> offsets(vertex_count + 1, 0);
+        for (size_t v = 0; v < vertex_count; ++v)
+            offsets[v + 1] = offsets[v] + live[v];
+
+        std::vector<uint32_t> adjacency(offsets[vertex_count]);
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triangle_count; ++t)
+            for (size_t k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+
+        std::vector<uint32_t> cache_time(vertex_count, 0);
+        std::vector<bool> emitted(triangle_count, false);
+        std::vector<uint32_t> dead_end;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+
+        uint32_t time = cache_size + 1;
+        size_t cursor = 0;
+        int64_t fanning = 0;
+
+        while (fanning >= 0) {
+            candidates.clear();
+
+            for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; ++a) {
+                uint32_t t = adjacency[a];
+                if (emitted[t]) continue;
+
+                for (size_t k = 0; k < 3; ++k) {
+                    uint32_t v = indices[t * 3 + k];
+                    result.push_back(v);
+                    dead_end.push_back(v);
+                    candidates.push_back(v);
+                    live[v]--;
+
+                    if (time - cache_time[v] > cache_size)
+                        cache_time[v] = time++;
+                }
+                emitted[t] = true;
+            }
+
+            // Prefer a candidate that is still in the cache and will stay there while its fan is emitted.
+            int64_t best = -1;
+            int64_t best_priority = -1;
+            for (uint32_t v : candidates) {
+                if (live[v] == 0) continue;
+
+                int64_t priority = 0;
+                if (time - cache_time[v] + 2 * live[v] <= cache_size)
+                    priority = time - cache_time[v];
+
+                if (priority > best_priority) {
+                    best_priority = priority;
+                    best = v;
+                }
+            }
+
+            if (best == -1) {
+                while (!dead_end.empty()) {
+                    uint32_t v = dead_end.back();
+                    dead_end.pop_back();
+                    if (live[v] > 0) {
+                        best = v;
+                        break;
+                    }
+                }
+            }
+
+            if (best == -1) {
+                while (cursor < vertex_count && live[cursor] == 0)
+                    cursor++;
+                if (cursor < vertex_count)
+                    best = static_cast<int64_t>(cursor);
+            }
+
+            fanning = best;
+        }
+
+        indices.swap(result);
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        std::vector<uint32_t> remap(vertices.size(), INVALID_INDEX);
+        std::vector<Vertex> reordered;
+        reordered.reserve(vertices.size());
+
+        for (uint32_t& index : indices) {
+            if (remap[index] == INVALID_INDEX) {
+                remap[index] = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+
+        vertices.swap(reordered);
+    }
+
+    VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size) {
+        VertexCacheStats stats;
+        stats.vertex_count = static_cast<uint32_t>(vertex_count);
+        stats.index_count = static_cast<uint32_t>(indices.size());
+        stats.memory_bytes = vertex_count * sizeof(Vertex) + indices.size() * sizeof(uint32_t);
+
+        if (indices.size() < 3) return stats;
+
+        // A vertex is resident if it entered the FIFO fewer than cache_size misses ago.
+        std::vector<uint64_t> inserted_at(vertex_count, 0);
+        std::vector<bool> referenced(vertex_count, false);
+        uint64_t misses = 0;
+        uint32_t unique = 0;
+
+        for (uint32_t index : indices) {
+            if (!referenced[index]) {
+                referenced[index] = true;
+                unique++;
+            }
+
+            if (inserted_at[index] == 0 || misses - inserted_at[index] + 1 > cache_size) {
+                misses++;
+                inserted_at[index] = misses;
+            }
+        }
+
+        stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+        stats.atvr = static_cast<float>(misses) / static_cast<float>(unique);
+        return stats;
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef MVK_MESH_OPTIMIZER
+#define MVK_MESH_OPTIMIZER
+
+#include <cstdint>
+#include <vector>
+
+#include "../ObjectLoader/ObjectLoader.h"
+
+namespace mvk {
+    constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+    class MeshOptimizer {
+       public:
+        // Welds, reorders triangles for the post-transform cache and reorders vertices for fetch.
+        // vertices is treated as an unindexed triangle list on input.
+        static MeshOptimizationStats Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+        // Merges bitwise identical vertices in place and returns the matching index buffer.
+        static std::vector<uint32_t> WeldVertices(std::vector<Vertex>& vertices);
+
+        // Tipsify (Sander, Nehab, Barczak 2007): linear time triangle reordering.
+        // A trailing partial triangle is dropped.
+        static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size = VERTEX_CACHE_SIZE);
+
+        // Renumbers vertices in first-use order and drops unreferenced ones.
+        static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+        // Simulates a FIFO post-transform cache of cache_size entries.
+        static VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size = VERTEX_CACHE_SIZE);
+    };
+}
+
+#endif  // MVK_MESH_OPTIMIZER
@@ -0,0 +1,120 @@
+#include "MeshParser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+static constexpr size_t MIN_CHUNK_SIZE = 256 * 1024;
+static constexpr int VALUES_PER_VERTEX = 8;
+
+static bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+static bool IsBlank(const char* begin, const char* end) {
+    for (const char* c = begin; c < end; ++c)
+        if (!IsSpace(*c))
+            return false;
+    return true;
+}
+
+static const char* FindLineEnd(const char* begin, const char* end) {
+    const char* eol = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    return eol ? eol : end;
+}
+
+static std::runtime_error ParseError(const std::string& name, size_t line, size_t column, const std::string& message) {
+    return std::runtime_error(name + ":" + std::to_string(line) + ":" + std::to_string(column) + ": " + message);
+}
+
+namespace mvk {
+    void MeshParser::Parse(const char* data, size_t size, const std::string& name, std::vector<Vertex>& vertices, ThreadPool& pool) {
+        size_t chunk_count = std::min(size / MIN_CHUNK_SIZE, pool.thread_count() * 4);
+        std::vector<Chunk> chunks = SplitChunks(data, size, std::max<size_t>(chunk_count, 1));
+
+        pool.ParallelFor(chunks.size(), [&chunks](size_t i) { CountChunk(chunks[i]); });
+
+        size_t line = 0, vertex = 0;
+        for (auto &chunk : chunks) {
+            chunk.first_line = line;
+            chunk.first_vertex = vertex;
+            line += chunk.line_count;
+            vertex += chunk.vertex_count;
+        }
+
+        vertices.resize(vertex);
+        pool.ParallelFor(chunks.size(), [&](size_t i) { ParseChunk(chunks[i], name, vertices.data()); });
+
+        if (vertex % 3 != 0)
+            throw ParseError(name, line, 1, std::to_string(vertex) + " vertices do not form whole triangles.");
+    }
+
+    std::vector<MeshParser::Chunk> MeshParser::SplitChunks(const char* data, size_t size, size_t chunk_count) {
+        std::vector<Chunk> chunks;
+        const char* end = data + size;
+        const char* begin = data;
+
+        for (size_t i = 0; i < chunk_count && begin < end; ++i) {
+            const char* split = (i + 1 == chunk_count) ? end : std::max(begin, data + size * (i + 1) / chunk_count);
+            if (split < end)
+                split = std::min(FindLineEnd(split, end) + 1, end);
+
+            if (split > begin) {
+                chunks.push_back({begin, split, 0, 0, 0, 0});
+                begin = split;
+            }
+        }
+
+        return chunks;
+    }
+
+    void MeshParser::CountChunk(Chunk& chunk) {
+        for (const char* line = chunk.begin; line < chunk.end;) {
+            const char* eol = FindLineEnd(line, chunk.end);
+
+            chunk.line_count++;
+            if (!IsBlank(line, eol))
+                chunk.vertex_count++;
+
+            line = eol + 1;
+        }
+    }
+
+    void MeshParser::ParseChunk(const Chunk& chunk, const std::string& name, Vertex* vertices) {
+        Vertex* out = vertices + chunk.first_vertex;
+        size_t line_number = chunk.first_line;
+
+        for (const char* line = chunk.begin; line < chunk.end;) {
+            const char* eol = FindLineEnd(line, chunk.end);
+            line_number++;
+
+            float values[VALUES_PER_VERTEX];
+            int count = 0;
+            const char* c = line;
+
+            while (true) {
+                while (c < eol && IsSpace(*c)) ++c;
+                if (c == eol) break;
+
+                if (count == VALUES_PER_VERTEX)
+                    throw ParseError(name, line_number, c - line + 1, "too many values, expected 8.");
+
+                auto [next, ec] = std::from_chars(c, eol, values[count]);
+                if (ec != std::errc() || (next < eol && !IsSpace(*next)))
+                    throw ParseError(name, line_number, c - line + 1, "invalid number.");
+
+                c = next;
+                count++;
+            }
+
+            if (count != 0 && count != VALUES_PER_VERTEX)
+                throw ParseError(name, line_number, c - line + 1, "expected 8 values, found " + std::to_string(count) + ".");
+
+            if (count == VALUES_PER_VERTEX)
+                *out++ = {{values[0], values[1], values[2]}, {values[3], values[4], values[5]}, {values[6], values[7]}};
+
+            line = eol + 1;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef MVK_MESH_PARSER
+#define MVK_MESH_PARSER
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "../ObjectLoader/ObjectLoader.h"
+#include "../ThreadPool/ThreadPool.h"
+
+namespace mvk {
+    // Parses the text mesh format: one vertex per line, eight whitespace separated
+    // numbers (position xyz, color rgb, uv). Blank lines are skipped. Every three
+    // vertices form a triangle, so the vertex count has to be a multiple of 3.
+    //
+    // The input is split into line-aligned chunks that are counted and then parsed
+    // in parallel straight into the output vector, without per-line allocations.
+    // Malformed rows throw std::runtime_error with "name:line:column: message".
+    class MeshParser {
+       public:
+        static void Parse(const char* data, size_t size, const std::string& name, std::vector<Vertex>& vertices, ThreadPool& pool);
+
+       private:
+        struct Chunk {
+            const char* begin;
+            const char* end;
+            size_t first_line;
+            size_t first_vertex;
+            size_t line_count;
+            size_t vertex_count;
+        };
+
+        static std::vector<Chunk> SplitChunks(const char* data, size_t size, size_t chunk_count);
+        static void CountChunk(Chunk& chunk);
+        static void ParseChunk(const Chunk& chunk, const std::string& name, Vertex* vertices);
+    };
+}
+
+#endif  // MVK_MESH_PARSER
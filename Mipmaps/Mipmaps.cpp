@@ -0,0 +1,104 @@
+#include "Mipmaps.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+static float SrgbToLinear(float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float LinearToSrgb(float value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+static const std::array<float, 256>& SrgbTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values{};
+        for (int i = 0; i < 256; ++i)
+            values[i] = SrgbToLinear(i / 255.0f);
+        return values;
+    }();
+    return table;
+}
+
+namespace mvk {
+    uint32_t Mipmaps::LevelCount(uint32_t width, uint32_t height) {
+        uint32_t size = std::max(width, height);
+        uint32_t levels = 1;
+        while (size > 1) {
+            size >>= 1;
+            ++levels;
+        }
+        return levels;
+    }
+
+    std::vector<MipLevel> Mipmaps::DownsampleRGBA8(const uint8_t* pixels, uint32_t width, uint32_t height,
+                                                   uint32_t level_count, bool srgb) {
+        if (level_count == 0)
+            throw std::runtime_error("A mip chain needs at least one level.");
+
+        const auto& to_linear = SrgbTable();
+
+        std::vector<MipLevel> levels(level_count);
+        levels[0].width = width;
+        levels[0].height = height;
+        levels[0].pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+
+        for (uint32_t level = 1; level < level_count; ++level) {
+            const MipLevel& src = levels[level - 1];
+            MipLevel& dst = levels[level];
+            dst.width = std::max(src.width / 2, 1u);
+            dst.height = std::max(src.height / 2, 1u);
+            dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height * 4);
+
+            for (uint32_t y = 0; y < dst.height; ++y) {
+                // The last row/column of an odd source folds into the last destination texel,
+                // which then averages a 3 texel wide footprint; 1 texel sources keep their one.
+                uint32_t y_begin = std::min(y * 2, src.height - 1);
+                uint32_t y_end = y + 1 == dst.height ? src.height : y * 2 + 2;
+                for (uint32_t x = 0; x < dst.width; ++x) {
+                    uint32_t x_begin = std::min(x * 2, src.width - 1);
+                    uint32_t x_end = x + 1 == dst.width ? src.width : x * 2 + 2;
+                    uint32_t count = (y_end - y_begin) * (x_end - x_begin);
+
+                    float linear[3] = {};
+                    uint32_t sum[4] = {};
+                    for (uint32_t sy = y_begin; sy < y_end; ++sy) {
+                        for (uint32_t sx = x_begin; sx < x_end; ++sx) {
+                            const uint8_t* texel = &src.pixels[(static_cast<size_t>(sy) * src.width + sx) * 4];
+                            for (int c = 0; c < 4; ++c) {
+                                // Alpha is always linear.
+                                if (srgb && c < 3)
+                                    linear[c] += to_linear[texel[c]];
+                                else
+                                    sum[c] += texel[c];
+                            }
+                        }
+                    }
+
+                    uint8_t* out = &dst.pixels[(static_cast<size_t>(y) * dst.width + x) * 4];
+                    for (int c = 0; c < 4; ++c) {
+                        if (srgb && c < 3)
+                            out[c] = static_cast<uint8_t>(LinearToSrgb(linear[c] / count) * 255.0f + 0.5f);
+                        else
+                            out[c] = static_cast<uint8_t>((sum[c] + count / 2) / count);
+                    }
+                }
+            }
+        }
+
+        return levels;
+    }
+
+    uint64_t Mipmaps::ChainSize(uint32_t width, uint32_t height, uint32_t level_count, uint32_t texel_size) {
+        uint64_t size = 0;
+        for (uint32_t level = 0; level < level_count; ++level) {
+            size += static_cast<uint64_t>(width) * height * texel_size;
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+        return size;
+    }
+}
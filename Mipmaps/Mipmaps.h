@@ -0,0 +1,32 @@
+#ifndef MVK_MIPMAPS
+#define MVK_MIPMAPS
+
+#include <cstdint>
+#include <vector>
+
+namespace mvk {
+    // One level of a CPU generated chain, tightly packed RGBA8.
+    struct MipLevel {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    class Mipmaps {
+       public:
+        // floor(log2(max(width, height))) + 1, down to a 1x1 level.
+        static uint32_t LevelCount(uint32_t width, uint32_t height);
+
+        // A 2x2 box filter per level, run on the decode threads; along an odd edge the last
+        // texels average 3 source texels so none are dropped.
+        // sRGB texels are averaged in linear space so the chain does not darken.
+        // levels[0] is a copy of pixels. Throws when level_count is 0.
+        static std::vector<MipLevel> DownsampleRGBA8(const uint8_t* pixels, uint32_t width, uint32_t height,
+                                                     uint32_t level_count, bool srgb);
+
+        // Bytes taken by level_count levels of a width x height image.
+        static uint64_t ChainSize(uint32_t width, uint32_t height, uint32_t level_count, uint32_t texel_size);
+    };
+}
+
+#endif  // MVK_MIPMAPS
@@ -1,48 +1,133 @@
 #include "ObjectLoader.h"
+#include "../MeshParser/MeshParser.h"
+#include "../MeshOptimizer/MeshOptimizer.h"
+#include "../VertexLayout/VertexLayout.h"
+
+#include <glm/gtc/matrix_transform.hpp>
 
 void mvk::ObjectLoader::LoadObject() {
-    std::ifstream f(OBJECT_PATH);
-    
-    std::string line;
-    while (std::getline(f, line)) {
-        if (line == "") continue;
-        std::istringstream ss(line);
-        
-        std::vector<double> nums;
-
-        double num;
-        while(ss >> num)
-            nums.push_back(num);
-
-        object.push_back({{nums[0], nums[1], nums[2]}, {nums[3], nums[4], nums[5]}, {nums[6], nums[7]}});
+    if (LoadCache(AssetPaths::Asset(OBJECT_CACHE_PATH)))
+        return;
+
+    LoadObject(AssetPaths::Asset(OBJECT_PATH));
+}
+
+void mvk::ObjectLoader::LoadObject(const std::string& path) {
+    MappedFile file;
+    file.Open(path);
+
+    object.clear();
+    MeshParser::Parse(reinterpret_cast<const char*>(file.data()), file.size(), path, object, ThreadPool::Shared());
+
+    stats_ = MeshOptimizer::Optimize(object, indices);
+
+    quantization_ = ActiveVertexLayout::ComputeQuantization(object);
+    report_ = ActiveVertexLayout::Quantize(object, quantization_, packed_);
+    bounds_ = ActiveVertexLayout::BoundingSphere(packed_.data(), object.size());
+}
+
+bool mvk::ObjectLoader::LoadCache(const std::string& path) {
+    try {
+        mapped_.Open(path);
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    try {
+        cache_ = MeshCache::Open(mapped_);
+    } catch (const std::exception& e) {
+        std::cout << "\u001b[33mWARNING: " << e.what() << " Falling back to text: " << path << "\u001b[0m\n";
+        mapped_.Close();
+        cache_ = MeshView{};
+        return false;
     }
+
+    if (!MeshCache::MatchesLayout(cache_, ActiveVertexLayout::STRIDE, GetVerticesAttributeDescription())) {
+        std::cout << "\u001b[33mWARNING: Mesh cache layout differs from the active vertex layout, falling back to text: " << path << "\u001b[0m\n";
+        mapped_.Close();
+        cache_ = MeshView{};
+        return false;
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        quantization_.offset[i] = cache_.header->position_offset[i];
+        quantization_.scale[i] = cache_.header->position_scale[i];
+    }
+    bounds_ = ActiveVertexLayout::BoundingSphere(cache_.vertices, cache_.header->vertex_count);
+
+    return true;
+}
+
+const void* mvk::ObjectLoader::vertex_data() const {
+    return cache_.header ? cache_.vertices : packed_.data();
+}
+
+vk::DeviceSize mvk::ObjectLoader::vertex_data_size() const {
+    return cache_.header ? cache_.header->vertex_data_size : packed_.size();
+}
+
+const uint32_t* mvk::ObjectLoader::index_data() const {
+    return cache_.header ? cache_.indices : indices.data();
 }
 
-vk::VertexInputBindingDescription mvk::ObjectLoader::GetVerticesBindingDescription()
-{
-    vk::VertexInputBindingDescription vertex_binding_desc{};
-    vertex_binding_desc.setBinding(0);
-    vertex_binding_desc.setStride(sizeof(Vertex));
-    vertex_binding_desc.setInputRate(vk::VertexInputRate::eVertex);
-    return vertex_binding_desc;
+vk::DeviceSize mvk::ObjectLoader::index_data_size() const {
+    return sizeof(uint32_t) * index_count();
+}
+
+const mvk::MeshOptimizationStats& mvk::ObjectLoader::optimization_stats() const {
+    return stats_;
+}
+
+const mvk::QuantizationReport& mvk::ObjectLoader::quantization_report() const {
+    return report_;
+}
+
+const mvk::PositionQuantization& mvk::ObjectLoader::quantization() const {
+    return quantization_;
+}
+
+glm::mat4 mvk::ObjectLoader::dequantization() const {
+    glm::mat4 translation = glm::translate(glm::mat4(1.0f), glm::vec3(quantization_.offset[0], quantization_.offset[1], quantization_.offset[2]));
+    return glm::scale(translation, glm::vec3(quantization_.scale[0], quantization_.scale[1], quantization_.scale[2]));
+}
+
+glm::vec4 mvk::ObjectLoader::bounding_sphere() const {
+    return bounds_;
+}
+
+uint32_t mvk::ObjectLoader::index_count() const {
+    return static_cast<uint32_t>(cache_.header ? cache_.header->index_count : indices.size());
+}
+
+vk::VertexInputBindingDescription mvk::ObjectLoader::GetVerticesBindingDescription() {
+    return ActiveVertexLayout::BindingDescription();
 }
 
 std::vector<vk::VertexInputAttributeDescription> mvk::ObjectLoader::GetVerticesAttributeDescription() {
-    std::vector<vk::VertexInputAttributeDescription> vertex_attributes(3);
-    vertex_attributes[0].setBinding(0);
-    vertex_attributes[0].setLocation(0);
-    vertex_attributes[0].setFormat(vk::Format::eR32G32B32Sfloat);
-    vertex_attributes[0].setOffset(offsetof(Vertex, Vertex::Position));
-
-    vertex_attributes[1].setBinding(0);
-    vertex_attributes[1].setLocation(1);
-    vertex_attributes[1].setFormat(vk::Format::eR32G32B32Sfloat);
-    vertex_attributes[1].setOffset(offsetof(Vertex, Vertex::Color));
-
-    vertex_attributes[2].setBinding(0);
-    vertex_attributes[2].setLocation(2);
-    vertex_attributes[2].setFormat(vk::Format::eR32G32Sfloat);
-    vertex_attributes[2].setOffset(offsetof(Vertex, Vertex::UVs));
-
-    return vertex_attributes;
+    return ActiveVertexLayout::AttributeDescription();
+}
+
+vk::VertexInputBindingDescription mvk::ObjectLoader::GetInstanceBindingDescription() {
+    vk::VertexInputBindingDescription instance_binding_desc{};
+    instance_binding_desc.setBinding(1);
+    instance_binding_desc.setStride(sizeof(InstanceData));
+    instance_binding_desc.setInputRate(vk::VertexInputRate::eInstance);
+    return instance_binding_desc;
+}
+
+std::vector<vk::VertexInputAttributeDescription> mvk::ObjectLoader::GetInstanceAttributeDescription() {
+    std::vector<vk::VertexInputAttributeDescription> instance_attributes(5);
+    for (uint32_t column = 0; column < 4; ++column) {
+        instance_attributes[column].setBinding(1);
+        instance_attributes[column].setLocation(3 + column);
+        instance_attributes[column].setFormat(vk::Format::eR32G32B32A32Sfloat);
+        instance_attributes[column].setOffset(offsetof(InstanceData, Transform) + column * sizeof(glm::vec4));
+    }
+
+    instance_attributes[4].setBinding(1);
+    instance_attributes[4].setLocation(7);
+    instance_attributes[4].setFormat(vk::Format::eR32Uint);
+    instance_attributes[4].setOffset(offsetof(InstanceData, Material));
+
+    return instance_attributes;
 }
@@ -6,9 +6,12 @@
 
 #include <array>
 #include <fstream>
+#include <iostream>
 #include <sstream>
+#include <string>
 
 #include "../MVKConstants.h"
+#include "../MeshCache/MeshCache.h"
 
 namespace mvk {
     struct Vertex {
@@ -17,20 +20,106 @@ namespace mvk {
         glm::vec2 UVs;
     };
 
+    // ACMR: vertex shader invocations per triangle (3.0 for an unindexed list, ~0.5 is the ideal).
+    // ATVR: invocations per unique vertex (1.0 is the ideal).
+    struct VertexCacheStats {
+        float acmr = 0.0f;
+        float atvr = 0.0f;
+        uint32_t vertex_count = 0;
+        uint32_t index_count = 0;
+        uint64_t memory_bytes = 0;
+    };
+
+    struct MeshOptimizationStats {
+        VertexCacheStats before;
+        VertexCacheStats after;
+    };
+
+    // Measured maximum absolute round-trip error per attribute next to the format's theoretical bound.
+    struct QuantizationReport {
+        float position_error = 0.0f;
+        float color_error = 0.0f;
+        float uv_error = 0.0f;
+
+        float position_bound = 0.0f;
+        float color_bound = 0.0f;
+        float uv_bound = 0.0f;
+
+        uint64_t source_bytes = 0;
+        uint64_t packed_bytes = 0;
+    };
+
     struct MVP {
         glm::mat4 Model;
         glm::mat4 View;
         glm::mat4 Projection;
     };
 
+    // std430 record of the object storage buffer, indexed by gl_InstanceIndex: draws use
+    // the object's index as firstInstance. Transform places the object in the world
+    // ahead of the shared MVP model matrix; Bounds is a sphere in vertex space.
+    // Material indexes the bindless material buffer.
+    struct ObjectData {
+        glm::mat4 Transform;
+        glm::vec4 Bounds;
+        uint32_t Material;
+        uint32_t padding[3];
+    };
+
+    // Per-instance vertex stream (binding 1, eInstance) of the instanced pipeline.
+    // Transform occupies locations 3-6, one column each; Material is location 7.
+    struct InstanceData {
+        glm::mat4 Transform;
+        uint32_t Material;
+        uint32_t padding[3];
+    };
+
+    struct DrawCommand {
+        ObjectData object;
+        uint32_t index_count = 0;
+        uint32_t first_index = 0;
+        int32_t vertex_offset = 0;
+    };
+
     class ObjectLoader {
        public:
         void LoadObject();
+        void LoadObject(const std::string& path);
+        bool LoadCache(const std::string& path);
 
         static vk::VertexInputBindingDescription GetVerticesBindingDescription();
         static std::vector<vk::VertexInputAttributeDescription> GetVerticesAttributeDescription();
+        static vk::VertexInputBindingDescription GetInstanceBindingDescription();
+        static std::vector<vk::VertexInputAttributeDescription> GetInstanceAttributeDescription();
+
+        const void* vertex_data() const;
+        vk::DeviceSize vertex_data_size() const;
+        const uint32_t* index_data() const;
+        vk::DeviceSize index_data_size() const;
+        uint32_t index_count() const;
+
+        // Only filled for meshes parsed from text; caches are stored already optimized.
+        const MeshOptimizationStats& optimization_stats() const;
+        const QuantizationReport& quantization_report() const;
+
+        const PositionQuantization& quantization() const;
+        // Maps positions stored in the active vertex layout back to object space.
+        glm::mat4 dequantization() const;
+        // Bounding sphere of the stored positions, see VertexLayout::BoundingSphere.
+        glm::vec4 bounding_sphere() const;
 
         std::vector<Vertex> object;
+        std::vector<uint32_t> indices;
+
+       private:
+        MappedFile mapped_;
+        MeshView cache_;
+        MeshOptimizationStats stats_;
+
+        std::vector<uint8_t> packed_;
+        PositionQuantization quantization_;
+        QuantizationReport report_;
+        glm::vec4 bounds_ = glm::vec4(0.0f);
     };
 }
 
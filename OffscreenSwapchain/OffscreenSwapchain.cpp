@@ -0,0 +1,72 @@
+#include "OffscreenSwapchain.h"
+
+namespace mvk {
+    void OffscreenSwapchain::Init(vk::Device device, DeviceMemoryAllocator& allocator, vk::Format format, vk::Extent2D extent, uint32_t image_count) {
+        device_ = device;
+        allocator_ = &allocator;
+        format_ = format;
+        extent_ = extent;
+        next_image_ = 0;
+        presented_count_ = 0;
+
+        images_.resize(image_count);
+        allocations_.resize(image_count);
+
+        for (uint32_t i = 0; i < image_count; ++i) {
+            vk::ImageCreateInfo image_info{};
+            image_info.sType = vk::StructureType::eImageCreateInfo;
+            image_info.setImageType(vk::ImageType::e2D);
+            image_info.setExtent(vk::Extent3D(extent.width, extent.height, 1));
+            image_info.setMipLevels(1);
+            image_info.setArrayLayers(1);
+            image_info.setFormat(format);
+            image_info.setTiling(vk::ImageTiling::eOptimal);
+            image_info.setInitialLayout(vk::ImageLayout::eUndefined);
+            image_info.setUsage(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc);
+            image_info.setSharingMode(vk::SharingMode::eExclusive);
+            image_info.setSamples(vk::SampleCountFlagBits::e1);
+
+            images_[i] = device_.createImage(image_info);
+
+            vk::MemoryRequirements mem_reqs = device_.getImageMemoryRequirements(images_[i]);
+            allocations_[i] = allocator_->Allocate(mem_reqs, vk::MemoryPropertyFlagBits::eDeviceLocal, ResourceKind::eOptimal);
+            device_.bindImageMemory(images_[i], allocations_[i].memory, allocations_[i].offset);
+        }
+    }
+
+    void OffscreenSwapchain::Destroy() {
+        for (size_t i = 0; i < images_.size(); ++i) {
+            device_.destroyImage(images_[i]);
+            allocator_->Free(allocations_[i]);
+        }
+
+        images_.clear();
+        allocations_.clear();
+    }
+
+    uint32_t OffscreenSwapchain::AcquireNextImage() {
+        uint32_t image_index = next_image_;
+        next_image_ = (next_image_ + 1) % static_cast<uint32_t>(images_.size());
+        return image_index;
+    }
+
+    void OffscreenSwapchain::Present(uint32_t) {
+        presented_count_++;
+    }
+
+    const std::vector<vk::Image>& OffscreenSwapchain::images() const {
+        return images_;
+    }
+
+    vk::Format OffscreenSwapchain::format() const {
+        return format_;
+    }
+
+    vk::Extent2D OffscreenSwapchain::extent() const {
+        return extent_;
+    }
+
+    uint64_t OffscreenSwapchain::presented_count() const {
+        return presented_count_;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef MVK_OFFSCREEN_SWAPCHAIN
+#define MVK_OFFSCREEN_SWAPCHAIN
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "../MemoryAllocator/DeviceMemoryAllocator.h"
+
+namespace mvk {
+    // Stands in for VkSwapchainKHR when there is no surface: a ring of color
+    // images that are rendered in turn. Reuse is safe as long as there are more
+    // images than frames in flight, because DrawFrame waits for the fence of the
+    // frame that last rendered into the slot before recording into it again.
+    class OffscreenSwapchain {
+       public:
+        void Init(vk::Device device, DeviceMemoryAllocator& allocator, vk::Format format, vk::Extent2D extent, uint32_t image_count);
+        void Destroy();
+
+        uint32_t AcquireNextImage();
+        // Nothing is shown; the image stays in eTransferSrcOptimal for readback.
+        void Present(uint32_t image_index);
+
+        const std::vector<vk::Image>& images() const;
+        vk::Format format() const;
+        vk::Extent2D extent() const;
+        uint64_t presented_count() const;
+
+       private:
+        vk::Device device_;
+        DeviceMemoryAllocator* allocator_ = nullptr;
+        vk::Format format_ = vk::Format::eUndefined;
+        vk::Extent2D extent_;
+
+        std::vector<vk::Image> images_;
+        std::vector<Allocation> allocations_;
+        uint32_t next_image_ = 0;
+        uint64_t presented_count_ = 0;
+    };
+}
+
+#endif  // MVK_OFFSCREEN_SWAPCHAIN
@@ -0,0 +1,168 @@
+#include "PipelineCache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "../Fnv1a/Fnv1a.h"
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+namespace mvk {
+    void PipelineCache::Init(vk::PhysicalDevice physical_device, vk::Device device, const std::string& path, bool creation_feedback) {
+        physical_device_ = physical_device;
+        device_ = device;
+        path_ = path;
+        creation_feedback_ = creation_feedback;
+        stats_ = PipelineCacheStatistics{};
+
+        auto start = std::chrono::steady_clock::now();
+
+        std::string data;
+        std::string rejected = LoadBlob(data);
+        if (!rejected.empty()) {
+            std::cout << "\u001b[33mWARNING: Pipeline cache rejected (" << rejected << "), starting cold: " << path_ << "\u001b[0m\n";
+            data.clear();
+        }
+
+        vk::PipelineCacheCreateInfo cache_info{};
+        cache_info.sType = vk::StructureType::ePipelineCacheCreateInfo;
+        cache_info.setInitialDataSize(data.size());
+        cache_info.setPInitialData(data.empty() ? nullptr : data.data());
+
+        cache_ = device_.createPipelineCache(cache_info);
+
+        stats_.loaded_from_disk = !data.empty();
+        stats_.loaded_bytes = data.size();
+        stats_.load_ms = MillisecondsSince(start);
+    }
+
+    void PipelineCache::Destroy() {
+        device_.destroyPipelineCache(cache_);
+        cache_ = nullptr;
+    }
+
+    void PipelineCache::Save() {
+        std::vector<uint8_t> data = device_.getPipelineCacheData(cache_);
+
+        PipelineCacheFileHeader header{};
+        header.magic = PIPELINE_CACHE_FILE_MAGIC;
+        header.version = PIPELINE_CACHE_FILE_VERSION;
+        header.data_size = data.size();
+        header.checksum = Fnv1a::Hash(data.data(), data.size());
+
+        std::string temp_path = path_ + ".tmp";
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cout << "\u001b[33mWARNING: Cannot write pipeline cache: " << temp_path << "\u001b[0m\n";
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        // Buffered bytes only reach the disk on close, which sets failbit if that write fails.
+        file.close();
+
+        std::error_code error;
+        if (file.fail()) {
+            std::cout << "\u001b[33mWARNING: Failed to write pipeline cache: " << temp_path << "\u001b[0m\n";
+            std::filesystem::remove(temp_path, error);
+            return;
+        }
+
+        // A crash mid-write leaves the previous cache intact instead of a truncated one.
+        std::filesystem::rename(temp_path, path_, error);
+        if (error) {
+            std::cout << "\u001b[33mWARNING: Cannot replace pipeline cache: " << error.message() << "\u001b[0m\n";
+            std::filesystem::remove(temp_path, error);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.saved_bytes = data.size();
+    }
+
+    vk::Pipeline PipelineCache::CreateGraphicsPipeline(const vk::GraphicsPipelineCreateInfo& pipeline_info) {
+        vk::PipelineCreationFeedback pipeline_feedback{};
+        vk::PipelineCreationFeedbackCreateInfo feedback_info{};
+        feedback_info.sType = vk::StructureType::ePipelineCreationFeedbackCreateInfo;
+        feedback_info.setPPipelineCreationFeedback(&pipeline_feedback);
+        feedback_info.setPNext(pipeline_info.pNext);
+
+        vk::GraphicsPipelineCreateInfo info = pipeline_info;
+        if (creation_feedback_)
+            info.setPNext(&feedback_info);
+
+        auto start = std::chrono::steady_clock::now();
+        auto res = device_.createGraphicsPipeline(cache_, info);
+        double elapsed = MillisecondsSince(start);
+
+        if (res.result != vk::Result::eSuccess)
+            throw std::runtime_error("Cannot create pipeline.");
+
+        bool valid = static_cast<bool>(pipeline_feedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid);
+        bool hit = valid && (pipeline_feedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit);
+
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.pipeline_count++;
+        stats_.cache_hits += hit ? 1 : 0;
+        stats_.cache_misses += valid && !hit ? 1 : 0;
+        stats_.create_ms += elapsed;
+
+        return res.value;
+    }
+
+    vk::PipelineCache PipelineCache::get_cache() const {
+        return cache_;
+    }
+
+    PipelineCacheStatistics PipelineCache::statistics() {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        return stats_;
+    }
+
+    // Returns why the file cannot be used, or an empty string when data holds a valid blob.
+    // A missing file is not an error, only a cold start.
+    std::string PipelineCache::LoadBlob(std::string& data) const {
+        std::ifstream file(path_, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return "";
+
+        std::streamsize file_size = file.tellg();
+        file.seekg(0);
+
+        PipelineCacheFileHeader header{};
+        if (file_size < static_cast<std::streamsize>(sizeof(header)) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return "truncated header";
+        if (header.magic != PIPELINE_CACHE_FILE_MAGIC || header.version != PIPELINE_CACHE_FILE_VERSION)
+            return "unknown file format";
+        if (header.data_size != static_cast<uint64_t>(file_size) - sizeof(header))
+            return "size mismatch";
+
+        data.resize(header.data_size);
+        if (!file.read(data.data(), data.size()))
+            return "truncated data";
+        if (Fnv1a::Hash(data.data(), data.size()) != header.checksum)
+            return "checksum mismatch";
+
+        VkPipelineCacheHeaderVersionOne vk_header{};
+        if (data.size() < sizeof(vk_header))
+            return "truncated driver header";
+        std::memcpy(&vk_header, data.data(), sizeof(vk_header));
+
+        vk::PhysicalDeviceProperties properties = physical_device_.getProperties();
+        if (vk_header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || vk_header.headerSize < sizeof(vk_header))
+            return "unsupported driver header";
+        if (vk_header.vendorID != properties.vendorID || vk_header.deviceID != properties.deviceID)
+            return "different device";
+        if (std::memcmp(vk_header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) != 0)
+            return "different driver version";
+
+        return "";
+    }
+}
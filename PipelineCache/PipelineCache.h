@@ -0,0 +1,68 @@
+#ifndef MVK_PIPELINE_CACHE
+#define MVK_PIPELINE_CACHE
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mvk {
+    // On-disk layout: PipelineCacheFileHeader followed by the blob returned by
+    // vkGetPipelineCacheData. The blob is only handed to the driver when our header
+    // checks out and its own VkPipelineCacheHeaderVersionOne matches this device.
+    constexpr uint32_t PIPELINE_CACHE_FILE_MAGIC = 0x434B564D;  // "MVKC"
+    constexpr uint32_t PIPELINE_CACHE_FILE_VERSION = 2;
+
+    struct PipelineCacheFileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t data_size;
+        uint64_t checksum;
+    };
+
+    struct PipelineCacheStatistics {
+        bool loaded_from_disk = false;
+        uint64_t loaded_bytes = 0;
+        uint64_t saved_bytes = 0;
+        double load_ms = 0.0;
+
+        uint32_t pipeline_count = 0;
+        // Pipelines created without creation feedback count towards neither.
+        uint32_t cache_hits = 0;
+        uint32_t cache_misses = 0;
+        double create_ms = 0.0;
+    };
+
+    class PipelineCache {
+       public:
+        // creation_feedback: the device is Vulkan 1.3 or has VK_EXT_pipeline_creation_feedback
+        // enabled; without it cache hits are not reported.
+        void Init(vk::PhysicalDevice physical_device, vk::Device device, const std::string& path, bool creation_feedback);
+        void Destroy();
+
+        // Writes to a temporary file next to path and renames it over the old cache.
+        void Save();
+
+        // Creates the pipeline through the cache and records whether the driver found it there.
+        // Safe to call from several threads at once.
+        vk::Pipeline CreateGraphicsPipeline(const vk::GraphicsPipelineCreateInfo& pipeline_info);
+
+        vk::PipelineCache get_cache() const;
+        PipelineCacheStatistics statistics();
+
+       private:
+        std::string LoadBlob(std::string& data) const;
+
+        vk::PhysicalDevice physical_device_;
+        vk::Device device_;
+        vk::PipelineCache cache_;
+        std::string path_;
+        bool creation_feedback_ = false;
+        PipelineCacheStatistics stats_;
+        std::mutex stats_mutex_;
+    };
+}
+
+#endif  // MVK_PIPELINE_CACHE
@@ -0,0 +1,156 @@
+#include "PipelineRegistry.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "../Fnv1a/Fnv1a.h"
+
+static uint64_t CombineKey(uint64_t hash, uint64_t value) {
+    return mvk::Fnv1a::Hash(&value, sizeof(value), hash);
+}
+
+namespace mvk {
+    PipelineHandle::PipelineHandle(uint64_t key, std::shared_future<vk::Pipeline> pipeline)
+        : key_(key), pipeline_(std::move(pipeline)) {}
+
+    bool PipelineHandle::IsValid() const {
+        return pipeline_.valid();
+    }
+
+    bool PipelineHandle::IsReady() const {
+        return pipeline_.valid() && pipeline_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    vk::Pipeline PipelineHandle::Get() const {
+        if (!pipeline_.valid())
+            throw std::runtime_error("Pipeline handle is empty.");
+        return pipeline_.get();
+    }
+
+    uint64_t PipelineHandle::key() const {
+        return key_;
+    }
+
+    bool PipelineRegistry::PipelineKey::operator==(const PipelineKey& other) const {
+        return hash == other.hash && layout == other.layout && render_pass == other.render_pass &&
+               subpass == other.subpass && *description == *other.description;
+    }
+
+    size_t PipelineRegistry::PipelineKeyHash::operator()(const PipelineKey& key) const {
+        return static_cast<size_t>(key.hash);
+    }
+
+    void PipelineRegistry::Init(vk::Device device, PipelineCache& cache, ThreadPool& pool) {
+        device_ = device;
+        cache_ = &cache;
+        pool_ = &pool;
+    }
+
+    void PipelineRegistry::Destroy() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (auto &[key, handle] : pipelines_) {
+            try {
+                device_.destroyPipeline(handle.Get());
+            } catch (const std::exception&) {
+                // Failed compiles own no pipeline.
+            }
+        }
+        pipelines_.clear();
+    }
+
+    PipelineHandle PipelineRegistry::Request(const PipelineDescription& description, vk::PipelineLayout layout,
+                                             vk::RenderPass render_pass, uint32_t subpass) {
+        PipelineKey key;
+        key.description = std::make_shared<const PipelineDescription>(description);
+        key.layout = layout;
+        key.render_pass = render_pass;
+        key.subpass = subpass;
+        key.hash = description.Hash();
+        key.hash = CombineKey(key.hash, reinterpret_cast<uint64_t>(static_cast<VkPipelineLayout>(layout)));
+        key.hash = CombineKey(key.hash, reinterpret_cast<uint64_t>(static_cast<VkRenderPass>(render_pass)));
+        key.hash = CombineKey(key.hash, subpass);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto found = pipelines_.find(key);
+        if (found != pipelines_.end())
+            return found->second;
+
+        std::shared_ptr<const PipelineDescription> owned = key.description;
+        std::shared_future<vk::Pipeline> future = pool_->Submit([this, owned, layout, render_pass, subpass]() {
+            return Compile(*owned, layout, render_pass, subpass);
+        }).share();
+
+        PipelineHandle handle(key.hash, future);
+        pipelines_.emplace(std::move(key), handle);
+        return handle;
+    }
+
+    size_t PipelineRegistry::pipeline_count() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pipelines_.size();
+    }
+
+    vk::Pipeline PipelineRegistry::Compile(const PipelineDescription& description, vk::PipelineLayout layout,
+                                           vk::RenderPass render_pass, uint32_t subpass) {
+        vk::ShaderModuleCreateInfo vertex_info{};
+        vertex_info.sType = vk::StructureType::eShaderModuleCreateInfo;
+        vertex_info.setCodeSize(description.vertex_code.size() * sizeof(uint32_t));
+        vertex_info.setPCode(description.vertex_code.data());
+
+        vk::ShaderModuleCreateInfo fragment_info{};
+        fragment_info.sType = vk::StructureType::eShaderModuleCreateInfo;
+        fragment_info.setCodeSize(description.fragment_code.size() * sizeof(uint32_t));
+        fragment_info.setPCode(description.fragment_code.data());
+
+        vk::ShaderModule vertex_module = device_.createShaderModule(vertex_info);
+        vk::ShaderModule fragment_module = device_.createShaderModule(fragment_info);
+
+        GraphicsSettings graphics_settings;
+        auto shader_stages = graphics_settings.CreateShadersStages({vertex_module, fragment_module});
+        auto viewport_info = graphics_settings.CreateViewport();
+        auto dynamic_state_info = graphics_settings.CreateDynamicStates();
+        vk::PipelineColorBlendAttachmentState colorblend = description.colorblend;
+        auto colorblend_info = graphics_settings.CreateColorBlendInfo(colorblend);
+
+        vk::PipelineVertexInputStateCreateInfo vertex_input_info{};
+        vertex_input_info.sType = vk::StructureType::ePipelineVertexInputStateCreateInfo;
+        vertex_input_info.setVertexBindingDescriptionCount(static_cast<uint32_t>(description.bindings.size()));
+        vertex_input_info.setPVertexBindingDescriptions(description.bindings.data());
+        vertex_input_info.setVertexAttributeDescriptionCount(static_cast<uint32_t>(description.attributes.size()));
+        vertex_input_info.setPVertexAttributeDescriptions(description.attributes.data());
+
+        vk::GraphicsPipelineCreateInfo pipeline_info{};
+        pipeline_info.sType = vk::StructureType::eGraphicsPipelineCreateInfo;
+        pipeline_info.setStageCount(shader_stages.size());
+        pipeline_info.setStages(shader_stages);
+
+        pipeline_info.setPVertexInputState(&vertex_input_info);
+        pipeline_info.setPInputAssemblyState(&description.input_assembly);
+        pipeline_info.setPViewportState(&viewport_info);
+        pipeline_info.setPRasterizationState(&description.rasterizer);
+        pipeline_info.setPMultisampleState(&description.multisampling);
+        pipeline_info.setPDepthStencilState(nullptr);
+        pipeline_info.setPDynamicState(&dynamic_state_info);
+        pipeline_info.setPColorBlendState(&colorblend_info);
+        pipeline_info.setLayout(layout);
+        pipeline_info.setRenderPass(render_pass);
+        pipeline_info.setSubpass(subpass);
+        pipeline_info.setBasePipelineHandle(VK_NULL_HANDLE);
+        pipeline_info.setBasePipelineIndex(-1);
+
+        vk::Pipeline pipeline;
+        try {
+            pipeline = cache_->CreateGraphicsPipeline(pipeline_info);
+        } catch (...) {
+            device_.destroyShaderModule(vertex_module);
+            device_.destroyShaderModule(fragment_module);
+            throw;
+        }
+
+        device_.destroyShaderModule(vertex_module);
+        device_.destroyShaderModule(fragment_module);
+        return pipeline;
+    }
+}
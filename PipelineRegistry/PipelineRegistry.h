@@ -0,0 +1,80 @@
+#ifndef MVK_PIPELINE_REGISTRY
+#define MVK_PIPELINE_REGISTRY
+
+#include <vulkan/vulkan.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "../GraphicsSettings/GraphicsSettings.h"
+#include "../PipelineCache/PipelineCache.h"
+#include "../ThreadPool/ThreadPool.h"
+
+namespace mvk {
+    // Result of a pipeline request. Cheap to copy; every copy refers to the same compile.
+    class PipelineHandle {
+       public:
+        PipelineHandle() = default;
+        PipelineHandle(uint64_t key, std::shared_future<vk::Pipeline> pipeline);
+
+        bool IsValid() const;
+        // Non-blocking: true once the pipeline can be bound.
+        bool IsReady() const;
+        // Blocks until compiled. Rethrows if compilation failed.
+        vk::Pipeline Get() const;
+
+        uint64_t key() const;
+
+       private:
+        uint64_t key_ = 0;
+        std::shared_future<vk::Pipeline> pipeline_;
+    };
+
+    // Compiles pipeline variants on the shared thread pool. Requests are keyed by the
+    // whole description together with the layout, render pass and subpass, so asking
+    // for the same variant twice returns the handle of the first compile. The hash only
+    // picks the bucket; colliding descriptions still get pipelines of their own.
+    class PipelineRegistry {
+       public:
+        void Init(vk::Device device, PipelineCache& cache, ThreadPool& pool = ThreadPool::Shared());
+        // Waits for outstanding compiles and destroys every pipeline.
+        void Destroy();
+
+        PipelineHandle Request(const PipelineDescription& description, vk::PipelineLayout layout,
+                               vk::RenderPass render_pass, uint32_t subpass = 0);
+
+        size_t pipeline_count();
+
+       private:
+        struct PipelineKey {
+            std::shared_ptr<const PipelineDescription> description;
+            vk::PipelineLayout layout;
+            vk::RenderPass render_pass;
+            uint32_t subpass = 0;
+            // PipelineDescription::Hash combined with the handles, computed once.
+            uint64_t hash = 0;
+
+            bool operator==(const PipelineKey& other) const;
+        };
+
+        struct PipelineKeyHash {
+            size_t operator()(const PipelineKey& key) const;
+        };
+
+        vk::Pipeline Compile(const PipelineDescription& description, vk::PipelineLayout layout,
+                             vk::RenderPass render_pass, uint32_t subpass);
+
+        vk::Device device_;
+        PipelineCache* cache_ = nullptr;
+        ThreadPool* pool_ = nullptr;
+
+        std::unordered_map<PipelineKey, PipelineHandle, PipelineKeyHash> pipelines_;
+        std::mutex mutex_;
+    };
+}
+
+#endif  // MVK_PIPELINE_REGISTRY
@@ -1,36 +1,96 @@
 #include "Presenter.h"
 
 void mvk::VKPresenter::Setup(GLFWwindow* window) {
+    // Without a window everything renders into the offscreen ring.
+    vo_.headless = (window == nullptr);
+    setup_phases_.clear();
+    phase_start_ = std::chrono::steady_clock::now();
+
     this->CreateInstance();
     this->SetupDebug();
     this->CreateSurface(window);
     this->TakeVideocard();
     this->CreateLogicalDevice();
+    this->CreateAllocator();
+    this->CreateFramePacer();
+    scene_written_.assign(vo_.pacer.frames_in_flight(), 0);
+    MarkPhase("device");
+    this->CreatePipelineCache();
     this->CreateSwapChain();
     this->CreateImageViews();
     this->CreateRenderPass();
     this->CreateDescriptorSetLayout();
+    this->CreateBindlessTable();
     this->CreateGraphicsPipeline();
+    this->CreateCullingPipeline();
     this->CreateFramebuffers();
-    this->CreateCommandPool();
-    this->CreateTextureImage();
-    this->CreateTextureImageView();
+    MarkPhase("pipeline");
+    this->CreateUploader();
+    this->CreateTextureStreamer();
     this->CreateTextureSampler();
     this->CreateObject();
+    if (draws_.empty())
+        draws_.push_back({{glm::mat4(1.0f), vo_.loader.bounding_sphere()}, vo_.loader.index_count(), 0, 0});
     this->CreateVertexBuffer();
     this->CreateIndexBuffer();
+    this->SubmitUploads();
+    MarkPhase("assets");
     this->CreateUniformBuffers();
     this->CreateDescriptorPool();
     this->CreateDescriptorSets();
     this->CreateCommandBuffers();
+    this->CreateInstanceBuffers();
     this->CreateSyncObjects();
+    this->CreateProfiler();
+    MarkPhase("frame resources");
+
+    // Pipelines still compiling in the background are not counted yet.
+    PipelineCacheStatistics cache = vo_.pipeline_cache.statistics();
+    std::cout << "\u001b[32mINFO: " << cache.pipeline_count << " pipelines created in " << cache.create_ms << " ms, ";
+    if (vo_.creation_feedback)
+        std::cout << cache.cache_hits << " cache hits, " << cache.cache_misses << " misses";
+    else
+        std::cout << "cache feedback unavailable";
+    std::cout << (cache.loaded_from_disk ? " (warm start)" : " (cold start)") << "\u001b[0m\n";
 }
 
-void mvk::VKPresenter::DrawFrame() {
+void mvk::VKPresenter::WaitForFrame() {
+    if (frame_waited_)
+        return;
+
+    vo_.profiler.BeginFrame(current_frame_);
+    vo_.profiler.BeginCpuScope("throttle");
+    vo_.pacer.Throttle();
+    vo_.profiler.EndCpuScope();
+
+    vo_.profiler.BeginCpuScope("wait");
     if (vo_.logical_device.waitForFences(1, &vo_.in_flight_fences[current_frame_], VK_TRUE, UINT64_MAX) != vk::Result::eSuccess)
         throw std::runtime_error("Cannot wait for fences.");
+    vo_.profiler.EndCpuScope();
+
+    vo_.pacer.MarkInput();
+    frame_waited_ = true;
+}
+
+void mvk::VKPresenter::DrawFrame() {
+    WaitForFrame();
+    frame_waited_ = false;
+    CpuScope frame_scope(vo_.profiler, "DrawFrame");
+    vo_.deletion.Collect(frame_count_);
     
-    vk::ResultValue<uint32_t> res = vo_.logical_device.acquireNextImageKHR(vo_.swapchain, UINT64_MAX, vo_.image_available_sems[current_frame_]);
+    if (vo_.headless) {
+        DrawOffscreenFrame();
+        return;
+    }
+
+    vo_.profiler.BeginCpuScope("acquire");
+    // vulkan.hpp reports an out-of-date swapchain by throwing; it only needs recreating.
+    vk::ResultValue<uint32_t> res(vk::Result::eErrorOutOfDateKHR, 0);
+    try {
+        res = vo_.logical_device.acquireNextImageKHR(vo_.swapchain, UINT64_MAX, vo_.image_available_sems[current_frame_]);
+    } catch (const vk::OutOfDateKHRError&) {
+    }
+    vo_.profiler.EndCpuScope();
     
     if (res.result == vk::Result::eErrorOutOfDateKHR) {
         window_resized_ = false;
@@ -40,13 +100,20 @@ void mvk::VKPresenter::DrawFrame() {
         throw std::runtime_error("Cannot acquire next image.");
     }
 
+    vo_.uploader.Collect();
+    vo_.streamer.Update(frame_count_);
+    vo_.bindless.BeginFrame(current_frame_);
+    vo_.profiler.BeginCpuScope("UpdateUniforms");
     UpdateUniforms(current_frame_);
+    vo_.profiler.EndCpuScope();
 
     if (vo_.logical_device.resetFences(1, &vo_.in_flight_fences[current_frame_]) != vk::Result::eSuccess)
         throw std::runtime_error("Cannot reset fences.");
 
-    vo_.command_buffers[current_frame_].reset();
-    RecordCommandBuffer(vo_.command_buffers[current_frame_], res.value);
+    vo_.profiler.BeginCpuScope("record");
+    vk::CommandBuffer command_buffer = vo_.recorder.BeginFrame(current_frame_);
+    RecordCommandBuffer(command_buffer, res.value);
+    vo_.profiler.EndCpuScope();
 
 
     vk::SubmitInfo submit_info{};
@@ -57,13 +124,16 @@ void mvk::VKPresenter::DrawFrame() {
     vk::PipelineStageFlags waiting_stages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
     submit_info.setPWaitDstStageMask(waiting_stages);
     submit_info.setCommandBufferCount(1);
-    submit_info.setPCommandBuffers(&vo_.command_buffers[current_frame_]);
-    vk::Semaphore signal_sems[] = { vo_.render_finished_sems[current_frame_] };
+    submit_info.setPCommandBuffers(&command_buffer);
+    vk::Semaphore signal_sems[] = { vo_.render_finished_sems[res.value] };
     submit_info.setSignalSemaphoreCount(1);
     submit_info.setPSignalSemaphores(signal_sems);
 
+    vo_.profiler.BeginCpuScope("submit");
+    vo_.profiler.MarkSubmit();
     if (vo_.graphics_queue.submit(1, &submit_info, vo_.in_flight_fences[current_frame_]) != vk::Result::eSuccess)
         throw std::runtime_error("Failed to submit drawing.");
+    vo_.profiler.EndCpuScope();
     
     
     vk::PresentInfoKHR present{};
@@ -75,27 +145,98 @@ void mvk::VKPresenter::DrawFrame() {
     present.setPSwapchains(swap_chains);
     present.setPImageIndices(&res.value);
     present.setPResults(nullptr);
+    vk::PresentIdKHR present_id{};
+    vo_.pacer.PreparePresent(present, present_id);
 
+    vo_.profiler.BeginCpuScope("present");
     vk::Result present_res = vo_.present_queue.presentKHR(&present);
+    vo_.profiler.EndCpuScope();
+    vo_.pacer.Presented(present_res == vk::Result::eSuccess || present_res == vk::Result::eSuboptimalKHR);
     if (present_res == vk::Result::eErrorOutOfDateKHR || present_res == vk::Result::eSuboptimalKHR || window_resized_) {
         window_resized_ = false;
         RecreateSwapChain();
-    } else if (res.result != vk::Result::eSuccess) {
+    } else if (present_res != vk::Result::eSuccess) {
         throw std::runtime_error("Failed to present image.");
     }
     
-    current_frame_ = (current_frame_ + 1) % MAX_FRAMES;
+    current_frame_ = (current_frame_ + 1) % vo_.pacer.frames_in_flight();
+    frame_count_++;
+}
+
+// Same frame as DrawFrame, minus the swapchain: there is no acquire to wait on and nothing
+// to present, so the submit carries no semaphores and only the in-flight fence orders reuse.
+void mvk::VKPresenter::DrawOffscreenFrame() {
+    uint32_t image_index = vo_.offscreen.AcquireNextImage();
+
+    vo_.uploader.Collect();
+    vo_.streamer.Update(frame_count_);
+    vo_.bindless.BeginFrame(current_frame_);
+    vo_.profiler.BeginCpuScope("UpdateUniforms");
+    UpdateUniforms(current_frame_);
+    vo_.profiler.EndCpuScope();
+
+    if (vo_.logical_device.resetFences(1, &vo_.in_flight_fences[current_frame_]) != vk::Result::eSuccess)
+        throw std::runtime_error("Cannot reset fences.");
+
+    vo_.profiler.BeginCpuScope("record");
+    vk::CommandBuffer command_buffer = vo_.recorder.BeginFrame(current_frame_);
+    RecordCommandBuffer(command_buffer, image_index);
+    vo_.profiler.EndCpuScope();
+
+    vk::SubmitInfo submit_info{};
+    submit_info.sType = vk::StructureType::eSubmitInfo;
+    submit_info.setCommandBufferCount(1);
+    submit_info.setPCommandBuffers(&command_buffer);
+
+    vo_.profiler.BeginCpuScope("submit");
+    vo_.profiler.MarkSubmit();
+    if (vo_.graphics_queue.submit(1, &submit_info, vo_.in_flight_fences[current_frame_]) != vk::Result::eSuccess)
+        throw std::runtime_error("Failed to submit drawing.");
+    vo_.profiler.EndCpuScope();
+
+    vo_.offscreen.Present(image_index);
+
+    current_frame_ = (current_frame_ + 1) % vo_.pacer.frames_in_flight();
+    frame_count_++;
 }
 
 void mvk::VKPresenter::RecordCommandBuffer(vk::CommandBuffer command_buffer, uint32_t image_index) {
+    bool instanced = !instances_.empty();
+    bool gpu_driven = !instanced && gpu_culling_ && vo_.draw_indirect_count;
+    if (instanced) {
+        vo_.instances.Update(current_frame_, instances_, instances_version_);
+    } else {
+        bool rewritten = vo_.culling.Update(current_frame_, draws_, draws_version_);
+        if (scene_) {
+            if (scene_->size() > draws_.size())
+                throw std::runtime_error("Scene has more nodes than the draw list.");
+            // A rewrite brought back the draw list transforms, so the whole scene goes in again.
+            if (rewritten) scene_written_[current_frame_] = 0;
+            ObjectData* objects = vo_.culling.object_data(current_frame_);
+            scene_written_[current_frame_] = scene_->Write(&objects->Transform, sizeof(ObjectData), scene_written_[current_frame_]);
+        }
+    }
+
     vk::CommandBufferBeginInfo begin_info{};
     begin_info.sType = vk::StructureType::eCommandBufferBeginInfo;
+    begin_info.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
     begin_info.setPInheritanceInfo(nullptr);
 
-    if (command_buffer.begin(&begin_info) != vk::Result::eSuccess) {
-        std::runtime_error("Failed to begin recording command buffer.");
+    // Everything recorded per frame goes through the cached device-level table.
+    const vk::DispatchLoaderDynamic& dispatch = vo_.dispatch.get();
+
+    if (command_buffer.begin(&begin_info, dispatch) != vk::Result::eSuccess) {
+        throw std::runtime_error("Failed to begin recording command buffer.");
     }
-    
+    vo_.profiler.BeginCommands(command_buffer, !instanced && !gpu_driven);
+
+    if (gpu_driven) {
+        uint32_t cull_pass = vo_.profiler.BeginGpuScope(command_buffer, "cull");
+        vo_.culling.Dispatch(command_buffer, current_frame_, mvp_.Model, mvp_.Projection * mvp_.View);
+        vo_.profiler.EndGpuScope(command_buffer, cull_pass);
+    }
+
+    uint32_t main_pass = vo_.profiler.BeginGpuScope(command_buffer, "main pass");
 
     vk::RenderPassBeginInfo render_pass_begin_info{};
     render_pass_begin_info.sType = vk::StructureType::eRenderPassBeginInfo;
@@ -107,10 +248,56 @@ void mvk::VKPresenter::RecordCommandBuffer(vk::CommandBuffer command_buffer, uin
     
     render_pass_begin_info.setPClearValues(&clear_color);
     render_pass_begin_info.setClearValueCount(1);
-    command_buffer.beginRenderPass(render_pass_begin_info, vk::SubpassContents::eInline);
-    command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, this->vo_.pipeline);
+    if (instanced) {
+        command_buffer.beginRenderPass(render_pass_begin_info, vk::SubpassContents::eInline, dispatch);
+        BindDrawState(command_buffer, dispatch, vo_.instanced_pipeline.Get());
+        vo_.instances.Bind(command_buffer, current_frame_, dispatch);
+        command_buffer.drawIndexed(vo_.loader.index_count(), vo_.instances.instance_count(current_frame_), 0, 0, 0, dispatch);
+    } else if (gpu_driven) {
+        command_buffer.beginRenderPass(render_pass_begin_info, vk::SubpassContents::eInline, dispatch);
+        BindDrawState(command_buffer, dispatch, vo_.pipeline);
+        vo_.culling.Draw(command_buffer, current_frame_);
+    } else {
+        command_buffer.beginRenderPass(render_pass_begin_info, vk::SubpassContents::eSecondaryCommandBuffers, dispatch);
+
+        vk::CommandBufferInheritanceInfo inheritance{};
+        inheritance.sType = vk::StructureType::eCommandBufferInheritanceInfo;
+        inheritance.setRenderPass(this->vo_.render_pass);
+        inheritance.setSubpass(0);
+        inheritance.setFramebuffer(this->vo_.framebuffers[image_index]);
+        // Must match the queries active on the primary when the secondaries execute.
+        inheritance.setOcclusionQueryEnable(VK_FALSE);
+        inheritance.setPipelineStatistics(vo_.profiler.inherited_statistics());
+
+        std::vector<vk::CommandBuffer> secondaries = vo_.recorder.Record(inheritance, draws_.size(),
+            [this, &dispatch](vk::CommandBuffer secondary, size_t begin, size_t end) {
+                RecordDraws(secondary, dispatch, begin, end);
+            });
+        command_buffer.executeCommands(secondaries, dispatch);
+    }
+
+    command_buffer.endRenderPass(dispatch);
+
+    vo_.profiler.EndGpuScope(command_buffer, main_pass);
+    vo_.profiler.EndCommands(command_buffer);
+    command_buffer.end(dispatch);
+}
+
+// Runs on recorder workers: reads only state that is fixed while a frame is recorded.
+void mvk::VKPresenter::RecordDraws(vk::CommandBuffer command_buffer, const vk::DispatchLoaderDynamic& dispatch, size_t begin, size_t end) {
+    BindDrawState(command_buffer, dispatch, vo_.pipeline);
+
+    // The object index goes in as firstInstance, the vertex shader reads its transform with it.
+    for (size_t i = begin; i < end; ++i) {
+        const DrawCommand &draw = draws_[i];
+        command_buffer.drawIndexed(draw.index_count, 1, draw.first_index, draw.vertex_offset, static_cast<uint32_t>(i), dispatch);
+    }
+}
+
+void mvk::VKPresenter::BindDrawState(vk::CommandBuffer command_buffer, const vk::DispatchLoaderDynamic& dispatch, vk::Pipeline pipeline) {
+    command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline, dispatch);
     
-    command_buffer.setPolygonModeEXT(vk::PolygonMode::eFill, vk::DispatchLoaderDynamic(this->vo_.instance, vkGetInstanceProcAddr));
+    command_buffer.setPolygonModeEXT(vk::PolygonMode::eFill, dispatch);
 
     vk::Viewport viewport{};
     viewport.setX(0.0f);
@@ -119,42 +306,147 @@ void mvk::VKPresenter::RecordCommandBuffer(vk::CommandBuffer command_buffer, uin
     viewport.setHeight(static_cast<float>(this->vo_.sc_extent.height));
     viewport.setMinDepth(0.0f);
     viewport.setMaxDepth(1.0f);
-    command_buffer.setViewport(0, 1, &viewport);
+    command_buffer.setViewport(0, 1, &viewport, dispatch);
 
     vk::Rect2D scissor{};
     scissor.setOffset(vk::Offset2D((double)0, (double)0));
     scissor.setExtent(this->vo_.sc_extent);
-    command_buffer.setScissor(0, 1, &scissor);
+    command_buffer.setScissor(0, 1, &scissor, dispatch);
 
     vk::Buffer vertex_buff[] = {vo_.vertex_buffer};
     vk::DeviceSize offsets[] = {0};
-    command_buffer.bindVertexBuffers(0, 1, vertex_buff, offsets); 
-    command_buffer.bindIndexBuffer(vo_.indices_buffer, 0, vk::IndexType::eUint32);
-    command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, vo_.layout, 0, 1, &vo_.descriptor_sets[current_frame_], 0, nullptr);
-
-    // command_buffer.setPolygonModeEXT(vk::PolygonMode::eLine, vk::DispatchLoaderDynamic(vo_.instance, vkGetInstanceProcAddr));
-    command_buffer.drawIndexed(static_cast<uint32_t>(INDICES.size()), 1, 0, 0, 0);
-
-    // command_buffer.setPolygonModeEXT(vk::PolygonMode::ePoint, vk::DispatchLoaderDynamic(vo_.instance, vkGetInstanceProcAddr));
-    // command_buffer.drawIndexed(static_cast<uint32_t>(INDICES.size()), 1, 0, 0, 0);
-
-    command_buffer.endRenderPass();
-
-    command_buffer.end();
+    command_buffer.bindVertexBuffers(0, 1, vertex_buff, offsets, dispatch);
+    command_buffer.bindIndexBuffer(vo_.indices_buffer, 0, vk::IndexType::eUint32, dispatch);
+    std::array<vk::DescriptorSet, 2> sets = { vo_.descriptor_sets[current_frame_], vo_.bindless.descriptor_set(current_frame_) };
+    command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, vo_.layout, 0, sets.size(), sets.data(), 1, &mvp_offset_, dispatch);
 }
 
 void mvk::VKPresenter::UpdateUniforms(uint32_t current_image) {
     static auto StartTime = std::chrono::high_resolution_clock::now();
     auto current_time = std::chrono::high_resolution_clock::now();
     float time = std::chrono::duration<float, std::chrono::seconds::period>(current_time - StartTime).count();
+    if (animation_time_ >= 0.0f)
+        time = animation_time_;
 
     MVP mvp{};
-    mvp.Model = glm::rotate(glm::mat4(1.0f), 3.0f * time * 1.0f * glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    mvp.View = glm::lookAt(glm::vec3(0.0f, 1.5f, 5.0f), glm::vec3(0.0f, -0.2f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    mvp.Model = glm::rotate(glm::mat4(1.0f), 3.0f * time * 1.0f * glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f)) * vo_.loader.dequantization();
+    mvp.View = glm::lookAt(camera_eye_, camera_target_, glm::vec3(0.0f, 1.0f, 0.0f));
     mvp.Projection = glm::perspective(glm::radians(45.0f), vo_.sc_extent.width / (float) vo_.sc_extent.height, 0.1f, 10.0f);
     mvp.Projection[1][1] *= -1;
 
-    std::memcpy(vo_. uniform_maps[current_image], &mvp, sizeof(mvp));
+    vo_.uniforms.BeginFrame(current_image);
+    mvp_offset_ = vo_.uniforms.Push(mvp);
+    mvp_ = mvp;
+}
+
+void mvk::VKPresenter::set_camera(glm::vec3 eye, glm::vec3 target) {
+    camera_eye_ = eye;
+    camera_target_ = target;
+}
+
+void mvk::VKPresenter::set_draws(std::vector<DrawCommand> draws) {
+    draws_ = std::move(draws);
+    draws_version_++;
+}
+
+void mvk::VKPresenter::set_scene(const Scene* scene) {
+    scene_ = scene;
+    std::fill(scene_written_.begin(), scene_written_.end(), 0);
+}
+
+void mvk::VKPresenter::set_instances(std::vector<InstanceData> instances) {
+    instances_ = std::move(instances);
+    instances_version_++;
+}
+
+void mvk::VKPresenter::set_gpu_culling(bool enabled) {
+    gpu_culling_ = enabled;
+}
+
+void mvk::VKPresenter::set_texture_max_lod(float max_lod) {
+    vo_.texture_max_lod = max_lod;
+    if (!vo_.texture_sampler)
+        return;
+
+    // Frames in flight still sample through the old sampler.
+    vo_.logical_device.waitIdle();
+    vo_.logical_device.destroySampler(vo_.texture_sampler);
+    CreateTextureSampler();
+    vo_.bindless.SetSampler(vo_.texture_sampler);
+}
+
+void mvk::VKPresenter::set_frame_pacing(const FramePacingSettings& settings) {
+    bool set_up = static_cast<bool>(vo_.logical_device);
+    if (set_up && settings.frames_in_flight != vo_.pacer.frames_in_flight())
+        throw std::runtime_error("Frames in flight can only be changed before Setup.");
+
+    vo_.pacing = settings;
+    if (!set_up)
+        return;
+
+    vo_.pacer.set_frame_rate_limit(settings.max_fps);
+    // Present mode and image count take effect with the next swapchain, after this frame's present.
+    window_resized_ = !vo_.headless;
+}
+
+void mvk::VKPresenter::set_profiling(const ProfilerSettings& settings) {
+    if (vo_.logical_device)
+        throw std::runtime_error("Profiling can only be changed before Setup.");
+    vo_.profiling = settings;
+}
+
+mvk::FramePacingStatistics mvk::VKPresenter::frame_pacing_statistics() {
+    return vo_.pacer.statistics();
+}
+
+uint32_t mvk::VKPresenter::texture_mip_levels() const {
+    return vo_.streamer.mip_levels(vo_.default_material);
+}
+
+uint64_t mvk::VKPresenter::texture_bytes() const {
+    return vo_.streamer.statistics().device_bytes;
+}
+
+bool mvk::VKPresenter::textures_resident() const {
+    return vo_.streamer.idle();
+}
+
+const mvk::TextureStreamerStatistics& mvk::VKPresenter::texture_statistics() const {
+    return vo_.streamer.statistics();
+}
+
+void mvk::VKPresenter::set_recording_threads(uint32_t limit) {
+    vo_.recorder.set_worker_limit(limit);
+}
+
+uint32_t mvk::VKPresenter::index_count() const {
+    return vo_.loader.index_count();
+}
+
+glm::vec4 mvk::VKPresenter::mesh_bounds() const {
+    return vo_.loader.bounding_sphere();
+}
+
+void mvk::VKPresenter::set_animation_time(float seconds) {
+    animation_time_ = seconds;
+}
+
+const std::vector<std::pair<std::string, double>>& mvk::VKPresenter::setup_phases() const {
+    return setup_phases_;
+}
+
+const mvk::GpuProfiler& mvk::VKPresenter::profiler() const {
+    return vo_.profiler;
+}
+
+mvk::AllocatorStatistics mvk::VKPresenter::memory_statistics() {
+    return vo_.allocator.GetStatistics();
+}
+
+void mvk::VKPresenter::MarkPhase(const char* name) {
+    auto now = std::chrono::steady_clock::now();
+    setup_phases_.emplace_back(name, std::chrono::duration<double, std::milli>(now - phase_start_).count());
+    phase_start_ = now;
 }
 
 void mvk::VKPresenter::PrintLoadedData() {
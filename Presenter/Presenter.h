@@ -9,26 +9,103 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "../VulkanManager/VulkanManager.h"
 #include "../ObjectLoader/ObjectLoader.h"
+#include "../Scene/Scene.h"
 
 namespace mvk {
     class VKPresenter : public VulkanManager {
        public:
         void Setup(GLFWwindow* window);
+        // Sleeps out the frame-rate cap and waits until the next frame slot is free.
+        // Call it before sampling input so the wait does not count towards latency;
+        // DrawFrame calls it itself when it has not been called since the last frame.
+        void WaitForFrame();
         void DrawFrame();
         void RecordCommandBuffer(vk::CommandBuffer command_buffer, uint32_t image_index);
         void UpdateUniforms(uint32_t current_image);
         void PrintLoadedData();
 
         void set_window_resize();
+        void set_camera(glm::vec3 eye, glm::vec3 target);
+        // Pins the model animation to a fixed time; negative follows the wall clock.
+        void set_animation_time(float seconds);
+        // Replaces the draw list; by default Setup draws the loaded object once.
+        void set_draws(std::vector<DrawCommand> draws);
+        // Draw i takes the world matrix of node i; only matrices changed since a frame slot
+        // was last written are copied into it. The scene is updated by its owner and must
+        // outlive the presenter or be unset with nullptr.
+        void set_scene(const Scene* scene);
+        // Draws the loaded mesh once per instance in a single instanced call, in place of
+        // the draw list; an empty list goes back to the draw list.
+        void set_instances(std::vector<InstanceData> instances);
+        // Caps the threads recording secondary buffers; 0 uses the whole pool.
+        void set_recording_threads(uint32_t limit);
+        // Culls and draws on the GPU when drawIndirectCount is available (the default);
+        // off records every draw on the CPU instead.
+        void set_gpu_culling(bool enabled);
+        // Present mode, swapchain image count and frame-rate cap may change at any time
+        // and apply from the next frame on; frames in flight only before Setup.
+        void set_frame_pacing(const FramePacingSettings& settings);
+        FramePacingStatistics frame_pacing_statistics();
+        // Only before Setup. The profiler is off by default; profiler() stays empty then.
+        void set_profiling(const ProfilerSettings& settings);
+        // Sampler maxLod of the loaded texture; 0 samples only the base level. Waits for
+        // the device when called after Setup, so it is not meant for every frame.
+        void set_texture_max_lod(float max_lod);
+        // 0 until the texture has been decoded.
+        uint32_t texture_mip_levels() const;
+        // Device memory bound to streamed textures, whole mip chains included.
+        uint64_t texture_bytes() const;
+        // Textures stream in over the first frames; false while any is still on its way.
+        bool textures_resident() const;
+        const TextureStreamerStatistics& texture_statistics() const;
+        uint32_t index_count() const;
+        glm::vec4 mesh_bounds() const;
+
+        // Milliseconds spent in each group of Setup steps, in order.
+        const std::vector<std::pair<std::string, double>>& setup_phases() const;
+        const GpuProfiler& profiler() const;
+        AllocatorStatistics memory_statistics();
        
        private:
+        void DrawOffscreenFrame();
+        void MarkPhase(const char* name);
+        void RecordDraws(vk::CommandBuffer command_buffer, const vk::DispatchLoaderDynamic& dispatch, size_t begin, size_t end);
+        void BindDrawState(vk::CommandBuffer command_buffer, const vk::DispatchLoaderDynamic& dispatch, vk::Pipeline pipeline);
+
         uint32_t current_frame_ = 0;
+        // DrawFrame calls so far; the texture streamer retires resources by it.
+        uint64_t frame_count_ = 0;
         bool window_resized_ = false;
+        // WaitForFrame ran for the frame DrawFrame is about to record.
+        bool frame_waited_ = false;
         ObjectLoader loader_;
+        std::vector<DrawCommand> draws_;
+        uint64_t draws_version_ = 0;
+        const Scene* scene_ = nullptr;
+        // Per frame slot, sized by Setup.
+        std::vector<uint64_t> scene_written_;
+        std::vector<InstanceData> instances_;
+        uint64_t instances_version_ = 0;
+        bool gpu_culling_ = true;
+        MVP mvp_{};
+        // Dynamic offset of this frame's MVP in the uniform allocator.
+        uint32_t mvp_offset_ = 0;
+
+        glm::vec3 camera_eye_ = glm::vec3(0.0f, 1.5f, 5.0f);
+        glm::vec3 camera_target_ = glm::vec3(0.0f, -0.2f, 0.0f);
+        float animation_time_ = -1.0f;
+
+        std::vector<std::pair<std::string, double>> setup_phases_;
+        std::chrono::steady_clock::time_point phase_start_;
        
     };
 }
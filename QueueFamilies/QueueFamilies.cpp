@@ -11,18 +11,32 @@ namespace mvk {
 
         uint32_t i = 0;
         for (auto &qfamily : queue_families) {
-            if (qfamily.queueFlags & vk::QueueFlagBits::eGraphics)
+            bool graphics = static_cast<bool>(qfamily.queueFlags & vk::QueueFlagBits::eGraphics);
+            bool compute = static_cast<bool>(qfamily.queueFlags & vk::QueueFlagBits::eCompute);
+            bool transfer = static_cast<bool>(qfamily.queueFlags & vk::QueueFlagBits::eTransfer);
+
+            if (graphics && !indices.graphics_family_.has_value())
                 indices.graphics_family_ = i;
             
-            if (device.getSurfaceSupportKHR(i, surface))
+            if (surface && !indices.present_family_.has_value() && device.getSurfaceSupportKHR(i, surface))
                 indices.present_family_ = i;
 
-            i++;
+            if (compute && !graphics && !indices.compute_family_.has_value())
+                indices.compute_family_ = i;
+
+            // Transfer-only families map to the copy engines; take one over a compute family.
+            if (transfer && !graphics && !compute)
+                indices.transfer_family_ = i;
+            else if (transfer && !graphics && !indices.transfer_family_.has_value())
+                indices.transfer_family_ = i;
 
-            if (indices.IsComplete())
-                break;
+            i++;
         }
 
+        // Headless: nothing is presented, so the graphics family stands in and callers need no special case.
+        if (!surface)
+            indices.present_family_ = indices.graphics_family_;
+
         return indices;
     }
 }
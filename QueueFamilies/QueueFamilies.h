@@ -12,6 +12,10 @@ namespace mvk {
        public:
         std::optional<uint32_t> graphics_family_;
         std::optional<uint32_t> present_family_;
+        // Families without graphics support, so work there runs alongside rendering.
+        // Empty when the device has none; callers fall back to the graphics family.
+        std::optional<uint32_t> transfer_family_;
+        std::optional<uint32_t> compute_family_;
 
         bool IsComplete();
         static QueueFamilies FindQueueFamily(vk::PhysicalDevice& device, vk::SurfaceKHR& surface);
@@ -0,0 +1,252 @@
+#include "Scene.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+// Kernels are picked at compile time: AVX for the world matrix products when the
+// target allows it (MVK_SCENE_AVX in CMake), SSE otherwise, plain glm off x86.
+#if defined(__AVX__)
+    #define MVK_SCENE_AVX
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define MVK_SCENE_SSE
+    #include <immintrin.h>
+#endif
+
+// out = a * b for column-major 4x4 matrices. Column j of the product is the columns
+// of a weighted by the elements of column j of b.
+static inline void Multiply(const float* a, const float* b, float* out) {
+#if defined(MVK_SCENE_AVX)
+    // Each 128-bit lane holds one column of b, so two product columns per iteration.
+    __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a));
+    __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+    __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+    __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+    for (int j = 0; j < 16; j += 8) {
+        __m256 columns = _mm256_loadu_ps(b + j);
+        __m256 result = _mm256_mul_ps(a0, _mm256_permute_ps(columns, 0x00));
+        result = _mm256_add_ps(result, _mm256_mul_ps(a1, _mm256_permute_ps(columns, 0x55)));
+        result = _mm256_add_ps(result, _mm256_mul_ps(a2, _mm256_permute_ps(columns, 0xAA)));
+        result = _mm256_add_ps(result, _mm256_mul_ps(a3, _mm256_permute_ps(columns, 0xFF)));
+        _mm256_storeu_ps(out + j, result);
+    }
+#elif defined(MVK_SCENE_SSE)
+    __m128 a0 = _mm_loadu_ps(a);
+    __m128 a1 = _mm_loadu_ps(a + 4);
+    __m128 a2 = _mm_loadu_ps(a + 8);
+    __m128 a3 = _mm_loadu_ps(a + 12);
+    for (int j = 0; j < 16; j += 4) {
+        __m128 column = _mm_loadu_ps(b + j);
+        __m128 result = _mm_mul_ps(a0, _mm_shuffle_ps(column, column, 0x00));
+        result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_shuffle_ps(column, column, 0x55)));
+        result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_shuffle_ps(column, column, 0xAA)));
+        result = _mm_add_ps(result, _mm_mul_ps(a3, _mm_shuffle_ps(column, column, 0xFF)));
+        _mm_storeu_ps(out + j, result);
+    }
+#else
+    glm::mat4 product = glm::make_mat4(a) * glm::make_mat4(b);
+    std::memcpy(out, glm::value_ptr(product), sizeof(product));
+#endif
+}
+
+namespace mvk {
+    uint32_t Scene::AddNode(uint32_t parent) {
+        if (parent != SCENE_NO_PARENT && parent >= count_)
+            throw std::runtime_error("Scene parent must be added before its children.");
+
+        uint32_t node = static_cast<uint32_t>(count_++);
+        size_t padded = (count_ + 3) & ~size_t(3);
+        if (tx_.size() < padded) {
+            tx_.resize(padded, 0.0f); ty_.resize(padded, 0.0f); tz_.resize(padded, 0.0f);
+            rx_.resize(padded, 0.0f); ry_.resize(padded, 0.0f); rz_.resize(padded, 0.0f); rw_.resize(padded, 1.0f);
+            sx_.resize(padded, 1.0f); sy_.resize(padded, 1.0f); sz_.resize(padded, 1.0f);
+            local_dirty_.resize(padded, 0);
+            locals_.resize(padded, glm::mat4(1.0f));
+        }
+
+        parents_.push_back(parent);
+        world_dirty_.push_back(0);
+        changed_.push_back(0);
+        worlds_.push_back(glm::mat4(1.0f));
+        local_dirty_[node] = 1;
+        return node;
+    }
+
+    void Scene::Reserve(size_t count) {
+        size_t padded = (count + 3) & ~size_t(3);
+        for (auto *array : {&tx_, &ty_, &tz_, &rx_, &ry_, &rz_, &rw_, &sx_, &sy_, &sz_})
+            array->reserve(padded);
+        local_dirty_.reserve(padded);
+        locals_.reserve(padded);
+
+        parents_.reserve(count);
+        world_dirty_.reserve(count);
+        changed_.reserve(count);
+        worlds_.reserve(count);
+    }
+
+    // The generation keeps counting so that values returned by Write stay comparable.
+    void Scene::Clear() {
+        count_ = 0;
+        for (auto *array : {&tx_, &ty_, &tz_, &rx_, &ry_, &rz_, &rw_, &sx_, &sy_, &sz_})
+            array->clear();
+        local_dirty_.clear();
+        locals_.clear();
+
+        parents_.clear();
+        world_dirty_.clear();
+        changed_.clear();
+        worlds_.clear();
+    }
+
+    void Scene::SetTranslation(uint32_t node, const glm::vec3& translation) {
+        tx_[node] = translation.x;
+        ty_[node] = translation.y;
+        tz_[node] = translation.z;
+        local_dirty_[node] = 1;
+    }
+
+    // Expects a unit quaternion; the kernel does not normalize.
+    void Scene::SetRotation(uint32_t node, const glm::quat& rotation) {
+        rx_[node] = rotation.x;
+        ry_[node] = rotation.y;
+        rz_[node] = rotation.z;
+        rw_[node] = rotation.w;
+        local_dirty_[node] = 1;
+    }
+
+    void Scene::SetScale(uint32_t node, const glm::vec3& scale) {
+        sx_[node] = scale.x;
+        sy_[node] = scale.y;
+        sz_[node] = scale.z;
+        local_dirty_[node] = 1;
+    }
+
+    size_t Scene::Update() {
+        generation_++;
+        UpdateLocals();
+
+        size_t changed = 0;
+        for (size_t i = 0; i < count_; ++i) {
+            uint32_t parent = parents_[i];
+            bool dirty = local_dirty_[i] || (parent != SCENE_NO_PARENT && world_dirty_[parent]);
+            world_dirty_[i] = dirty;
+            if (!dirty) continue;
+
+            local_dirty_[i] = 0;
+            if (parent == SCENE_NO_PARENT)
+                worlds_[i] = locals_[i];
+            else
+                Multiply(glm::value_ptr(worlds_[parent]), glm::value_ptr(locals_[i]), glm::value_ptr(worlds_[i]));
+
+            changed_[i] = generation_;
+            changed++;
+        }
+        return changed;
+    }
+
+    uint64_t Scene::Write(void* dst, size_t stride, uint64_t since) const {
+        uint8_t* out = static_cast<uint8_t*>(dst);
+
+#if defined(MVK_SCENE_SSE)
+        bool aligned = reinterpret_cast<uintptr_t>(dst) % 16 == 0 && stride % 16 == 0;
+        for (size_t i = 0; i < count_; ++i) {
+            if (changed_[i] <= since) continue;
+
+            float* target = reinterpret_cast<float*>(out + i * stride);
+            const float* source = glm::value_ptr(worlds_[i]);
+            if (aligned) {
+                for (int j = 0; j < 16; j += 4)
+                    _mm_stream_ps(target + j, _mm_loadu_ps(source + j));
+            } else {
+                std::memcpy(target, source, sizeof(glm::mat4));
+            }
+        }
+        // Streaming stores are weakly ordered; fence before the buffer is submitted.
+        _mm_sfence();
+#else
+        for (size_t i = 0; i < count_; ++i) {
+            if (changed_[i] > since)
+                std::memcpy(out + i * stride, glm::value_ptr(worlds_[i]), sizeof(glm::mat4));
+        }
+#endif
+
+        return generation_;
+    }
+
+    const glm::mat4& Scene::world(uint32_t node) const {
+        return worlds_[node];
+    }
+
+    uint32_t Scene::parent(uint32_t node) const {
+        return parents_[node];
+    }
+
+    size_t Scene::size() const {
+        return count_;
+    }
+
+    uint64_t Scene::generation() const {
+        return generation_;
+    }
+
+    // local = T * R * S. The 3x3 part is the rotation matrix of the quaternion with its
+    // columns scaled, the last column is the translation.
+    void Scene::UpdateLocals() {
+        for (size_t i = 0; i < count_; i += 4) {
+            uint32_t dirty;
+            std::memcpy(&dirty, &local_dirty_[i], sizeof(dirty));
+            if (!dirty) continue;
+
+#if defined(MVK_SCENE_SSE)
+            // Four nodes per iteration, one node per lane.
+            __m128 x = _mm_loadu_ps(&rx_[i]), y = _mm_loadu_ps(&ry_[i]), z = _mm_loadu_ps(&rz_[i]), w = _mm_loadu_ps(&rw_[i]);
+            __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+
+            __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+            __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+            __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+            __m128 sx = _mm_loadu_ps(&sx_[i]), sy = _mm_loadu_ps(&sy_[i]), sz = _mm_loadu_ps(&sz_[i]);
+
+            // Element (row, column) of the four matrices, column by column.
+            __m128 columns[4][4] = {
+                {_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+                 _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+                 _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+                 zero},
+                {_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+                 _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+                 _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+                 zero},
+                {_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+                 _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+                 _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+                 zero},
+                {_mm_loadu_ps(&tx_[i]), _mm_loadu_ps(&ty_[i]), _mm_loadu_ps(&tz_[i]), one}
+            };
+
+            // Transposing turns (element, lane) into (lane, element): one column per node.
+            for (int column = 0; column < 4; ++column) {
+                __m128 &e0 = columns[column][0], &e1 = columns[column][1], &e2 = columns[column][2], &e3 = columns[column][3];
+                _MM_TRANSPOSE4_PS(e0, e1, e2, e3);
+                _mm_storeu_ps(glm::value_ptr(locals_[i + 0]) + 4 * column, e0);
+                _mm_storeu_ps(glm::value_ptr(locals_[i + 1]) + 4 * column, e1);
+                _mm_storeu_ps(glm::value_ptr(locals_[i + 2]) + 4 * column, e2);
+                _mm_storeu_ps(glm::value_ptr(locals_[i + 3]) + 4 * column, e3);
+            }
+#else
+            for (size_t node = i; node < i + 4; ++node) {
+                glm::mat4 rotation = glm::mat4_cast(glm::quat(rw_[node], rx_[node], ry_[node], rz_[node]));
+                glm::mat4 &local = locals_[node];
+                local[0] = rotation[0] * sx_[node];
+                local[1] = rotation[1] * sy_[node];
+                local[2] = rotation[2] * sz_[node];
+                local[3] = glm::vec4(tx_[node], ty_[node], tz_[node], 1.0f);
+            }
+#endif
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef MVK_SCENE
+#define MVK_SCENE
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mvk {
+    constexpr uint32_t SCENE_NO_PARENT = UINT32_MAX;
+
+    // Transform hierarchy for many objects. Local transforms are kept as separate
+    // translation, rotation and scale arrays so that the local matrix kernel can build
+    // four (SSE) nodes at a time; world matrices are combined with SSE/AVX. A node's
+    // parent always comes before it, so one pass in index order visits parents before
+    // children and no sort is needed at update time.
+    //
+    // Setters mark a node dirty; Update recomputes dirty nodes and everything below
+    // them and stamps each changed world matrix with the update's generation, which
+    // lets Write copy only what a given GPU buffer has not seen yet.
+    class Scene {
+       public:
+        // parent must be SCENE_NO_PARENT or an existing node.
+        uint32_t AddNode(uint32_t parent = SCENE_NO_PARENT);
+        void Reserve(size_t count);
+        void Clear();
+
+        void SetTranslation(uint32_t node, const glm::vec3& translation);
+        void SetRotation(uint32_t node, const glm::quat& rotation);
+        void SetScale(uint32_t node, const glm::vec3& scale);
+
+        // Returns how many world matrices changed.
+        size_t Update();
+        // Stores every world matrix changed after generation since into dst, stride bytes
+        // apart, with non-temporal stores (dst is usually write-combined mapped memory).
+        // Returns the generation to pass as since next time; 0 writes everything.
+        uint64_t Write(void* dst, size_t stride, uint64_t since) const;
+
+        const glm::mat4& world(uint32_t node) const;
+        uint32_t parent(uint32_t node) const;
+        size_t size() const;
+        uint64_t generation() const;
+
+       private:
+        void UpdateLocals();
+
+        size_t count_ = 0;
+        uint64_t generation_ = 0;
+
+        // Padded to a multiple of 4 with identity transforms for the SIMD kernel.
+        std::vector<float> tx_, ty_, tz_;
+        std::vector<float> rx_, ry_, rz_, rw_;
+        std::vector<float> sx_, sy_, sz_;
+        std::vector<uint8_t> local_dirty_;
+
+        std::vector<uint32_t> parents_;
+        std::vector<uint8_t> world_dirty_;
+        std::vector<uint64_t> changed_;
+        std::vector<glm::mat4> locals_;
+        std::vector<glm::mat4> worlds_;
+    };
+}
+
+#endif  // MVK_SCENE
@@ -0,0 +1,58 @@
+#version 460
+
+layout(local_size_x = 64) in;
+
+struct ObjectData {
+    mat4 Transform;
+    vec4 Bounds;
+    uint Material;
+};
+
+struct DrawCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(std140, binding = 0) uniform CullParams {
+    mat4 Model;
+    vec4 Planes[6];
+    uint ObjectCount;
+} params;
+
+layout(std430, binding = 1) readonly buffer Objects {
+    ObjectData objects[];
+};
+
+layout(std430, binding = 2) readonly buffer Commands {
+    DrawCommand commands[];
+};
+
+layout(std430, binding = 3) writeonly buffer VisibleCommands {
+    DrawCommand visible[];
+};
+
+layout(std430, binding = 4) buffer VisibleCount {
+    uint visibleCount;
+};
+
+// Tests each object's bounding sphere against the world-space frustum planes and
+// appends the draws that survive; their order is not preserved.
+void main() {
+    uint id = gl_GlobalInvocationID.x;
+    if (id >= params.ObjectCount) return;
+
+    mat4 world = objects[id].Transform * params.Model;
+    vec3 center = (world * vec4(objects[id].Bounds.xyz, 1.0)).xyz;
+    float scale = max(length(world[0].xyz), max(length(world[1].xyz), length(world[2].xyz)));
+    float radius = objects[id].Bounds.w * scale;
+
+    for (int i = 0; i < 6; ++i) {
+        if (dot(params.Planes[i].xyz, center) + params.Planes[i].w < -radius)
+            return;
+    }
+
+    visible[atomicAdd(visibleCount, 1)] = commands[id];
+}
@@ -0,0 +1,31 @@
+# Turns a SPIR-V binary into a header with a constexpr uint32_t array.
+# Usage: cmake -DINPUT=<file.spv> -DOUTPUT=<file.h> -DVARIABLE=<NAME> -P EmbedSpirv.cmake
+
+file(READ ${INPUT} hex HEX)
+string(LENGTH "${hex}" hex_length)
+math(EXPR remainder "${hex_length} % 8")
+if(hex_length EQUAL 0 OR NOT remainder EQUAL 0)
+    message(FATAL_ERROR "${INPUT} is not a SPIR-V module")
+endif()
+
+# SPIR-V is a stream of little-endian words.
+string(REGEX REPLACE "([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])" "0x\\4\\3\\2\\1u," words "${hex}")
+string(REPEAT "0x[0-9a-f]+u," 8 line_pattern)
+string(REGEX REPLACE "(${line_pattern})" "\\1\n        " words "${words}")
+
+get_filename_component(source_name ${INPUT} NAME)
+file(WRITE ${OUTPUT}
+"// Generated from ${source_name} by EmbedSpirv.cmake. Do not edit.
+#ifndef MVK_SPIRV_${VARIABLE}
+#define MVK_SPIRV_${VARIABLE}
+
+#include <cstdint>
+
+namespace mvk {
+    inline constexpr uint32_t ${VARIABLE}[] = {
+        ${words}
+    };
+}
+
+#endif  // MVK_SPIRV_${VARIABLE}
+")
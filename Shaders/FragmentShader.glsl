@@ -1,12 +1,26 @@
 #version 460
+#extension GL_EXT_nonuniform_qualifier : require
 
-layout(binding = 1) uniform sampler2D texture_sampler;
+struct MaterialData {
+    uint BaseColorTexture;
+    vec4 BaseColorFactor;
+};
+
+// Bindless table (set 1): textures and materials are referenced by index.
+layout(set = 1, binding = 0) uniform sampler texture_sampler;
+layout(set = 1, binding = 1) uniform texture2D textures[];
+layout(std430, set = 1, binding = 2) readonly buffer Materials {
+    MaterialData materials[];
+};
 
 layout(location = 0) in vec3 FragColor;
 layout(location = 1) in vec2 FragTexPos;
+layout(location = 2) flat in uint FragMaterial;
 
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = vec4(texture(texture_sampler, FragTexPos).rgb, 1.0);
+    MaterialData material = materials[FragMaterial];
+    vec3 base_color = texture(sampler2D(textures[nonuniformEXT(material.BaseColorTexture)], texture_sampler), FragTexPos).rgb;
+    outColor = vec4(base_color * material.BaseColorFactor.rgb, 1.0);
 }
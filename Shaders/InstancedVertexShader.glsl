@@ -0,0 +1,27 @@
+#version 460
+
+layout(binding = 0) uniform MVP {
+    mat4 Model;
+    mat4 View;
+    mat4 Projection;
+} mvp;
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aColor;
+layout(location = 2) in vec2 aTexPos;
+
+// Per-instance stream (binding 1): a mat4 takes four consecutive locations.
+layout(location = 3) in mat4 iTransform;
+layout(location = 7) in uint iMaterial;
+
+layout(location = 0) out vec3 FragColor;
+layout(location = 1) out vec2 FragTexPos;
+layout(location = 2) flat out uint FragMaterial;
+
+void main() {
+    gl_Position = mvp.Projection * mvp.View * iTransform * mvp.Model * vec4(aPos, 1.0);
+    gl_PointSize = 10.0;
+    FragColor = aColor;
+    FragTexPos = aTexPos;
+    FragMaterial = iMaterial;
+}
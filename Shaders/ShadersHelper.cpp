@@ -1,5 +1,18 @@
 #include "ShadersHelper.h"
 
+#include <filesystem>
+#include <iterator>
+
+#include "VertexShader.spv.h"
+#include "FragmentShader.spv.h"
+#include "CullShader.spv.h"
+#include "InstancedVertexShader.spv.h"
+
+#ifdef MVK_SHADER_HOT_RELOAD
+    #include <shaderc/shaderc.hpp>
+    #include "SpirvCache.h"
+#endif
+
 namespace mvk {
     std::string mvk::ShadersHelper::ReadFromFile(const std::string file_name) {
         std::ifstream file(file_name);
@@ -11,7 +24,8 @@ namespace mvk {
     }
 
     vk::ShaderModuleCreateInfo mvk::ShadersHelper::LoadVertexShader() {
-        static auto vertex_code = LoadShader(VERTEX_SHADER_PATH, shaderc_vertex_shader, "VertexShader");
+        static auto vertex_code = LoadShader(AssetPaths::Asset(VERTEX_SHADER_PATH), vk::ShaderStageFlagBits::eVertex, "VertexShader",
+                                             VERTEX_SHADER_SPIRV, std::size(VERTEX_SHADER_SPIRV));
 
         vk::ShaderModuleCreateInfo vertex_info{};
         vertex_info.sType = vk::StructureType::eShaderModuleCreateInfo;
@@ -22,7 +36,8 @@ namespace mvk {
     }
 
     vk::ShaderModuleCreateInfo mvk::ShadersHelper::LoadFragmentShader() {
-        static auto fragment_code = LoadShader(FRAGMENT_SHADER_PATH, shaderc_fragment_shader, "FragmentShader");
+        static auto fragment_code = LoadShader(AssetPaths::Asset(FRAGMENT_SHADER_PATH), vk::ShaderStageFlagBits::eFragment, "FragmentShader",
+                                               FRAGMENT_SHADER_SPIRV, std::size(FRAGMENT_SHADER_SPIRV));
 
         vk::ShaderModuleCreateInfo fragment_info{};
         fragment_info.sType = vk::StructureType::eShaderModuleCreateInfo;
@@ -32,16 +47,87 @@ namespace mvk {
         return fragment_info;
     }
 
-    std::vector<uint32_t> ShadersHelper::LoadShader(const std::string file_name, const shaderc_shader_kind kind, const std::string name) {
+    vk::ShaderModuleCreateInfo mvk::ShadersHelper::LoadInstancedVertexShader() {
+        static auto vertex_code = LoadShader(AssetPaths::Asset(INSTANCED_VERTEX_SHADER_PATH), vk::ShaderStageFlagBits::eVertex, "InstancedVertexShader",
+                                             INSTANCED_VERTEX_SHADER_SPIRV, std::size(INSTANCED_VERTEX_SHADER_SPIRV));
+
+        vk::ShaderModuleCreateInfo vertex_info{};
+        vertex_info.sType = vk::StructureType::eShaderModuleCreateInfo;
+        vertex_info.setCodeSize(vertex_code.size() * sizeof(uint32_t));
+        vertex_info.setPCode(vertex_code.data());
+
+        return vertex_info;
+    }
+
+    vk::ShaderModuleCreateInfo mvk::ShadersHelper::LoadCullShader() {
+        static auto cull_code = LoadShader(AssetPaths::Asset(CULL_SHADER_PATH), vk::ShaderStageFlagBits::eCompute, "CullShader",
+                                           CULL_SHADER_SPIRV, std::size(CULL_SHADER_SPIRV));
+
+        vk::ShaderModuleCreateInfo cull_info{};
+        cull_info.sType = vk::StructureType::eShaderModuleCreateInfo;
+        cull_info.setCodeSize(cull_code.size() * sizeof(uint32_t));
+        cull_info.setPCode(cull_code.data());
+
+        return cull_info;
+    }
+
+    std::vector<uint32_t> ShadersHelper::LoadShader(const std::string file_name, vk::ShaderStageFlagBits stage, const std::string name,
+                                                    const uint32_t* embedded, size_t embedded_words, const ShaderDefines& defines) {
+    #ifdef MVK_SHADER_HOT_RELOAD
+        std::error_code error;
+        if (std::filesystem::exists(file_name, error)) {
+            try {
+                return CompileShader(ReadFromFile(file_name), stage, name, defines);
+            } catch (const std::exception& e) {
+                std::cout << "\u001b[33mWARNING: " << e.what() << " Using the embedded SPIR-V.\u001b[0m\n";
+            }
+        }
+    #endif
+
+        return std::vector<uint32_t>(embedded, embedded + embedded_words);
+    }
+
+#ifdef MVK_SHADER_HOT_RELOAD
+    std::vector<uint32_t> ShadersHelper::CompileShader(const std::string& source, vk::ShaderStageFlagBits stage, const std::string& name, const ShaderDefines& defines) {
+        // Must match the glslc flags used for the embedded SPIR-V in CMakeLists.txt.
+        const char* stage_name = "frag";
+        shaderc_shader_kind kind = shaderc_fragment_shader;
+        if (stage == vk::ShaderStageFlagBits::eVertex) {
+            stage_name = "vert";
+            kind = shaderc_vertex_shader;
+        } else if (stage == vk::ShaderStageFlagBits::eCompute) {
+            stage_name = "comp";
+            kind = shaderc_compute_shader;
+        }
+        const std::string options_key = std::string("-Os ") + stage_name;
+
+        std::string defines_key;
+        for (auto &define : defines)
+            defines_key += define.first + "=" + define.second + ";";
+
+        std::string key = SpirvCache::Key(source, defines_key, options_key);
+        std::vector<uint32_t> spirv;
+        if (SpirvCache::Load(AssetPaths::Output(SHADER_CACHE_DIR), key, spirv))
+            return spirv;
+
         shaderc::Compiler compiler;
         shaderc::CompileOptions options;
         options.SetOptimizationLevel(shaderc_optimization_level_size);
+        for (auto &define : defines)
+            options.AddMacroDefinition(define.first, define.second);
 
-        shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(ShadersHelper::ReadFromFile(file_name), kind, name.c_str(), options);
+        shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(source, kind, name.c_str(), options);
 
         if (module.GetCompilationStatus() != shaderc_compilation_status_success)
-            throw std::runtime_error("Shaders cannot be compiled. :" + file_name);
-        
-        return std::vector<uint32_t>(module.cbegin(), module.cend());
+            throw std::runtime_error("Shaders cannot be compiled. :" + name + "\n" + module.GetErrorMessage());
+
+        spirv.assign(module.cbegin(), module.cend());
+        SpirvCache::Store(AssetPaths::Output(SHADER_CACHE_DIR), key, spirv);
+        return spirv;
+    }
+#else
+    std::vector<uint32_t> ShadersHelper::CompileShader(const std::string&, vk::ShaderStageFlagBits, const std::string& name, const ShaderDefines&) {
+        throw std::runtime_error("Runtime shader compilation is disabled, rebuild with MVK_SHADER_HOT_RELOAD: " + name);
     }
+#endif
 }
@@ -4,21 +4,34 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.hpp>
-#include <shaderc/shaderc.hpp>
 
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <utility>
+#include <vector>
 
 #include "../MVKConstants.h"
 
 namespace mvk {
+    using ShaderDefines = std::vector<std::pair<std::string, std::string>>;
+
+    // Shaders are compiled to SPIR-V at build time and embedded in the binary.
+    // With MVK_SHADER_HOT_RELOAD the GLSL sources are compiled at runtime instead
+    // whenever they can be found, going through SpirvCache so unchanged sources
+    // skip the compiler.
     class ShadersHelper {
        public:
         static std::string ReadFromFile(const std::string file_name);
         static vk::ShaderModuleCreateInfo LoadVertexShader();
         static vk::ShaderModuleCreateInfo LoadFragmentShader();
-        static std::vector<uint32_t> LoadShader(const std::string file_name, const shaderc_shader_kind kind, const std::string name);
+        static vk::ShaderModuleCreateInfo LoadInstancedVertexShader();
+        static vk::ShaderModuleCreateInfo LoadCullShader();
+        static std::vector<uint32_t> LoadShader(const std::string file_name, vk::ShaderStageFlagBits stage, const std::string name,
+                                                const uint32_t* embedded, size_t embedded_words, const ShaderDefines& defines = {});
+
+       private:
+        static std::vector<uint32_t> CompileShader(const std::string& source, vk::ShaderStageFlagBits stage, const std::string& name, const ShaderDefines& defines);
 };
 }
 
@@ -0,0 +1,65 @@
+#include "SpirvCache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "../Fnv1a/Fnv1a.h"
+
+static constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+
+static uint64_t Hash(const std::string& data, uint64_t hash) {
+    return mvk::Fnv1a::Hash(data.data(), data.size(), hash);
+}
+
+namespace mvk {
+    std::string SpirvCache::Key(const std::string& source, const std::string& defines, const std::string& options) {
+        // The separators keep "ab" + "c" and "a" + "bc" apart.
+        uint64_t hash = Hash(source, 0);
+        hash = Hash(std::string(1, '\0') + defines, hash);
+        hash = Hash(std::string(1, '\0') + options, hash);
+
+        char key[17];
+        std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+        return key;
+    }
+
+    bool SpirvCache::Load(const std::string& directory, const std::string& key, std::vector<uint32_t>& spirv) {
+        std::filesystem::path path = std::filesystem::path(directory) / (key + ".spv");
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+
+        std::streamsize size = file.tellg();
+        if (size < static_cast<std::streamsize>(sizeof(uint32_t)) || size % sizeof(uint32_t) != 0)
+            return false;
+
+        spirv.resize(size / sizeof(uint32_t));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(spirv.data()), size) || spirv[0] != SPIRV_MAGIC) {
+            spirv.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    void SpirvCache::Store(const std::string& directory, const std::string& key, const std::vector<uint32_t>& spirv) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+
+        std::filesystem::path path = std::filesystem::path(directory) / (key + ".spv");
+        std::filesystem::path temp_path = path;
+        temp_path += ".tmp";
+
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return;
+            file.write(reinterpret_cast<const char*>(spirv.data()), spirv.size() * sizeof(uint32_t));
+            if (!file.good()) return;
+        }
+
+        std::filesystem::rename(temp_path, path, error);
+        if (error)
+            std::filesystem::remove(temp_path, error);
+    }
+}
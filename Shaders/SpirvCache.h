@@ -0,0 +1,20 @@
+#ifndef MVK_SPIRV_CACHE
+#define MVK_SPIRV_CACHE
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mvk {
+    // Compiled SPIR-V on disk, one file per key. The key hashes everything that
+    // changes the output, so an edited source or a new define never hits a stale entry.
+    class SpirvCache {
+       public:
+        static std::string Key(const std::string& source, const std::string& defines, const std::string& options);
+
+        static bool Load(const std::string& directory, const std::string& key, std::vector<uint32_t>& spirv);
+        static void Store(const std::string& directory, const std::string& key, const std::vector<uint32_t>& spirv);
+    };
+}
+
+#endif  // MVK_SPIRV_CACHE
@@ -6,16 +6,29 @@ layout(binding = 0) uniform MVP {
     mat4 Projection;
 } mvp;
 
+struct ObjectData {
+    mat4 Transform;
+    vec4 Bounds;
+    uint Material;
+};
+
+// Draws pass the object index as firstInstance.
+layout(std430, binding = 2) readonly buffer Objects {
+    ObjectData objects[];
+};
+
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aColor;
 layout(location = 2) in vec2 aTexPos;
 
 layout(location = 0) out vec3 FragColor;
 layout(location = 1) out vec2 FragTexPos;
+layout(location = 2) flat out uint FragMaterial;
 
 void main() {
-    gl_Position = mvp.Projection * mvp.View * mvp.Model * vec4(aPos, 1.0);
+    gl_Position = mvp.Projection * mvp.View * objects[gl_InstanceIndex].Transform * mvp.Model * vec4(aPos, 1.0);
     gl_PointSize = 10.0;
     FragColor = aColor;
     FragTexPos = aTexPos;
+    FragMaterial = objects[gl_InstanceIndex].Material;
 }
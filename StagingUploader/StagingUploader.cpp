@@ -0,0 +1,479 @@
+#include "StagingUploader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+static constexpr vk::DeviceSize STAGING_ALIGNMENT = 16;
+
+static vk::DeviceSize AlignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+namespace mvk {
+    void StagingUploader::Init(vk::Device device, DeviceMemoryAllocator& allocator,
+                               vk::Queue transfer_queue, uint32_t transfer_family,
+                               vk::Queue graphics_queue, uint32_t graphics_family,
+                               vk::DeviceSize capacity) {
+        device_ = device;
+        allocator_ = &allocator;
+        transfer_queue_ = transfer_queue;
+        graphics_queue_ = graphics_queue;
+        transfer_family_ = transfer_family;
+        graphics_family_ = graphics_family;
+        ownership_transfer_ = transfer_family != graphics_family;
+        capacity_ = capacity;
+        head_ = tail_ = in_use_ = 0;
+
+        vk::CommandPoolCreateInfo cmd_pool_info{};
+        cmd_pool_info.sType = vk::StructureType::eCommandPoolCreateInfo;
+        cmd_pool_info.setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient);
+        cmd_pool_info.setQueueFamilyIndex(transfer_family);
+        command_pool_ = device_.createCommandPool(cmd_pool_info);
+
+        if (ownership_transfer_) {
+            cmd_pool_info.setQueueFamilyIndex(graphics_family);
+            acquire_pool_ = device_.createCommandPool(cmd_pool_info);
+        }
+
+        vk::BufferCreateInfo buffer_info{};
+        buffer_info.sType = vk::StructureType::eBufferCreateInfo;
+        buffer_info.setSize(capacity_);
+        buffer_info.setUsage(vk::BufferUsageFlagBits::eTransferSrc);
+        buffer_info.setSharingMode(vk::SharingMode::eExclusive);
+        buffer_ = device_.createBuffer(buffer_info);
+
+        vk::MemoryRequirements mem_reqs = device_.getBufferMemoryRequirements(buffer_);
+        allocation_ = allocator_->Allocate(mem_reqs,
+                                           vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                                           ResourceKind::eLinear);
+        device_.bindBufferMemory(buffer_, allocation_.memory, allocation_.offset);
+    }
+
+    void StagingUploader::Destroy() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (recording_)
+            FlushLocked();
+        while (!in_flight_.empty())
+            CollectLocked(true);
+
+        for (auto &batch : free_batches_) {
+            device_.destroyFence(batch.fence);
+            if (batch.transfer_done)
+                device_.destroySemaphore(batch.transfer_done);
+        }
+        free_batches_.clear();
+
+        device_.destroyCommandPool(command_pool_);
+        if (acquire_pool_)
+            device_.destroyCommandPool(acquire_pool_);
+        device_.destroyBuffer(buffer_);
+        allocator_->Free(allocation_);
+    }
+
+    void StagingUploader::UploadBuffer(vk::Buffer dst, vk::DeviceSize dst_offset, const void* data, vk::DeviceSize size) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        for (vk::DeviceSize done = 0; done < size;) {
+            vk::DeviceSize chunk = std::min(size - done, capacity_);
+            vk::DeviceSize offset;
+            uint8_t* staging = Reserve(chunk, STAGING_ALIGNMENT, offset);
+            std::memcpy(staging, src + done, chunk);
+
+            vk::BufferCopy buff_copy{};
+            buff_copy.setSrcOffset(offset);
+            buff_copy.setDstOffset(dst_offset + done);
+            buff_copy.setSize(chunk);
+            CurrentCommandBuffer().copyBuffer(buffer_, dst, 1, &buff_copy);
+            if (ownership_transfer_)
+                ReleaseBuffer(dst, dst_offset + done, chunk);
+
+            done += chunk;
+        }
+    }
+
+    void StagingUploader::UploadImage(vk::Image dst, uint32_t width, uint32_t height, uint32_t texel_size, const void* data,
+                                      vk::ImageLayout final_layout) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        vk::ImageMemoryBarrier memory_barrier{};
+        memory_barrier.sType = vk::StructureType::eImageMemoryBarrier;
+        memory_barrier.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+        memory_barrier.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+        memory_barrier.setImage(dst);
+        memory_barrier.setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
+        memory_barrier.setOldLayout(vk::ImageLayout::eUndefined);
+        memory_barrier.setNewLayout(vk::ImageLayout::eTransferDstOptimal);
+        memory_barrier.setSrcAccessMask(vk::AccessFlagBits::eNone);
+        memory_barrier.setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
+
+        CurrentCommandBuffer().pipelineBarrier(
+            vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+            vk::DependencyFlags(),
+            0, nullptr,
+            0, nullptr,
+            1, &memory_barrier
+        );
+
+        CopyLevel(dst, 0, width, height, texel_size, {1, 1}, data);
+        FinishImage(dst, 0, 1, final_layout);
+    }
+
+    void StagingUploader::UploadImageLevels(vk::Image dst, const std::vector<ImageLevel>& levels, uint32_t block_size,
+                                            vk::ImageLayout final_layout, vk::Extent2D block_extent, uint32_t first_level) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t mip_levels = static_cast<uint32_t>(levels.size());
+
+        vk::ImageMemoryBarrier memory_barrier{};
+        memory_barrier.sType = vk::StructureType::eImageMemoryBarrier;
+        memory_barrier.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+        memory_barrier.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+        memory_barrier.setImage(dst);
+        memory_barrier.setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, first_level, mip_levels, 0, 1));
+        memory_barrier.setOldLayout(vk::ImageLayout::eUndefined);
+        memory_barrier.setNewLayout(vk::ImageLayout::eTransferDstOptimal);
+        memory_barrier.setSrcAccessMask(vk::AccessFlagBits::eNone);
+        memory_barrier.setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
+
+        CurrentCommandBuffer().pipelineBarrier(
+            vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+            vk::DependencyFlags(),
+            0, nullptr,
+            0, nullptr,
+            1, &memory_barrier
+        );
+
+        for (uint32_t level = 0; level < mip_levels; ++level)
+            CopyLevel(dst, first_level + level, levels[level].width, levels[level].height, block_size, block_extent, levels[level].data);
+
+        FinishImage(dst, first_level, mip_levels, final_layout);
+    }
+
+    // Large levels are copied in bands of whole block rows so they never need more than the ring.
+    void StagingUploader::CopyLevel(vk::Image dst, uint32_t level, uint32_t width, uint32_t height, uint32_t block_size,
+                                    vk::Extent2D block_extent, const void* data) {
+        uint32_t blocks_x = (width + block_extent.width - 1) / block_extent.width;
+        uint32_t blocks_y = (height + block_extent.height - 1) / block_extent.height;
+        vk::DeviceSize row_size = static_cast<vk::DeviceSize>(blocks_x) * block_size;
+        if (row_size > capacity_)
+            throw std::runtime_error("Image row does not fit into the staging ring.");
+
+        uint32_t rows_per_chunk = static_cast<uint32_t>(std::min<vk::DeviceSize>(capacity_ / row_size, blocks_y));
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        for (uint32_t row = 0; row < blocks_y; row += rows_per_chunk) {
+            uint32_t rows = std::min(rows_per_chunk, blocks_y - row);
+            // The last band of a level may end inside a block.
+            uint32_t first_texel_row = row * block_extent.height;
+            uint32_t texel_rows = std::min(rows * block_extent.height, height - first_texel_row);
+            vk::DeviceSize offset;
+            uint8_t* staging = Reserve(rows * row_size, STAGING_ALIGNMENT, offset);
+            std::memcpy(staging, src + row * row_size, rows * row_size);
+
+            vk::BufferImageCopy image_copy{};
+            image_copy.setBufferOffset(offset);
+            image_copy.setBufferRowLength(0);
+            image_copy.setBufferImageHeight(0);
+            image_copy.setImageSubresource({vk::ImageAspectFlagBits::eColor, level, 0, 1});
+            image_copy.setImageOffset({0, static_cast<int32_t>(first_texel_row), 0});
+            image_copy.setImageExtent({width, texel_rows, 1});
+
+            CurrentCommandBuffer().copyBufferToImage(buffer_, dst, vk::ImageLayout::eTransferDstOptimal, 1, &image_copy);
+        }
+    }
+
+    void StagingUploader::FinishImage(vk::Image dst, uint32_t first_level, uint32_t mip_levels, vk::ImageLayout final_layout) {
+        if (ownership_transfer_) {
+            ReleaseImage(dst, first_level, mip_levels, final_layout, vk::AccessFlagBits::eShaderRead);
+            return;
+        }
+
+        vk::ImageMemoryBarrier memory_barrier{};
+        memory_barrier.sType = vk::StructureType::eImageMemoryBarrier;
+        memory_barrier.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+        memory_barrier.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+        memory_barrier.setImage(dst);
+        memory_barrier.setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, first_level, mip_levels, 0, 1));
+        memory_barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal);
+        memory_barrier.setNewLayout(final_layout);
+        memory_barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+        memory_barrier.setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+        CurrentCommandBuffer().pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
+            vk::DependencyFlags(),
+            0, nullptr,
+            0, nullptr,
+            1, &memory_barrier
+        );
+    }
+
+    UploadTicket StagingUploader::Flush() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return FlushLocked();
+    }
+
+    bool StagingUploader::IsComplete(UploadTicket ticket) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CollectLocked(false);
+        return ticket <= completed_ticket_;
+    }
+
+    void StagingUploader::Wait(UploadTicket ticket) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (recording_ && ticket >= current_.ticket)
+            FlushLocked();
+        while (completed_ticket_ < ticket && !in_flight_.empty())
+            CollectLocked(true);
+    }
+
+    void StagingUploader::Collect() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CollectLocked(false);
+    }
+
+    uint8_t* StagingUploader::Reserve(vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize& offset) {
+        while (!TryReserve(size, alignment, offset)) {
+            // Out of ring space: submit what is pending and wait for the oldest batch.
+            if (recording_ && current_.ring_bytes > 0)
+                FlushLocked();
+            if (in_flight_.empty())
+                throw std::runtime_error("Upload does not fit into the staging ring.");
+            CollectLocked(true);
+        }
+
+        return static_cast<uint8_t*>(allocation_.mapped) + offset;
+    }
+
+    bool StagingUploader::TryReserve(vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize& offset) {
+        if (in_use_ == 0)
+            head_ = tail_ = 0;
+        else if (head_ == tail_)
+            return false;
+
+        vk::DeviceSize aligned = AlignUp(head_, alignment);
+        vk::DeviceSize consumed = 0;
+
+        if (head_ >= tail_) {
+            // Free space is [head, capacity) followed by [0, tail).
+            if (aligned + size <= capacity_) {
+                offset = aligned;
+                consumed = aligned + size - head_;
+            } else if (size <= tail_) {
+                offset = 0;
+                consumed = capacity_ - head_ + size;
+            } else {
+                return false;
+            }
+        } else {
+            if (aligned + size > tail_) return false;
+            offset = aligned;
+            consumed = aligned + size - head_;
+        }
+
+        head_ = offset + size;
+        in_use_ += consumed;
+
+        CurrentCommandBuffer();
+        current_.ring_bytes += consumed;
+        return true;
+    }
+
+    vk::CommandBuffer StagingUploader::CurrentCommandBuffer() {
+        if (recording_) return current_.cmd_buffer;
+
+        if (!free_batches_.empty()) {
+            current_ = free_batches_.back();
+            free_batches_.pop_back();
+
+            if (device_.resetFences(1, &current_.fence) != vk::Result::eSuccess)
+                throw std::runtime_error("Cannot reset upload fence.");
+        } else {
+            vk::CommandBufferAllocateInfo alloc_info{};
+            alloc_info.sType = vk::StructureType::eCommandBufferAllocateInfo;
+            alloc_info.setLevel(vk::CommandBufferLevel::ePrimary);
+            alloc_info.setCommandPool(command_pool_);
+            alloc_info.setCommandBufferCount(1);
+
+            current_ = Batch{};
+            if (device_.allocateCommandBuffers(&alloc_info, &current_.cmd_buffer) != vk::Result::eSuccess)
+                throw std::runtime_error("Cannot allocate upload command buffer.");
+
+            if (ownership_transfer_) {
+                alloc_info.setCommandPool(acquire_pool_);
+                if (device_.allocateCommandBuffers(&alloc_info, &current_.acquire_buffer) != vk::Result::eSuccess)
+                    throw std::runtime_error("Cannot allocate acquire command buffer.");
+
+                vk::SemaphoreCreateInfo sem_info{};
+                sem_info.sType = vk::StructureType::eSemaphoreCreateInfo;
+                current_.transfer_done = device_.createSemaphore(sem_info);
+            }
+
+            vk::FenceCreateInfo fence_info{};
+            fence_info.sType = vk::StructureType::eFenceCreateInfo;
+            current_.fence = device_.createFence(fence_info);
+        }
+
+        current_.ticket = next_ticket_++;
+        current_.ring_bytes = 0;
+
+        vk::CommandBufferBeginInfo begin_info{};
+        begin_info.sType = vk::StructureType::eCommandBufferBeginInfo;
+        begin_info.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+        current_.cmd_buffer.begin(begin_info);
+
+        recording_ = true;
+        return current_.cmd_buffer;
+    }
+
+    void StagingUploader::ReleaseBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size) {
+        vk::BufferMemoryBarrier release{};
+        release.sType = vk::StructureType::eBufferMemoryBarrier;
+        release.setSrcQueueFamilyIndex(transfer_family_);
+        release.setDstQueueFamilyIndex(graphics_family_);
+        release.setBuffer(buffer);
+        release.setOffset(offset);
+        release.setSize(size);
+        release.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+        release.setDstAccessMask(vk::AccessFlagBits::eNone);
+
+        current_.cmd_buffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
+            vk::DependencyFlags(),
+            0, nullptr,
+            1, &release,
+            0, nullptr
+        );
+
+        vk::BufferMemoryBarrier acquire = release;
+        acquire.setSrcAccessMask(vk::AccessFlagBits::eNone);
+        acquire.setDstAccessMask(vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead |
+                                 vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead);
+        current_.buffer_acquires.push_back(acquire);
+    }
+
+    void StagingUploader::ReleaseImage(vk::Image image, uint32_t first_level, uint32_t mip_levels, vk::ImageLayout final_layout,
+                                       vk::AccessFlags dst_access) {
+        // Both halves carry the same layout transition; it is performed once.
+        vk::ImageMemoryBarrier release{};
+        release.sType = vk::StructureType::eImageMemoryBarrier;
+        release.setSrcQueueFamilyIndex(transfer_family_);
+        release.setDstQueueFamilyIndex(graphics_family_);
+        release.setImage(image);
+        release.setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, first_level, mip_levels, 0, 1));
+        release.setOldLayout(vk::ImageLayout::eTransferDstOptimal);
+        release.setNewLayout(final_layout);
+        release.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+        release.setDstAccessMask(vk::AccessFlagBits::eNone);
+
+        current_.cmd_buffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
+            vk::DependencyFlags(),
+            0, nullptr,
+            0, nullptr,
+            1, &release
+        );
+
+        vk::ImageMemoryBarrier acquire = release;
+        acquire.setSrcAccessMask(vk::AccessFlagBits::eNone);
+        acquire.setDstAccessMask(dst_access);
+        current_.image_acquires.push_back(acquire);
+    }
+
+    UploadTicket StagingUploader::FlushLocked() {
+        if (!recording_) return next_ticket_ - 1;
+
+        if (!ownership_transfer_) {
+            // Buffer copies become visible to every later vertex, index and shader read on this queue.
+            vk::MemoryBarrier memory_barrier{};
+            memory_barrier.sType = vk::StructureType::eMemoryBarrier;
+            memory_barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+            memory_barrier.setDstAccessMask(vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead |
+                                            vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead);
+            current_.cmd_buffer.pipelineBarrier(
+                vk::PipelineStageFlagBits::eTransfer,
+                vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader,
+                vk::DependencyFlags(),
+                1, &memory_barrier,
+                0, nullptr,
+                0, nullptr
+            );
+        }
+        current_.cmd_buffer.end();
+
+        vk::SubmitInfo submit{};
+        submit.sType = vk::StructureType::eSubmitInfo;
+        submit.setCommandBufferCount(1);
+        submit.setPCommandBuffers(&current_.cmd_buffer);
+
+        if (!ownership_transfer_) {
+            if (transfer_queue_.submit(1, &submit, current_.fence) != vk::Result::eSuccess)
+                throw std::runtime_error("Cannot submit upload batch.");
+        } else {
+            submit.setSignalSemaphoreCount(1);
+            submit.setPSignalSemaphores(&current_.transfer_done);
+
+            if (transfer_queue_.submit(1, &submit, VK_NULL_HANDLE) != vk::Result::eSuccess)
+                throw std::runtime_error("Cannot submit upload batch.");
+
+            // Graphics takes ownership before any frame submitted after this point reads the data.
+            vk::CommandBufferBeginInfo begin_info{};
+            begin_info.sType = vk::StructureType::eCommandBufferBeginInfo;
+            begin_info.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+            current_.acquire_buffer.begin(begin_info);
+            current_.acquire_buffer.pipelineBarrier(
+                vk::PipelineStageFlagBits::eAllCommands,
+                vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader,
+                vk::DependencyFlags(),
+                0, nullptr,
+                static_cast<uint32_t>(current_.buffer_acquires.size()), current_.buffer_acquires.data(),
+                static_cast<uint32_t>(current_.image_acquires.size()), current_.image_acquires.data()
+            );
+            current_.acquire_buffer.end();
+
+            vk::PipelineStageFlags wait_stage = vk::PipelineStageFlagBits::eAllCommands;
+            vk::SubmitInfo acquire_submit{};
+            acquire_submit.sType = vk::StructureType::eSubmitInfo;
+            acquire_submit.setWaitSemaphoreCount(1);
+            acquire_submit.setPWaitSemaphores(&current_.transfer_done);
+            acquire_submit.setPWaitDstStageMask(&wait_stage);
+            acquire_submit.setCommandBufferCount(1);
+            acquire_submit.setPCommandBuffers(&current_.acquire_buffer);
+
+            // The fence sits on the acquire submission, which cannot finish before the copies do.
+            if (graphics_queue_.submit(1, &acquire_submit, current_.fence) != vk::Result::eSuccess)
+                throw std::runtime_error("Cannot submit upload acquire batch.");
+        }
+
+        current_.ring_end = head_;
+        in_flight_.push_back(current_);
+        recording_ = false;
+        return current_.ticket;
+    }
+
+    void StagingUploader::CollectLocked(bool wait_oldest) {
+        if (wait_oldest && !in_flight_.empty()) {
+            if (device_.waitForFences(1, &in_flight_.front().fence, VK_TRUE, UINT64_MAX) != vk::Result::eSuccess)
+                throw std::runtime_error("Cannot wait for upload fence.");
+        }
+
+        // Batches are submitted to one queue, so they retire in order.
+        while (!in_flight_.empty() && device_.getFenceStatus(in_flight_.front().fence) == vk::Result::eSuccess) {
+            Batch batch = in_flight_.front();
+            in_flight_.pop_front();
+
+            tail_ = batch.ring_end;
+            in_use_ -= batch.ring_bytes;
+            completed_ticket_ = batch.ticket;
+
+            batch.cmd_buffer.reset();
+            if (batch.acquire_buffer)
+                batch.acquire_buffer.reset();
+            batch.buffer_acquires.clear();
+            batch.image_acquires.clear();
+            free_batches_.push_back(batch);
+        }
+    }
+}
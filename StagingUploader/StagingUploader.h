@@ -0,0 +1,113 @@
+#ifndef MVK_STAGING_UPLOADER
+#define MVK_STAGING_UPLOADER
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "../MemoryAllocator/DeviceMemoryAllocator.h"
+
+namespace mvk {
+    using UploadTicket = uint64_t;
+
+    // One tightly packed mip level, see StagingUploader::UploadImageLevels.
+    struct ImageLevel {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        const void* data = nullptr;
+    };
+
+    // One persistently mapped staging buffer used as a ring. Upload* copies the
+    // data into the ring and records the GPU copy into the current batch; Flush
+    // submits the whole batch with a single fence. Ring space is reclaimed once
+    // the batch fence signals, so nothing waits on the queue.
+    //
+    // When the transfer family differs from the graphics family, copies run on the
+    // transfer queue and every destination is released to the graphics family. The
+    // matching acquire barriers go to the graphics queue behind a semaphore wait.
+    class StagingUploader {
+       public:
+        static constexpr vk::DeviceSize DEFAULT_CAPACITY = 32ull * 1024 * 1024;
+
+        void Init(vk::Device device, DeviceMemoryAllocator& allocator,
+                  vk::Queue transfer_queue, uint32_t transfer_family,
+                  vk::Queue graphics_queue, uint32_t graphics_family,
+                  vk::DeviceSize capacity = DEFAULT_CAPACITY);
+        void Destroy();
+
+        // Uploads larger than the ring are split into several copies.
+        void UploadBuffer(vk::Buffer dst, vk::DeviceSize dst_offset, const void* data, vk::DeviceSize size);
+        // Tightly packed texels of a single-level image. The image goes from eUndefined to final_layout.
+        void UploadImage(vk::Image dst, uint32_t width, uint32_t height, uint32_t texel_size, const void* data,
+                         vk::ImageLayout final_layout);
+        // Copies already generated mip levels; levels[i] goes to mip level first_level + i.
+        // Only those levels go from eUndefined to final_layout, the rest of the image is
+        // left alone. Block-compressed levels pass the bytes per block as block_size and
+        // the block dimensions in texels as block_extent; rows of blocks are tightly packed.
+        void UploadImageLevels(vk::Image dst, const std::vector<ImageLevel>& levels, uint32_t block_size,
+                               vk::ImageLayout final_layout, vk::Extent2D block_extent = {1, 1}, uint32_t first_level = 0);
+
+        // Submits everything recorded since the last Flush. Returns the ticket of that batch.
+        UploadTicket Flush();
+        bool IsComplete(UploadTicket ticket);
+        void Wait(UploadTicket ticket);
+
+        // Retires finished batches and returns their ring space.
+        void Collect();
+
+       private:
+        struct Batch {
+            vk::CommandBuffer cmd_buffer;
+            vk::CommandBuffer acquire_buffer;
+            vk::Semaphore transfer_done;
+            vk::Fence fence;
+            std::vector<vk::BufferMemoryBarrier> buffer_acquires;
+            std::vector<vk::ImageMemoryBarrier> image_acquires;
+            UploadTicket ticket = 0;
+            vk::DeviceSize ring_end = 0;
+            vk::DeviceSize ring_bytes = 0;
+        };
+
+        uint8_t* Reserve(vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize& offset);
+        bool TryReserve(vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize& offset);
+        vk::CommandBuffer CurrentCommandBuffer();
+        void ReleaseBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size);
+        void ReleaseImage(vk::Image image, uint32_t first_level, uint32_t mip_levels, vk::ImageLayout final_layout,
+                          vk::AccessFlags dst_access);
+        void CopyLevel(vk::Image dst, uint32_t level, uint32_t width, uint32_t height, uint32_t block_size,
+                       vk::Extent2D block_extent, const void* data);
+        void FinishImage(vk::Image dst, uint32_t first_level, uint32_t mip_levels, vk::ImageLayout final_layout);
+        UploadTicket FlushLocked();
+        void CollectLocked(bool wait_oldest);
+
+        vk::Device device_;
+        DeviceMemoryAllocator* allocator_ = nullptr;
+        vk::Queue transfer_queue_;
+        vk::Queue graphics_queue_;
+        uint32_t transfer_family_ = 0;
+        uint32_t graphics_family_ = 0;
+        bool ownership_transfer_ = false;
+        vk::CommandPool command_pool_;
+        vk::CommandPool acquire_pool_;
+
+        vk::Buffer buffer_;
+        Allocation allocation_;
+        vk::DeviceSize capacity_ = 0;
+        vk::DeviceSize head_ = 0;
+        vk::DeviceSize tail_ = 0;
+        vk::DeviceSize in_use_ = 0;
+
+        Batch current_;
+        bool recording_ = false;
+        std::deque<Batch> in_flight_;
+        std::vector<Batch> free_batches_;
+        UploadTicket next_ticket_ = 1;
+        UploadTicket completed_ticket_ = 0;
+        std::mutex mutex_;
+    };
+}
+
+#endif  // MVK_STAGING_UPLOADER
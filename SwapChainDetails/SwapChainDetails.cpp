@@ -16,13 +16,22 @@ namespace mvk {
         return this->format_[0];
     }
     
-    vk::PresentModeKHR SwapChainDetails::ChooseSwapPresentMode() {
+    vk::PresentModeKHR SwapChainDetails::ChooseSwapPresentMode(vk::PresentModeKHR preferred) {
         for (auto &mode : this->present_modes_)
-            if (mode == vk::PresentModeKHR::eMailbox)
+            if (mode == preferred)
                 return mode;
 
         return vk::PresentModeKHR::eFifo;
     }
+
+    uint32_t SwapChainDetails::ChooseImageCount(uint32_t requested) {
+        uint32_t image_count = requested == 0 ? this->capabilities_.minImageCount + 1 : requested;
+        image_count = std::max(image_count, this->capabilities_.minImageCount);
+        if (this->capabilities_.maxImageCount > 0)
+            image_count = std::min(image_count, this->capabilities_.maxImageCount);
+
+        return image_count;
+    }
     
     vk::Extent2D SwapChainDetails::ChooseSwapExtent(GLFWwindow* window) {
         if (this->capabilities_.currentExtent.width != std::numeric_limits<uint32_t>::max())
@@ -5,6 +5,7 @@
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <limits>
 
@@ -14,7 +15,10 @@ namespace mvk {
         SwapChainDetails(vk::PhysicalDevice device, vk::SurfaceKHR surface);
 
         vk::SurfaceFormatKHR ChooseSwapSurfaceFormat();
-        vk::PresentModeKHR ChooseSwapPresentMode();
+        // preferred when the surface offers it, otherwise FIFO, which every surface supports.
+        vk::PresentModeKHR ChooseSwapPresentMode(vk::PresentModeKHR preferred);
+        // requested clamped to the surface limits; 0 asks for one more than the minimum.
+        uint32_t ChooseImageCount(uint32_t requested);
         vk::Extent2D ChooseSwapExtent(GLFWwindow* window);
 
         vk::SurfaceCapabilitiesKHR capabilities_;
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../MemoryAllocator/AllocationStrategy.h"
+
+// Allocate/free, coalescing, alignment and exhaustion of the CPU-side strategies.
+// Prints every failed check and exits non-zero if there was one.
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                       \
+    do {                                                                                       \
+        if (!(condition)) {                                                                    \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n";    \
+            failures++;                                                                        \
+        }                                                                                      \
+    } while (0)
+
+static bool Throws(mvk::AllocationStrategy& strategy, uint64_t offset) {
+    try {
+        strategy.Free(offset);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// Every free range is one block again once all allocations are gone.
+static void CheckEmpty(const mvk::AllocationStrategy& strategy, uint64_t capacity) {
+    mvk::AllocationStatistics stats = strategy.GetStatistics();
+    CHECK(stats.allocation_count == 0);
+    CHECK(stats.used_bytes == 0);
+    CHECK(stats.free_bytes == capacity);
+    CHECK(stats.largest_free_block == capacity);
+    CHECK(stats.free_block_count == 1);
+    CHECK(stats.Fragmentation() == 0.0f);
+}
+
+static void TestLinear() {
+    mvk::LinearStrategy linear(1024);
+
+    uint64_t a = linear.Allocate(100, 1);
+    uint64_t b = linear.Allocate(100, 64);
+    CHECK(a == 0);
+    CHECK(b == 128);
+    CHECK(linear.GetStatistics().used_bytes == 200);
+
+    // The head moves from 228 up to 256, which leaves exactly 768 bytes.
+    uint64_t c = linear.Allocate(768, 256);
+    CHECK(c == 256);
+    CHECK(linear.Allocate(1, 1) == mvk::INVALID_OFFSET);
+    CHECK(linear.GetStatistics().free_bytes == 0);
+
+    // Space comes back only when the last allocation is gone.
+    linear.Free(a);
+    CHECK(linear.Allocate(1, 1) == mvk::INVALID_OFFSET);
+    linear.Free(b);
+    linear.Free(c);
+    CheckEmpty(linear, 1024);
+    CHECK(linear.Allocate(1024, 1) == 0);
+    CHECK(Throws(linear, 512));
+
+    linear.Reset();
+    CheckEmpty(linear, 1024);
+    CHECK(linear.Allocate(1025, 1) == mvk::INVALID_OFFSET);
+}
+
+static void TestBuddy() {
+    // Rounded down to 4096, sixteen 256-byte leaves.
+    mvk::BuddyStrategy buddy(5000);
+    CheckEmpty(buddy, 4096);
+
+    uint64_t small = buddy.Allocate(1, 1);
+    CHECK(small == 0);
+    CHECK(buddy.GetStatistics().used_bytes == mvk::BuddyStrategy::MIN_BLOCK_SIZE);
+
+    // Blocks are aligned to their size, and alignment can force a bigger block.
+    uint64_t aligned = buddy.Allocate(300, 2048);
+    CHECK(aligned != mvk::INVALID_OFFSET);
+    CHECK(aligned % 2048 == 0);
+    CHECK(aligned != 0);
+
+    uint64_t medium = buddy.Allocate(600, 1);
+    CHECK(medium != mvk::INVALID_OFFSET);
+    CHECK(medium % 1024 == 0);
+
+    // 256 + 2048 + 1024 used: a 1024 block cannot fit, three 256 leaves can.
+    CHECK(buddy.Allocate(1024, 1) == mvk::INVALID_OFFSET);
+    std::vector<uint64_t> leaves;
+    for (uint64_t offset; (offset = buddy.Allocate(256, 1)) != mvk::INVALID_OFFSET;)
+        leaves.push_back(offset);
+    CHECK(leaves.size() == 3);
+    CHECK(buddy.GetStatistics().free_bytes == 0);
+
+    // Freeing in any order merges buddies back into the whole range.
+    buddy.Free(medium);
+    for (uint64_t leaf : leaves)
+        buddy.Free(leaf);
+    buddy.Free(small);
+    CHECK(buddy.GetStatistics().largest_free_block == 2048);
+    buddy.Free(aligned);
+    CheckEmpty(buddy, 4096);
+    CHECK(Throws(buddy, 0));
+
+    CHECK(buddy.Allocate(4096, 1) == 0);
+    CHECK(buddy.Allocate(1, 1) == mvk::INVALID_OFFSET);
+    buddy.Reset();
+    CHECK(buddy.Allocate(4097, 1) == mvk::INVALID_OFFSET);
+}
+
+static void TestTlsf() {
+    const uint64_t capacity = 1 << 20;
+    mvk::TlsfStrategy tlsf(capacity);
+    CheckEmpty(tlsf, capacity);
+
+    uint64_t a = tlsf.Allocate(1000, 1);
+    uint64_t b = tlsf.Allocate(1000, 256);
+    uint64_t c = tlsf.Allocate(1000, 1);
+    CHECK(a == 0);
+    CHECK(b % 256 == 0);
+    CHECK(b >= a + 1000);
+    CHECK(c != mvk::INVALID_OFFSET);
+    CHECK(tlsf.GetStatistics().allocation_count == 3);
+
+    // The gap in front of b is given back as a free block of its own.
+    mvk::AllocationStatistics stats = tlsf.GetStatistics();
+    CHECK(stats.free_block_count == 2);
+    CHECK(stats.used_bytes == 3000);
+
+    // Freeing the middle one and then its neighbours coalesces everything.
+    tlsf.Free(b);
+    tlsf.Free(a);
+    tlsf.Free(c);
+    CheckEmpty(tlsf, capacity);
+    CHECK(Throws(tlsf, a));
+
+    // The whole range fits exactly once.
+    uint64_t whole = tlsf.Allocate(capacity, 1);
+    CHECK(whole == 0);
+    CHECK(tlsf.Allocate(1, 1) == mvk::INVALID_OFFSET);
+    tlsf.Free(whole);
+    CHECK(tlsf.Allocate(capacity + 1, 1) == mvk::INVALID_OFFSET);
+    CheckEmpty(tlsf, capacity);
+}
+
+// Random traffic against a shadow map of live ranges: results must be aligned,
+// in range and never overlap, and freeing everything must leave one free block.
+static void TestRandom(const std::string& name, mvk::AllocationStrategy& strategy, uint64_t capacity) {
+    std::mt19937 random(1234);
+    std::map<uint64_t, uint64_t> live;
+    int before = failures;
+
+    for (int step = 0; step < 20000 && failures == before; ++step) {
+        bool allocate = live.empty() || random() % 3 != 0;
+        if (allocate) {
+            uint64_t size = 1 + random() % 4096;
+            uint64_t alignment = 1ull << (random() % 9);
+            uint64_t offset = strategy.Allocate(size, alignment);
+            if (offset == mvk::INVALID_OFFSET) continue;
+
+            CHECK(offset % alignment == 0);
+            CHECK(offset + size <= capacity);
+            auto next = live.lower_bound(offset);
+            if (next != live.end())
+                CHECK(offset + size <= next->first);
+            if (next != live.begin())
+                CHECK(std::prev(next)->first + std::prev(next)->second <= offset);
+            live[offset] = size;
+        } else {
+            auto it = std::next(live.begin(), random() % live.size());
+            strategy.Free(it->first);
+            live.erase(it);
+        }
+        CHECK(strategy.GetStatistics().allocation_count == live.size());
+    }
+
+    for (auto &[offset, size] : live)
+        strategy.Free(offset);
+    CheckEmpty(strategy, capacity);
+
+    if (failures != before)
+        std::cerr << name << ": random allocation test failed\n";
+}
+
+int main() {
+    TestLinear();
+    TestBuddy();
+    TestTlsf();
+
+    const uint64_t capacity = 1 << 20;
+    mvk::BuddyStrategy buddy(capacity);
+    mvk::TlsfStrategy tlsf(capacity);
+    TestRandom("buddy", buddy, capacity);
+    TestRandom("tlsf", tlsf, capacity);
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "All allocation strategy checks passed\n";
+    return 0;
+}
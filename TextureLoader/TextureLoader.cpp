@@ -0,0 +1,339 @@
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+
+#include "../Mipmaps/Mipmaps.h"
+
+#include <stb_image.h>
+
+#ifdef MVK_KTX2_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef MVK_KTX2_BASIS
+#include <basisu_transcoder.h>
+#endif
+
+static const uint8_t KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+constexpr uint32_t KTX2_SUPERCOMPRESSION_NONE = 0;
+constexpr uint32_t KTX2_SUPERCOMPRESSION_BASISLZ = 1;
+constexpr uint32_t KTX2_SUPERCOMPRESSION_ZSTD = 2;
+
+// Data Format Descriptor fields, read from the first basic descriptor block.
+constexpr uint8_t KHR_DF_MODEL_ETC1S = 163;
+constexpr uint8_t KHR_DF_MODEL_UASTC = 166;
+constexpr uint8_t KHR_DF_TRANSFER_SRGB = 2;
+
+struct Ktx2Header {
+    uint8_t identifier[12];
+    uint32_t vk_format;
+    uint32_t type_size;
+    uint32_t pixel_width;
+    uint32_t pixel_height;
+    uint32_t pixel_depth;
+    uint32_t layer_count;
+    uint32_t face_count;
+    uint32_t level_count;
+    uint32_t supercompression_scheme;
+    uint32_t dfd_offset;
+    uint32_t dfd_length;
+    uint32_t kvd_offset;
+    uint32_t kvd_length;
+    uint64_t sgd_offset;
+    uint64_t sgd_length;
+};
+static_assert(sizeof(Ktx2Header) == 80, "KTX2 header must match the file layout");
+
+struct Ktx2Level {
+    uint64_t offset;
+    uint64_t length;
+    uint64_t uncompressed_length;
+};
+
+static void ForEachLevel(mvk::ThreadPool* pool, size_t count, const std::function<void(size_t)>& body) {
+    if (pool) {
+        pool->ParallelFor(count, body);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i)
+        body(i);
+}
+
+// Replaces the levels of an RGBA8 texture with a chain built from its base level.
+static void BuildMipChain(mvk::TextureData& texture, const uint8_t* pixels, bool srgb) {
+    auto chain = mvk::Mipmaps::DownsampleRGBA8(pixels, texture.width, texture.height,
+                                               mvk::Mipmaps::LevelCount(texture.width, texture.height), srgb);
+    texture.decoded.resize(chain.size());
+    texture.levels.resize(chain.size());
+    for (size_t level = 0; level < chain.size(); ++level) {
+        texture.decoded[level] = std::move(chain[level].pixels);
+        texture.levels[level] = {chain[level].width, chain[level].height, texture.decoded[level].data()};
+    }
+    texture.generate_mips = false;
+}
+
+static uint64_t LevelSize(const mvk::TextureData& texture, uint32_t width, uint32_t height) {
+    uint64_t blocks_x = (width + texture.block_extent.width - 1) / texture.block_extent.width;
+    uint64_t blocks_y = (height + texture.block_extent.height - 1) / texture.block_extent.height;
+    return blocks_x * blocks_y * texture.block_size;
+}
+
+#ifdef MVK_KTX2_BASIS
+struct TranscodeTarget {
+    vk::Format srgb;
+    vk::Format unorm;
+    basist::transcoder_texture_format format;
+};
+
+static void TranscodeBasis(mvk::TextureData& texture, bool srgb, vk::PhysicalDevice physical_device, mvk::ThreadPool* pool) {
+    static std::once_flag initialized;
+    std::call_once(initialized, []() { basist::basisu_transcoder_init(); });
+
+    // Best quality per byte first; RGBA8 is always sampleable.
+    const TranscodeTarget targets[] = {
+        {vk::Format::eBc7SrgbBlock, vk::Format::eBc7UnormBlock, basist::transcoder_texture_format::cTFBC7_RGBA},
+        {vk::Format::eAstc4x4SrgbBlock, vk::Format::eAstc4x4UnormBlock, basist::transcoder_texture_format::cTFASTC_4x4_RGBA},
+        {vk::Format::eEtc2R8G8B8A8SrgbBlock, vk::Format::eEtc2R8G8B8A8UnormBlock, basist::transcoder_texture_format::cTFETC2_RGBA},
+        {vk::Format::eR8G8B8A8Srgb, vk::Format::eR8G8B8A8Unorm, basist::transcoder_texture_format::cTFRGBA32},
+    };
+
+    const TranscodeTarget* target = &targets[3];
+    for (const auto &candidate : targets) {
+        if (mvk::TextureLoader::IsSampleable(physical_device, srgb ? candidate.srgb : candidate.unorm)) {
+            target = &candidate;
+            break;
+        }
+    }
+    texture.format = srgb ? target->srgb : target->unorm;
+    mvk::TextureLoader::FormatInfo(texture.format, texture.block_extent, texture.block_size);
+    bool uncompressed = texture.block_extent.width == 1;
+
+    basist::ktx2_transcoder transcoder;
+    if (!transcoder.init(texture.file.data(), static_cast<uint32_t>(texture.file.size())) || !transcoder.start_transcoding())
+        throw std::runtime_error("Cannot read the Basis Universal payload.");
+
+    uint32_t level_count = std::max(transcoder.get_levels(), 1u);
+    texture.decoded.resize(level_count);
+    texture.levels.resize(level_count);
+
+    // Separate states let levels transcode concurrently from one transcoder.
+    ForEachLevel(pool, level_count, [&](size_t level) {
+        basist::ktx2_image_level_info info;
+        if (!transcoder.get_image_level_info(info, static_cast<uint32_t>(level), 0, 0))
+            throw std::runtime_error("Cannot read Basis Universal level info.");
+
+        uint32_t units = uncompressed ? info.m_orig_width * info.m_orig_height : info.m_total_blocks;
+        auto &decoded = texture.decoded[level];
+        decoded.resize(static_cast<size_t>(units) * texture.block_size);
+
+        basist::ktx2_transcoder_state state;
+        if (!transcoder.transcode_image_level(static_cast<uint32_t>(level), 0, 0, decoded.data(), units, target->format,
+                                              0, 0, 0, -1, -1, &state))
+            throw std::runtime_error("Basis Universal transcoding failed.");
+
+        texture.levels[level] = {info.m_orig_width, info.m_orig_height, decoded.data()};
+    });
+}
+#endif
+
+namespace mvk {
+    TextureData TextureLoader::LoadKtx2(const std::string& path, vk::PhysicalDevice physical_device, ThreadPool* pool) {
+        TextureData texture;
+
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            throw std::runtime_error("Cannot open " + path);
+        texture.file.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(texture.file.data()), texture.file.size()))
+            throw std::runtime_error("Cannot read " + path);
+
+        Ktx2Header header{};
+        if (texture.file.size() < sizeof(header))
+            throw std::runtime_error("Truncated KTX2 header.");
+        std::memcpy(&header, texture.file.data(), sizeof(header));
+
+        if (std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+            throw std::runtime_error("Not a KTX2 file.");
+        if (header.pixel_width == 0 || header.pixel_height == 0 || header.pixel_depth > 1 ||
+            header.layer_count > 1 || header.face_count != 1)
+            throw std::runtime_error("Only single 2D KTX2 images are supported.");
+
+        texture.width = header.pixel_width;
+        texture.height = header.pixel_height;
+
+        uint32_t level_count = std::max(header.level_count, 1u);
+        if (texture.file.size() < sizeof(header) + level_count * sizeof(Ktx2Level))
+            throw std::runtime_error("Truncated KTX2 level index.");
+        std::vector<Ktx2Level> level_index(level_count);
+        std::memcpy(level_index.data(), texture.file.data() + sizeof(header), level_count * sizeof(Ktx2Level));
+        for (const auto &level : level_index) {
+            if (level.offset > texture.file.size() || level.length > texture.file.size() - level.offset)
+                throw std::runtime_error("KTX2 level lies outside the file.");
+        }
+
+        uint8_t color_model = 0;
+        bool srgb = false;
+        if (header.dfd_length >= 16 && header.dfd_offset + 16ull <= texture.file.size()) {
+            // The DFD starts with its total size, then the block header of two words.
+            color_model = texture.file[header.dfd_offset + 12];
+            srgb = texture.file[header.dfd_offset + 14] == KHR_DF_TRANSFER_SRGB;
+        }
+
+        if (header.vk_format == 0) {
+            if (color_model != KHR_DF_MODEL_ETC1S && color_model != KHR_DF_MODEL_UASTC)
+                throw std::runtime_error("KTX2 file has no format and no Basis Universal payload.");
+#ifdef MVK_KTX2_BASIS
+            TranscodeBasis(texture, srgb, physical_device, pool);
+            return texture;
+#else
+            (void)srgb;
+            throw std::runtime_error("Basis Universal KTX2 needs a build with MVK_KTX2_BASIS.");
+#endif
+        }
+
+        texture.format = static_cast<vk::Format>(header.vk_format);
+        if (!FormatInfo(texture.format, texture.block_extent, texture.block_size))
+            throw std::runtime_error("Unsupported KTX2 format " + vk::to_string(texture.format) + ".");
+        if (!IsSampleable(physical_device, texture.format))
+            throw std::runtime_error("Device cannot sample " + vk::to_string(texture.format) + ".");
+
+        texture.generate_mips = header.level_count == 0;
+        texture.levels.resize(level_count);
+        for (uint32_t level = 0; level < level_count; ++level) {
+            uint32_t width = std::max(texture.width >> level, 1u);
+            uint32_t height = std::max(texture.height >> level, 1u);
+            uint64_t expected = LevelSize(texture, width, height);
+            if (header.supercompression_scheme == KTX2_SUPERCOMPRESSION_NONE && level_index[level].length != expected)
+                throw std::runtime_error("KTX2 level size does not match its format.");
+            if (header.supercompression_scheme == KTX2_SUPERCOMPRESSION_ZSTD && level_index[level].uncompressed_length != expected)
+                throw std::runtime_error("KTX2 level size does not match its format.");
+
+            texture.levels[level] = {width, height, texture.file.data() + level_index[level].offset};
+        }
+
+        switch (header.supercompression_scheme) {
+            case KTX2_SUPERCOMPRESSION_NONE:
+                break;
+            case KTX2_SUPERCOMPRESSION_ZSTD: {
+#ifdef MVK_KTX2_ZSTD
+                texture.decoded.resize(level_count);
+                ForEachLevel(pool, level_count, [&](size_t level) {
+                    auto &decoded = texture.decoded[level];
+                    decoded.resize(level_index[level].uncompressed_length);
+                    size_t written = ZSTD_decompress(decoded.data(), decoded.size(),
+                                                     texture.file.data() + level_index[level].offset, level_index[level].length);
+                    if (ZSTD_isError(written) || written != decoded.size())
+                        throw std::runtime_error("Corrupt zstd level in KTX2 file.");
+                    texture.levels[level].data = decoded.data();
+                });
+                break;
+#else
+                throw std::runtime_error("Zstandard KTX2 needs a build with MVK_KTX2_ZSTD.");
+#endif
+            }
+            case KTX2_SUPERCOMPRESSION_BASISLZ:
+                throw std::runtime_error("BasisLZ supercompression requires an undefined vkFormat.");
+            default:
+                throw std::runtime_error("Unknown KTX2 supercompression scheme.");
+        }
+
+        return texture;
+    }
+
+    TextureData TextureLoader::LoadImage(const std::string& path) {
+        int width, height, channels;
+        stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        if (!pixels)
+            throw std::runtime_error("Failed to load texture image " + path);
+
+        TextureData texture;
+        texture.format = vk::Format::eR8G8B8A8Srgb;
+        texture.width = static_cast<uint32_t>(width);
+        texture.height = static_cast<uint32_t>(height);
+        texture.block_size = 4;
+        BuildMipChain(texture, pixels, true);
+
+        stbi_image_free(pixels);
+        return texture;
+    }
+
+    TextureData TextureLoader::Load(const std::string& path, vk::PhysicalDevice physical_device, ThreadPool* pool) {
+        std::string extension = path.size() >= 5 ? path.substr(path.size() - 5) : "";
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (extension != ".ktx2")
+            return LoadImage(path);
+
+        TextureData texture = LoadKtx2(path, physical_device, pool);
+        if (texture.generate_mips && texture.block_size == 4 && texture.block_extent.width == 1) {
+            bool srgb = texture.format == vk::Format::eR8G8B8A8Srgb || texture.format == vk::Format::eB8G8R8A8Srgb;
+            // The base level may point into file, which BuildMipChain leaves alone.
+            BuildMipChain(texture, static_cast<const uint8_t*>(texture.levels[0].data), srgb);
+        }
+        return texture;
+    }
+
+    bool TextureLoader::IsSampleable(vk::PhysicalDevice physical_device, vk::Format format) {
+        vk::FormatProperties properties = physical_device.getFormatProperties(format);
+        vk::FormatFeatureFlags needed = vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eSampledImageFilterLinear |
+                                        vk::FormatFeatureFlagBits::eTransferDst;
+        return (properties.optimalTilingFeatures & needed) == needed;
+    }
+
+    bool TextureLoader::FormatInfo(vk::Format format, vk::Extent2D& block_extent, uint32_t& block_size) {
+        switch (format) {
+            case vk::Format::eR8G8B8A8Unorm:
+            case vk::Format::eR8G8B8A8Srgb:
+            case vk::Format::eB8G8R8A8Unorm:
+            case vk::Format::eB8G8R8A8Srgb:
+                block_extent = vk::Extent2D(1, 1);
+                block_size = 4;
+                return true;
+            case vk::Format::eBc1RgbUnormBlock:
+            case vk::Format::eBc1RgbSrgbBlock:
+            case vk::Format::eBc1RgbaUnormBlock:
+            case vk::Format::eBc1RgbaSrgbBlock:
+            case vk::Format::eBc4UnormBlock:
+            case vk::Format::eBc4SnormBlock:
+            case vk::Format::eEtc2R8G8B8UnormBlock:
+            case vk::Format::eEtc2R8G8B8SrgbBlock:
+            case vk::Format::eEtc2R8G8B8A1UnormBlock:
+            case vk::Format::eEtc2R8G8B8A1SrgbBlock:
+                block_extent = vk::Extent2D(4, 4);
+                block_size = 8;
+                return true;
+            case vk::Format::eBc3UnormBlock:
+            case vk::Format::eBc3SrgbBlock:
+            case vk::Format::eBc5UnormBlock:
+            case vk::Format::eBc5SnormBlock:
+            case vk::Format::eBc7UnormBlock:
+            case vk::Format::eBc7SrgbBlock:
+            case vk::Format::eEtc2R8G8B8A8UnormBlock:
+            case vk::Format::eEtc2R8G8B8A8SrgbBlock:
+            case vk::Format::eAstc4x4UnormBlock:
+            case vk::Format::eAstc4x4SrgbBlock:
+                block_extent = vk::Extent2D(4, 4);
+                block_size = 16;
+                return true;
+            case vk::Format::eAstc6x6UnormBlock:
+            case vk::Format::eAstc6x6SrgbBlock:
+                block_extent = vk::Extent2D(6, 6);
+                block_size = 16;
+                return true;
+            case vk::Format::eAstc8x8UnormBlock:
+            case vk::Format::eAstc8x8SrgbBlock:
+                block_extent = vk::Extent2D(8, 8);
+                block_size = 16;
+                return true;
+            default:
+                return false;
+        }
+    }
+}
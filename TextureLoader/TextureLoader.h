@@ -0,0 +1,60 @@
+#ifndef MVK_TEXTURE_LOADER
+#define MVK_TEXTURE_LOADER
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../StagingUploader/StagingUploader.h"
+#include "../ThreadPool/ThreadPool.h"
+
+namespace mvk {
+    // A texture ready for StagingUploader::UploadImageLevels. levels point into file or
+    // decoded, so they stay valid as long as the TextureData does, moves included.
+    struct TextureData {
+        vk::Format format = vk::Format::eUndefined;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        vk::Extent2D block_extent{1, 1};
+        // Bytes per block, or per texel for uncompressed formats.
+        uint32_t block_size = 0;
+        // The file stores only the base level and asks for the chain to be generated.
+        bool generate_mips = false;
+        std::vector<ImageLevel> levels;
+
+        std::vector<uint8_t> file;
+        std::vector<std::vector<uint8_t>> decoded;
+    };
+
+    class TextureLoader {
+       public:
+        // Reads a single 2D image from a KTX2 container. Files with a fixed vkFormat are
+        // used as stored and must be sampleable on physical_device. Basis Universal
+        // payloads (ETC1S, UASTC) are transcoded to the first supported of BC7, ASTC 4x4,
+        // ETC2 and RGBA8. Supercompressed levels are decoded in parallel on pool, or on
+        // the calling thread when pool is null (required when called from a pool worker).
+        // Throws std::runtime_error when the file cannot be used; callers fall back to an
+        // uncompressed image.
+        static TextureData LoadKtx2(const std::string& path, vk::PhysicalDevice physical_device,
+                                    ThreadPool* pool = &ThreadPool::Shared());
+
+        // Decodes any image stb_image reads into sRGB RGBA8 with a full CPU mip chain.
+        static TextureData LoadImage(const std::string& path);
+
+        // LoadKtx2 for .ktx2 files, LoadImage otherwise. A KTX2 file that asks for its
+        // chain to be generated gets a CPU chain when it is 8-bit RGBA. KTX2 levels are
+        // decoded on pool, which must not be the pool running the caller; null decodes
+        // them on the calling thread.
+        static TextureData Load(const std::string& path, vk::PhysicalDevice physical_device, ThreadPool* pool = nullptr);
+
+        // Optimal tiling supports sampling with a linear filter.
+        static bool IsSampleable(vk::PhysicalDevice physical_device, vk::Format format);
+
+        // Block dimensions and size for the formats LoadKtx2 accepts; false otherwise.
+        static bool FormatInfo(vk::Format format, vk::Extent2D& block_extent, uint32_t& block_size);
+    };
+}
+
+#endif  // MVK_TEXTURE_LOADER
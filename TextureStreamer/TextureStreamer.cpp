@@ -0,0 +1,277 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+// 4x4 grey checker shown until a texture's first level is resident.
+static constexpr uint32_t PLACEHOLDER_SIZE = 4;
+// Files read and decoded at once; their levels spread over the level pool.
+static constexpr size_t FILE_THREADS = 2;
+
+static uint64_t LevelBytes(const mvk::TextureData& data, const mvk::ImageLevel& level) {
+    uint64_t blocks_x = (level.width + data.block_extent.width - 1) / data.block_extent.width;
+    uint64_t blocks_y = (level.height + data.block_extent.height - 1) / data.block_extent.height;
+    return blocks_x * blocks_y * data.block_size;
+}
+
+namespace mvk {
+    void TextureStreamer::Init(vk::PhysicalDevice physical_device, vk::Device device, DeviceMemoryAllocator& allocator,
+                               StagingUploader& uploader, BindlessTable& bindless, uint32_t frames_in_flight,
+                               uint32_t decode_threads, vk::DeviceSize upload_budget) {
+        physical_device_ = physical_device;
+        device_ = device;
+        allocator_ = &allocator;
+        uploader_ = &uploader;
+        bindless_ = &bindless;
+        if (decode_threads == 0)
+            decode_threads = std::max(std::thread::hardware_concurrency() / 2, 1u);
+        file_pool_ = std::make_unique<ThreadPool>(FILE_THREADS);
+        level_pool_ = std::make_unique<ThreadPool>(decode_threads);
+        frames_in_flight_ = frames_in_flight;
+        upload_budget_ = upload_budget;
+        stats_ = TextureStreamerStatistics{};
+
+        CreatePlaceholder();
+    }
+
+    void TextureStreamer::Destroy() {
+        for (auto &texture : textures_) {
+            if (texture.decode.valid())
+                texture.decode.wait();
+            if (texture.view)
+                device_.destroyImageView(texture.view);
+            if (texture.image) {
+                device_.destroyImage(texture.image);
+                allocator_->Free(texture.allocation);
+            }
+        }
+        textures_.clear();
+        file_pool_.reset();
+        level_pool_.reset();
+
+        for (auto &retired : retired_)
+            device_.destroyImageView(retired.view);
+        retired_.clear();
+
+        device_.destroyImageView(placeholder_view_);
+        device_.destroyImage(placeholder_);
+        allocator_->Free(placeholder_allocation_);
+    }
+
+    uint32_t TextureStreamer::Request(const std::string& path, const MaterialData& material, const std::string& fallback_path) {
+        StreamedTexture texture;
+        texture.path = path;
+        texture.material_data = material;
+        texture.material_data.BaseColorTexture = placeholder_slot_;
+        texture.material = bindless_->RegisterMaterial(texture.material_data);
+        texture.slot = placeholder_slot_;
+
+        vk::PhysicalDevice physical_device = physical_device_;
+        ThreadPool* level_pool = level_pool_.get();
+        texture.decode = file_pool_->Submit([path, fallback_path, physical_device, level_pool]() {
+            try {
+                return TextureLoader::Load(path, physical_device, level_pool);
+            } catch (const std::exception& e) {
+                if (fallback_path.empty()) throw;
+                std::cout << "\u001b[33mWARNING: Cannot use " << path << " (" << e.what() << "), loading " << fallback_path << "\u001b[0m\n";
+                return TextureLoader::Load(fallback_path, physical_device, level_pool);
+            }
+        });
+
+        stats_.requested++;
+        textures_.push_back(std::move(texture));
+        return textures_.back().material;
+    }
+
+    void TextureStreamer::Update(uint64_t frame) {
+        while (!retired_.empty() && retired_.front().frame <= frame) {
+            device_.destroyImageView(retired_.front().view);
+            bindless_->ReleaseTexture(retired_.front().slot);
+            retired_.pop_front();
+        }
+
+        vk::DeviceSize spent = 0;
+        bool recorded = false;
+        for (auto &texture : textures_) {
+            if (texture.state == State::eDecoding) {
+                if (texture.decode.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                    continue;
+                try {
+                    texture.data = texture.decode.get();
+                } catch (const std::exception& e) {
+                    std::cout << "\u001b[33mWARNING: Cannot stream " << texture.path << " (" << e.what() << "), keeping the placeholder.\u001b[0m\n";
+                    texture.state = State::eFailed;
+                    stats_.failed++;
+                    continue;
+                }
+                StartUploads(texture);
+            }
+            if (texture.state != State::eUploading)
+                continue;
+
+            // Batches finish in ticket order, so the last finished entry is the finest level.
+            uint32_t finest = texture.resident_level;
+            while (!texture.uploads.empty() && texture.uploads.front().ticket != 0 &&
+                   uploader_->IsComplete(texture.uploads.front().ticket)) {
+                finest = texture.uploads.front().level;
+                texture.uploads.pop_front();
+            }
+            if (finest < texture.resident_level)
+                Publish(texture, finest, frame);
+
+            if (texture.resident_level == 0) {
+                texture.state = State::eResident;
+                texture.data = TextureData{};
+                stats_.resident++;
+                continue;
+            }
+
+            // The first level of a frame always goes, so a level larger than the budget still gets through.
+            while (texture.next_upload > 0) {
+                uint32_t level = texture.next_upload - 1;
+                const ImageLevel &source = texture.data.levels[level];
+                uint64_t bytes = LevelBytes(texture.data, source);
+                if (spent > 0 && spent + bytes > upload_budget_)
+                    break;
+
+                uploader_->UploadImageLevels(texture.image, {source}, texture.data.block_size,
+                                             vk::ImageLayout::eShaderReadOnlyOptimal, texture.data.block_extent, level);
+                texture.uploads.push_back({0, level});
+                texture.next_upload = level;
+                spent += bytes;
+                stats_.uploaded_bytes += bytes;
+                recorded = true;
+            }
+        }
+
+        if (!recorded)
+            return;
+
+        // A ring-full flush inside UploadImageLevels may have submitted some levels earlier;
+        // this ticket covers them too.
+        UploadTicket ticket = uploader_->Flush();
+        for (auto &texture : textures_) {
+            for (auto &upload : texture.uploads) {
+                if (upload.ticket == 0)
+                    upload.ticket = ticket;
+            }
+        }
+    }
+
+    bool TextureStreamer::idle() const {
+        for (const auto &texture : textures_) {
+            if (texture.state == State::eDecoding || texture.state == State::eUploading)
+                return false;
+        }
+        return true;
+    }
+
+    uint32_t TextureStreamer::mip_levels(uint32_t material) const {
+        for (const auto &texture : textures_) {
+            if (texture.material == material)
+                return texture.level_count;
+        }
+        return 0;
+    }
+
+    const TextureStreamerStatistics& TextureStreamer::statistics() const {
+        return stats_;
+    }
+
+    void TextureStreamer::CreatePlaceholder() {
+        vk::ImageCreateInfo image_info{};
+        image_info.sType = vk::StructureType::eImageCreateInfo;
+        image_info.setImageType(vk::ImageType::e2D);
+        image_info.setExtent(vk::Extent3D(PLACEHOLDER_SIZE, PLACEHOLDER_SIZE, 1));
+        image_info.setMipLevels(1);
+        image_info.setArrayLayers(1);
+        image_info.setFormat(vk::Format::eR8G8B8A8Srgb);
+        image_info.setTiling(vk::ImageTiling::eOptimal);
+        image_info.setInitialLayout(vk::ImageLayout::eUndefined);
+        image_info.setUsage(vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled);
+        image_info.setSharingMode(vk::SharingMode::eExclusive);
+        image_info.setSamples(vk::SampleCountFlagBits::e1);
+
+        placeholder_ = device_.createImage(image_info);
+        placeholder_allocation_ = allocator_->Allocate(device_.getImageMemoryRequirements(placeholder_),
+                                                       vk::MemoryPropertyFlagBits::eDeviceLocal, ResourceKind::eOptimal);
+        device_.bindImageMemory(placeholder_, placeholder_allocation_.memory, placeholder_allocation_.offset);
+
+        uint8_t pixels[PLACEHOLDER_SIZE * PLACEHOLDER_SIZE * 4];
+        for (uint32_t y = 0; y < PLACEHOLDER_SIZE; ++y) {
+            for (uint32_t x = 0; x < PLACEHOLDER_SIZE; ++x) {
+                uint8_t shade = ((x ^ y) & 1) ? 96 : 160;
+                uint8_t* texel = &pixels[(y * PLACEHOLDER_SIZE + x) * 4];
+                texel[0] = texel[1] = texel[2] = shade;
+                texel[3] = 255;
+            }
+        }
+        // Goes out with the next flush, ahead of any frame.
+        uploader_->UploadImage(placeholder_, PLACEHOLDER_SIZE, PLACEHOLDER_SIZE, 4, pixels, vk::ImageLayout::eShaderReadOnlyOptimal);
+
+        vk::ImageViewCreateInfo view_info{};
+        view_info.sType = vk::StructureType::eImageViewCreateInfo;
+        view_info.setImage(placeholder_);
+        view_info.setViewType(vk::ImageViewType::e2D);
+        view_info.setFormat(vk::Format::eR8G8B8A8Srgb);
+        view_info.setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
+
+        placeholder_view_ = device_.createImageView(view_info);
+        placeholder_slot_ = bindless_->RegisterTexture(placeholder_view_);
+    }
+
+    void TextureStreamer::StartUploads(StreamedTexture& texture) {
+        const TextureData &data = texture.data;
+        texture.level_count = static_cast<uint32_t>(data.levels.size());
+
+        vk::ImageCreateInfo image_info{};
+        image_info.sType = vk::StructureType::eImageCreateInfo;
+        image_info.setImageType(vk::ImageType::e2D);
+        image_info.setExtent(vk::Extent3D(data.width, data.height, 1));
+        image_info.setMipLevels(texture.level_count);
+        image_info.setArrayLayers(1);
+        image_info.setFormat(data.format);
+        image_info.setTiling(vk::ImageTiling::eOptimal);
+        image_info.setInitialLayout(vk::ImageLayout::eUndefined);
+        image_info.setUsage(vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled);
+        image_info.setSharingMode(vk::SharingMode::eExclusive);
+        image_info.setSamples(vk::SampleCountFlagBits::e1);
+
+        texture.image = device_.createImage(image_info);
+        texture.allocation = allocator_->Allocate(device_.getImageMemoryRequirements(texture.image),
+                                                  vk::MemoryPropertyFlagBits::eDeviceLocal, ResourceKind::eOptimal);
+        device_.bindImageMemory(texture.image, texture.allocation.memory, texture.allocation.offset);
+
+        texture.next_upload = texture.level_count;
+        texture.resident_level = texture.level_count;
+        texture.state = State::eUploading;
+        stats_.device_bytes += texture.allocation.size;
+    }
+
+    // Levels [level, level_count) are resident: sample them through a new view in a fresh
+    // slot, so pending frames keep reading the old slot until they are done with it.
+    void TextureStreamer::Publish(StreamedTexture& texture, uint32_t level, uint64_t frame) {
+        vk::ImageViewCreateInfo view_info{};
+        view_info.sType = vk::StructureType::eImageViewCreateInfo;
+        view_info.setImage(texture.image);
+        view_info.setViewType(vk::ImageViewType::e2D);
+        view_info.setFormat(texture.data.format);
+        view_info.setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, level, texture.level_count - level, 0, 1));
+
+        vk::ImageView view = device_.createImageView(view_info);
+        uint32_t slot = bindless_->RegisterTexture(view);
+        texture.material_data.BaseColorTexture = slot;
+        bindless_->UpdateMaterial(texture.material, texture.material_data);
+
+        // Frames from this one on read the new record; the last reader of the old one was
+        // frame - 1, which has finished by the time frame - 1 + frames_in_flight begins.
+        if (texture.view)
+            retired_.push_back({frame + frames_in_flight_, texture.view, texture.slot});
+
+        texture.view = view;
+        texture.slot = slot;
+        texture.resident_level = level;
+    }
+}
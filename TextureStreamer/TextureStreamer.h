@@ -0,0 +1,128 @@
+#ifndef MVK_TEXTURE_STREAMER
+#define MVK_TEXTURE_STREAMER
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../BindlessTable/BindlessTable.h"
+#include "../MemoryAllocator/DeviceMemoryAllocator.h"
+#include "../StagingUploader/StagingUploader.h"
+#include "../TextureLoader/TextureLoader.h"
+#include "../ThreadPool/ThreadPool.h"
+
+namespace mvk {
+    struct TextureStreamerStatistics {
+        uint32_t requested = 0;
+        // Every level is on the device.
+        uint32_t resident = 0;
+        // Could not be decoded; these keep showing the placeholder.
+        uint32_t failed = 0;
+        uint64_t uploaded_bytes = 0;
+        // Device memory of all streamed images, whether or not their levels arrived yet.
+        uint64_t device_bytes = 0;
+    };
+
+    // Streams textures in behind a placeholder. Request registers a material that samples
+    // a tiny placeholder right away and decodes the file on the streamer's own threads,
+    // so decoding never holds up the shared pool that records frames. Update then
+    // uploads the decoded levels coarsest first within a per-frame byte budget, and each
+    // time a finer level lands on the device the material is pointed at a view that
+    // starts at it. Nothing here waits on file I/O, decoding or the GPU.
+    //
+    // Views and table slots that pending frames may still sample are retired only once
+    // every frame that could have read them has finished. Not thread-safe: Request and
+    // Update belong to the render thread.
+    class TextureStreamer {
+       public:
+        static constexpr vk::DeviceSize DEFAULT_UPLOAD_BUDGET = 8ull * 1024 * 1024;
+
+        // decode_threads sizes the pool KTX2 levels are decoded on; 0 uses half the hardware threads.
+        void Init(vk::PhysicalDevice physical_device, vk::Device device, DeviceMemoryAllocator& allocator,
+                  StagingUploader& uploader, BindlessTable& bindless, uint32_t frames_in_flight,
+                  uint32_t decode_threads = 0, vk::DeviceSize upload_budget = DEFAULT_UPLOAD_BUDGET);
+        // Waits for outstanding decodes and stops the decode threads. The device must be idle.
+        void Destroy();
+
+        // Returns the index of a new material built from material, with its base color
+        // texture streamed from path. fallback_path is decoded instead when path fails.
+        uint32_t Request(const std::string& path, const MaterialData& material, const std::string& fallback_path = "");
+
+        // Once per frame, before the frame's BindlessTable::BeginFrame. frame counts up by
+        // one per DrawFrame.
+        void Update(uint64_t frame);
+
+        // No texture is still decoding or uploading.
+        bool idle() const;
+        // Level count of the texture behind material; 0 until it is decoded.
+        uint32_t mip_levels(uint32_t material) const;
+        const TextureStreamerStatistics& statistics() const;
+
+       private:
+        enum class State { eDecoding, eUploading, eResident, eFailed };
+
+        struct UploadedLevel {
+            UploadTicket ticket = 0;
+            uint32_t level = 0;
+        };
+
+        struct StreamedTexture {
+            State state = State::eDecoding;
+            uint32_t material = 0;
+            MaterialData material_data;
+            std::string path;
+            std::future<TextureData> decode;
+            // The CPU copy is dropped once every level is resident.
+            TextureData data;
+
+            vk::Image image;
+            Allocation allocation;
+            uint32_t level_count = 0;
+            // Levels below next_upload still have to be uploaded, coarsest first.
+            uint32_t next_upload = 0;
+            std::deque<UploadedLevel> uploads;
+            // Finest level shaders can sample; level_count while nothing is resident.
+            uint32_t resident_level = 0;
+            vk::ImageView view;
+            uint32_t slot = 0;
+        };
+
+        struct Retired {
+            uint64_t frame = 0;
+            vk::ImageView view;
+            uint32_t slot = 0;
+        };
+
+        void CreatePlaceholder();
+        void StartUploads(StreamedTexture& texture);
+        void Publish(StreamedTexture& texture, uint32_t level, uint64_t frame);
+
+        vk::PhysicalDevice physical_device_;
+        vk::Device device_;
+        DeviceMemoryAllocator* allocator_ = nullptr;
+        StagingUploader* uploader_ = nullptr;
+        BindlessTable* bindless_ = nullptr;
+        // One job per requested file reads it and fans its levels out to level_pool_;
+        // ParallelFor must not run on the pool that calls it, hence two pools.
+        std::unique_ptr<ThreadPool> file_pool_;
+        std::unique_ptr<ThreadPool> level_pool_;
+        uint32_t frames_in_flight_ = 0;
+        vk::DeviceSize upload_budget_ = 0;
+
+        vk::Image placeholder_;
+        Allocation placeholder_allocation_;
+        vk::ImageView placeholder_view_;
+        uint32_t placeholder_slot_ = 0;
+
+        std::vector<StreamedTexture> textures_;
+        std::deque<Retired> retired_;
+        TextureStreamerStatistics stats_;
+    };
+}
+
+#endif  // MVK_TEXTURE_STREAMER
@@ -0,0 +1,84 @@
+#include "ThreadPool.h"
+
+namespace mvk {
+    ThreadPool::ThreadPool(size_t thread_count) {
+        if (thread_count == 0)
+            thread_count = 1;
+
+        workers_.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; ++i)
+            workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_all();
+
+        for (auto &worker : workers_)
+            worker.join();
+    }
+
+    void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+        if (count == 0) return;
+
+        if (count == 1) {
+            body(0);
+            return;
+        }
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            futures.push_back(Submit([&body, i]() { body(i); }));
+
+        std::exception_ptr first_error;
+        for (auto &future : futures) {
+            try {
+                future.get();
+            } catch (...) {
+                if (!first_error)
+                    first_error = std::current_exception();
+            }
+        }
+
+        if (first_error)
+            std::rethrow_exception(first_error);
+    }
+
+    size_t ThreadPool::thread_count() const {
+        return workers_.size();
+    }
+
+    ThreadPool& ThreadPool::Shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        condition_.notify_one();
+    }
+
+    void ThreadPool::WorkerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+                if (stopping_ && tasks_.empty())
+                    return;
+
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef MVK_THREAD_POOL
+#define MVK_THREAD_POOL
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace mvk {
+    class ThreadPool {
+       public:
+        explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        template <typename F>
+        std::future<std::invoke_result_t<F>> Submit(F&& task) {
+            using Result = std::invoke_result_t<F>;
+            auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            std::future<Result> future = packaged->get_future();
+            Enqueue([packaged]() { (*packaged)(); });
+            return future;
+        }
+
+        // Runs body(0..count-1) on the pool and blocks until all calls finish.
+        // If any call throws, the exception from the lowest index is rethrown.
+        // Must not be called from one of this pool's own workers.
+        void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+        size_t thread_count() const;
+
+        static ThreadPool& Shared();
+
+       private:
+        void Enqueue(std::function<void()> task);
+        void WorkerLoop();
+
+        std::vector<std::thread> workers_;
+        std::deque<std::function<void()>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        bool stopping_ = false;
+    };
+}
+
+#endif  // MVK_THREAD_POOL
@@ -0,0 +1,73 @@
+#include "UniformAllocator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace mvk {
+    void UniformAllocator::Init(vk::Device device, DeviceMemoryAllocator& allocator, vk::DeviceSize min_alignment,
+                                vk::DeviceSize bytes_per_frame, uint32_t frames_in_flight) {
+        device_ = device;
+        allocator_ = &allocator;
+        // The limit is a power of two; anything that reports 0 gets no extra alignment.
+        alignment_ = std::max<vk::DeviceSize>(min_alignment, 1);
+        capacity_ = bytes_per_frame;
+        current_ = 0;
+        cursor_ = 0;
+
+        frames_.resize(frames_in_flight);
+        for (auto &frame : frames_) {
+            vk::BufferCreateInfo buffer_info{};
+            buffer_info.sType = vk::StructureType::eBufferCreateInfo;
+            buffer_info.setSize(capacity_);
+            buffer_info.setUsage(vk::BufferUsageFlagBits::eUniformBuffer);
+            buffer_info.setSharingMode(vk::SharingMode::eExclusive);
+
+            frame.buffer = device_.createBuffer(buffer_info);
+            frame.allocation = allocator_->Allocate(device_.getBufferMemoryRequirements(frame.buffer),
+                                                    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                                                    ResourceKind::eLinear);
+            device_.bindBufferMemory(frame.buffer, frame.allocation.memory, frame.allocation.offset);
+        }
+    }
+
+    void UniformAllocator::Destroy() {
+        for (auto &frame : frames_) {
+            device_.destroyBuffer(frame.buffer);
+            allocator_->Free(frame.allocation);
+        }
+        frames_.clear();
+    }
+
+    void UniformAllocator::BeginFrame(uint32_t frame_slot) {
+        current_ = frame_slot;
+        cursor_ = 0;
+    }
+
+    UniformAllocation UniformAllocator::Allocate(vk::DeviceSize size) {
+        vk::DeviceSize offset = (cursor_ + alignment_ - 1) / alignment_ * alignment_;
+        if (offset + size > capacity_)
+            throw std::runtime_error("Uniform allocator is out of space for this frame.");
+        cursor_ = offset + size;
+
+        UniformAllocation allocation;
+        allocation.data = static_cast<uint8_t*>(frames_[current_].allocation.mapped) + offset;
+        allocation.offset = static_cast<uint32_t>(offset);
+        return allocation;
+    }
+
+    vk::Buffer UniformAllocator::buffer(uint32_t frame_slot) const {
+        return frames_[frame_slot].buffer;
+    }
+
+    vk::DeviceSize UniformAllocator::alignment() const {
+        return alignment_;
+    }
+
+    vk::DeviceSize UniformAllocator::capacity() const {
+        return capacity_;
+    }
+
+    vk::DeviceSize UniformAllocator::used() const {
+        return cursor_;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef MVK_UNIFORM_ALLOCATOR
+#define MVK_UNIFORM_ALLOCATOR
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "../MemoryAllocator/DeviceMemoryAllocator.h"
+
+namespace mvk {
+    struct UniformAllocation {
+        void* data = nullptr;
+        // Passed as the dynamic offset of an eUniformBufferDynamic binding.
+        uint32_t offset = 0;
+    };
+
+    // Per-frame bump allocator for uniform data. Each frame slot owns one host-visible
+    // uniform buffer that stays mapped; BeginFrame rewinds the slot and Allocate hands
+    // out chunks aligned to minUniformBufferOffsetAlignment. Descriptors point at the
+    // start of the buffer with a fixed range and each draw selects its chunk with a
+    // dynamic offset, so any number of objects share one buffer and one set per frame.
+    // The slot's in-flight fence must have been waited on before BeginFrame.
+    class UniformAllocator {
+       public:
+        void Init(vk::Device device, DeviceMemoryAllocator& allocator, vk::DeviceSize min_alignment,
+                  vk::DeviceSize bytes_per_frame, uint32_t frames_in_flight);
+        void Destroy();
+
+        void BeginFrame(uint32_t frame_slot);
+        // Throws once the slot is full.
+        UniformAllocation Allocate(vk::DeviceSize size);
+
+        template <typename T>
+        uint32_t Push(const T& value) {
+            UniformAllocation allocation = Allocate(sizeof(T));
+            std::memcpy(allocation.data, &value, sizeof(T));
+            return allocation.offset;
+        }
+
+        vk::Buffer buffer(uint32_t frame_slot) const;
+        vk::DeviceSize alignment() const;
+        vk::DeviceSize capacity() const;
+        // Bytes handed out in the current frame, alignment padding included.
+        vk::DeviceSize used() const;
+
+       private:
+        struct FrameBuffer {
+            vk::Buffer buffer;
+            Allocation allocation;
+        };
+
+        vk::Device device_;
+        DeviceMemoryAllocator* allocator_ = nullptr;
+        vk::DeviceSize alignment_ = 1;
+        vk::DeviceSize capacity_ = 0;
+
+        std::vector<FrameBuffer> frames_;
+        uint32_t current_ = 0;
+        vk::DeviceSize cursor_ = 0;
+    };
+}
+
+#endif  // MVK_UNIFORM_ALLOCATOR
@@ -0,0 +1,252 @@
+#ifndef MVK_VERTEX_LAYOUT
+#define MVK_VERTEX_LAYOUT
+
+#include <vulkan/vulkan.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "../ObjectLoader/ObjectLoader.h"
+#include "../MeshCache/MeshCache.h"
+
+namespace mvk {
+    // Attribute encodings. Each one names the Vulkan format the vertex shader reads,
+    // the CPU storage for it, and the worst-case absolute error of a round trip.
+
+    struct Float3Attribute {
+        using Storage = glm::vec3;
+        static constexpr vk::Format FORMAT = vk::Format::eR32G32B32Sfloat;
+
+        static Storage Encode(const glm::vec3& value) { return value; }
+        static glm::vec3 Decode(const Storage& value) { return value; }
+        static float ErrorBound(float) { return 0.0f; }
+    };
+
+    struct Float2Attribute {
+        using Storage = glm::vec2;
+        static constexpr vk::Format FORMAT = vk::Format::eR32G32Sfloat;
+
+        static Storage Encode(const glm::vec2& value) { return value; }
+        static glm::vec2 Decode(const Storage& value) { return value; }
+        static float ErrorBound(float) { return 0.0f; }
+    };
+
+    // Three component 16-bit formats are rarely supported for vertex input, so
+    // 16-bit vec3 attributes are padded to four components.
+    struct Half3Attribute {
+        using Storage = std::array<uint16_t, 4>;
+        static constexpr vk::Format FORMAT = vk::Format::eR16G16B16A16Sfloat;
+
+        static Storage Encode(const glm::vec3& value) {
+            return {glm::packHalf1x16(value.x), glm::packHalf1x16(value.y), glm::packHalf1x16(value.z), glm::packHalf1x16(1.0f)};
+        }
+        static glm::vec3 Decode(const Storage& value) {
+            return {glm::unpackHalf1x16(value[0]), glm::unpackHalf1x16(value[1]), glm::unpackHalf1x16(value[2])};
+        }
+        // Half floats keep 11 significant bits: rounding error is at most 2^-11 of the magnitude.
+        static float ErrorBound(float max_magnitude) { return max_magnitude * std::ldexp(1.0f, -11); }
+    };
+
+    struct Half2Attribute {
+        using Storage = std::array<uint16_t, 2>;
+        static constexpr vk::Format FORMAT = vk::Format::eR16G16Sfloat;
+
+        static Storage Encode(const glm::vec2& value) {
+            return {glm::packHalf1x16(value.x), glm::packHalf1x16(value.y)};
+        }
+        static glm::vec2 Decode(const Storage& value) {
+            return {glm::unpackHalf1x16(value[0]), glm::unpackHalf1x16(value[1])};
+        }
+        static float ErrorBound(float max_magnitude) { return max_magnitude * std::ldexp(1.0f, -11); }
+    };
+
+    // Expects values already normalized to [-1, 1]; see PositionQuantization.
+    struct Snorm16x3Attribute {
+        using Storage = std::array<int16_t, 4>;
+        static constexpr vk::Format FORMAT = vk::Format::eR16G16B16A16Snorm;
+
+        static Storage Encode(const glm::vec3& value) {
+            return {Pack(value.x), Pack(value.y), Pack(value.z), 32767};
+        }
+        static glm::vec3 Decode(const Storage& value) {
+            return {Unpack(value[0]), Unpack(value[1]), Unpack(value[2])};
+        }
+        static float ErrorBound(float) { return 0.5f / 32767.0f; }
+
+       private:
+        static int16_t Pack(float value) {
+            return static_cast<int16_t>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+        }
+        static float Unpack(int16_t value) {
+            return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+        }
+    };
+
+    // Expects values in [0, 1].
+    struct Unorm8x3Attribute {
+        using Storage = std::array<uint8_t, 4>;
+        static constexpr vk::Format FORMAT = vk::Format::eR8G8B8A8Unorm;
+
+        static Storage Encode(const glm::vec3& value) {
+            return {Pack(value.r), Pack(value.g), Pack(value.b), 255};
+        }
+        static glm::vec3 Decode(const Storage& value) {
+            return {value[0] / 255.0f, value[1] / 255.0f, value[2] / 255.0f};
+        }
+        static float ErrorBound(float) { return 0.5f / 255.0f; }
+
+       private:
+        static uint8_t Pack(float value) {
+            return static_cast<uint8_t>(std::round(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+        }
+    };
+
+    template <typename Encoding>
+    struct IsNormalized : std::false_type {};
+
+    template <>
+    struct IsNormalized<Snorm16x3Attribute> : std::true_type {};
+
+    // Binding and attribute descriptions are derived from the Packed struct, so
+    // the pipeline always matches what Quantize writes.
+    template <typename PositionEncoding, typename ColorEncoding, typename UVEncoding>
+    struct VertexLayout {
+        struct Packed {
+            typename PositionEncoding::Storage position;
+            typename ColorEncoding::Storage color;
+            typename UVEncoding::Storage uvs;
+        };
+
+        static constexpr uint32_t STRIDE = sizeof(Packed);
+        static constexpr bool NORMALIZED_POSITIONS = IsNormalized<PositionEncoding>::value;
+
+        static vk::VertexInputBindingDescription BindingDescription() {
+            vk::VertexInputBindingDescription vertex_binding_desc{};
+            vertex_binding_desc.setBinding(0);
+            vertex_binding_desc.setStride(STRIDE);
+            vertex_binding_desc.setInputRate(vk::VertexInputRate::eVertex);
+            return vertex_binding_desc;
+        }
+
+        static std::vector<vk::VertexInputAttributeDescription> AttributeDescription() {
+            std::vector<vk::VertexInputAttributeDescription> vertex_attributes(3);
+            vertex_attributes[0].setBinding(0);
+            vertex_attributes[0].setLocation(0);
+            vertex_attributes[0].setFormat(PositionEncoding::FORMAT);
+            vertex_attributes[0].setOffset(offsetof(Packed, position));
+
+            vertex_attributes[1].setBinding(0);
+            vertex_attributes[1].setLocation(1);
+            vertex_attributes[1].setFormat(ColorEncoding::FORMAT);
+            vertex_attributes[1].setOffset(offsetof(Packed, color));
+
+            vertex_attributes[2].setBinding(0);
+            vertex_attributes[2].setLocation(2);
+            vertex_attributes[2].setFormat(UVEncoding::FORMAT);
+            vertex_attributes[2].setOffset(offsetof(Packed, uvs));
+
+            return vertex_attributes;
+        }
+
+        // Normalized position encodings store positions relative to the mesh bounds;
+        // everything else keeps object space and gets an identity quantization.
+        static PositionQuantization ComputeQuantization(const std::vector<Vertex>& vertices) {
+            PositionQuantization quantization{};
+            if (!NORMALIZED_POSITIONS || vertices.empty()) return quantization;
+
+            glm::vec3 min = vertices[0].Position, max = vertices[0].Position;
+            for (auto &vertex : vertices) {
+                min = glm::min(min, vertex.Position);
+                max = glm::max(max, vertex.Position);
+            }
+
+            glm::vec3 center = (min + max) * 0.5f;
+            glm::vec3 extent = glm::max((max - min) * 0.5f, glm::vec3(1e-20f));
+            for (int i = 0; i < 3; ++i) {
+                quantization.offset[i] = center[i];
+                quantization.scale[i] = extent[i];
+            }
+            return quantization;
+        }
+
+        // Sphere around the stored positions (before dequantization): AABB center in xyz,
+        // distance to the farthest vertex in w. Loose, but cheap and good enough to cull with.
+        static glm::vec4 BoundingSphere(const void* data, size_t vertex_count) {
+            const Packed* vertices = static_cast<const Packed*>(data);
+            if (vertex_count == 0) return glm::vec4(0.0f);
+
+            glm::vec3 min = PositionEncoding::Decode(vertices[0].position), max = min;
+            for (size_t i = 1; i < vertex_count; ++i) {
+                glm::vec3 position = PositionEncoding::Decode(vertices[i].position);
+                min = glm::min(min, position);
+                max = glm::max(max, position);
+            }
+
+            glm::vec3 center = (min + max) * 0.5f;
+            float radius = 0.0f;
+            for (size_t i = 0; i < vertex_count; ++i)
+                radius = std::max(radius, glm::length(PositionEncoding::Decode(vertices[i].position) - center));
+            return glm::vec4(center, radius);
+        }
+
+        static QuantizationReport Quantize(const std::vector<Vertex>& vertices, const PositionQuantization& quantization, std::vector<uint8_t>& packed) {
+            glm::vec3 offset(quantization.offset[0], quantization.offset[1], quantization.offset[2]);
+            glm::vec3 scale(quantization.scale[0], quantization.scale[1], quantization.scale[2]);
+
+            packed.resize(vertices.size() * STRIDE);
+            Packed* out = reinterpret_cast<Packed*>(packed.data());
+
+            QuantizationReport report{};
+            float max_position = 0.0f, max_uv = 0.0f;
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                const Vertex& vertex = vertices[i];
+                glm::vec3 local = (vertex.Position - offset) / scale;
+
+                out[i].position = PositionEncoding::Encode(local);
+                out[i].color = ColorEncoding::Encode(vertex.Color);
+                out[i].uvs = UVEncoding::Encode(vertex.UVs);
+
+                glm::vec3 position = PositionEncoding::Decode(out[i].position) * scale + offset;
+                report.position_error = std::max(report.position_error, MaxComponent(glm::abs(position - vertex.Position)));
+                report.color_error = std::max(report.color_error, MaxComponent(glm::abs(ColorEncoding::Decode(out[i].color) - vertex.Color)));
+                report.uv_error = std::max(report.uv_error, MaxComponent(glm::abs(UVEncoding::Decode(out[i].uvs) - vertex.UVs)));
+
+                max_position = std::max(max_position, MaxComponent(glm::abs(local)));
+                max_uv = std::max(max_uv, MaxComponent(glm::abs(vertex.UVs)));
+            }
+
+            report.position_bound = PositionEncoding::ErrorBound(max_position) * MaxComponent(scale);
+            report.color_bound = ColorEncoding::ErrorBound(1.0f);
+            report.uv_bound = UVEncoding::ErrorBound(max_uv);
+            report.source_bytes = vertices.size() * sizeof(Vertex);
+            report.packed_bytes = packed.size();
+            return report;
+        }
+
+       private:
+        static float MaxComponent(const glm::vec3& value) { return std::max(value.x, std::max(value.y, value.z)); }
+        static float MaxComponent(const glm::vec2& value) { return std::max(value.x, value.y); }
+    };
+
+    using FullVertexLayout = VertexLayout<Float3Attribute, Float3Attribute, Float2Attribute>;
+    using HalfVertexLayout = VertexLayout<Half3Attribute, Unorm8x3Attribute, Half2Attribute>;
+    using QuantizedVertexLayout = VertexLayout<Snorm16x3Attribute, Unorm8x3Attribute, Half2Attribute>;
+
+    // Selected with the MVK_VERTEX_LAYOUT CMake option.
+    #if defined(MVK_VERTEX_LAYOUT_QUANTIZED)
+        using ActiveVertexLayout = QuantizedVertexLayout;
+    #elif defined(MVK_VERTEX_LAYOUT_HALF)
+        using ActiveVertexLayout = HalfVertexLayout;
+    #else
+        using ActiveVertexLayout = FullVertexLayout;
+    #endif
+}
+
+#endif  // MVK_VERTEX_LAYOUT
@@ -1,6 +1,10 @@
 #include "../QueueFamilies/QueueFamilies.h"
 #include "VulkanManager.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
@@ -22,6 +26,12 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
     return VK_FALSE;
 }
 
+// MVK_PROFILE set to anything but empty or 0.
+static bool ProfilingRequestedByEnvironment() {
+    const char* value = std::getenv("MVK_PROFILE");
+    return value && value[0] != '\0' && std::string(value) != "0";
+}
+
 namespace mvk {
     void VulkanManager::CreateInstance() {
         if (ENABLE_VALIDATION_LAYERS && !vo_.validator.CheckValidationLayersSupport(VALIDATION_LAYERS))
@@ -39,7 +49,7 @@ namespace mvk {
         create_info.sType = vk::StructureType::eInstanceCreateInfo;
         create_info.setPApplicationInfo(&app_info);
 
-        auto requirment_extensions = vo_.validator.SetRequirmentInstanceExtension(ENABLE_VALIDATION_LAYERS, INSTANCE_REQUIRED_EXTENSIONS);
+        auto requirment_extensions = vo_.validator.SetRequirmentInstanceExtension(ENABLE_VALIDATION_LAYERS, INSTANCE_REQUIRED_EXTENSIONS, vo_.headless);
         vo_.validator.CheckRequestedInstanceExtensions(requirment_extensions);
         create_info.setEnabledExtensionCount(requirment_extensions.size());
         create_info.setPpEnabledExtensionNames(requirment_extensions.data());
@@ -69,6 +79,7 @@ namespace mvk {
         if (vk::createInstance(&create_info, nullptr, &vo_.instance) != vk::Result::eSuccess) {
             throw std::runtime_error("Cannot create instance.");
         }
+        vo_.dispatch.InitInstance(vo_.instance);
     }
 
     void VulkanManager::SetupDebug() {
@@ -77,11 +88,13 @@ namespace mvk {
         vk::DebugUtilsMessengerCreateInfoEXT debug_info;
         FillDebugInfo(debug_info);
 
-        vo_.debug_messenger = vo_.instance.createDebugUtilsMessengerEXT(debug_info, nullptr, vk::DispatchLoaderDynamic(vo_.instance, vkGetInstanceProcAddr));
+        vo_.debug_messenger = vo_.instance.createDebugUtilsMessengerEXT(debug_info, nullptr, vo_.dispatch.get());
     }
 
     void VulkanManager::CreateSurface(GLFWwindow *window) {
         window_ = window;
+        if (vo_.headless) return;
+
         VkSurfaceKHR surface;
         if (glfwCreateWindowSurface(vo_.instance, window, nullptr, &surface) != VK_SUCCESS)
             throw std::runtime_error("Failed to create window surface.");
@@ -94,7 +107,7 @@ namespace mvk {
         if (devices.size() == 0) throw std::runtime_error("Supported GPU not found.");
 
         for (auto &device : devices) {
-            if (vo_.validator.CheckVideocard(device, vo_.surface, DEVICE_REQUIRED_EXTENSIONS)) {
+            if (vo_.validator.CheckVideocard(device, vo_.surface, RequiredDeviceExtensions())) {
                 vo_.physical_device = device;
                 break;
             }
@@ -107,13 +120,15 @@ namespace mvk {
         QueueFamilies indices = QueueFamilies::FindQueueFamily(vo_.physical_device, vo_.surface);
 
         std::vector<vk::DeviceQueueCreateInfo> device_queue_infos{};
-        std::set<uint32_t> unique_families = {indices.graphics_family_.value(), indices.present_family_.value()};
+        uint32_t transfer_family = indices.transfer_family_.value_or(indices.graphics_family_.value());
+        uint32_t compute_family = indices.compute_family_.value_or(indices.graphics_family_.value());
+        std::set<uint32_t> unique_families = {indices.graphics_family_.value(), indices.present_family_.value(), transfer_family, compute_family};
 
         float q = 1.0f;
         for (auto &queue_family : unique_families) {
             vk::DeviceQueueCreateInfo logical_device_queue_info{};
             logical_device_queue_info.sType = vk::StructureType::eDeviceQueueCreateInfo;
-            logical_device_queue_info.setQueueFamilyIndex(indices.graphics_family_.value());
+            logical_device_queue_info.setQueueFamilyIndex(queue_family);
             logical_device_queue_info.setQueueCount(1);
             logical_device_queue_info.setQueuePriorities(q);
             device_queue_infos.push_back(logical_device_queue_info);
@@ -123,36 +138,115 @@ namespace mvk {
         logical_device_info.sType = vk::StructureType::eDeviceCreateInfo;
         logical_device_info.setQueueCreateInfoCount(device_queue_infos.size());
         logical_device_info.setPQueueCreateInfos(device_queue_infos.data());
-        logical_device_info.setEnabledExtensionCount(static_cast<uint32_t>(DEVICE_REQUIRED_EXTENSIONS.size()));
-        logical_device_info.setPpEnabledExtensionNames(DEVICE_REQUIRED_EXTENSIONS.data());
+        auto supported = vo_.physical_device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        const vk::PhysicalDeviceFeatures &supported_features = supported.get<vk::PhysicalDeviceFeatures2>().features;
+        // Descriptor indexing was checked by TakeVideocard.
+        vo_.draw_indirect_count = supported.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount &&
+                                  supported_features.multiDrawIndirect && supported_features.drawIndirectFirstInstance;
+        // Extension feature structs may only be chained when the device lists the extension.
+        vo_.present_wait = false;
+        if (!vo_.headless && vo_.validator.CheckDeviceExtensions(vo_.physical_device, DEVICE_PRESENT_WAIT_EXTENSIONS)) {
+            auto present = vo_.physical_device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDevicePresentIdFeaturesKHR,
+                                                            vk::PhysicalDevicePresentWaitFeaturesKHR>();
+            vo_.present_wait = present.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId &&
+                               present.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait;
+        }
 
+        bool feedback_extension = false;
+        vo_.creation_feedback = vo_.physical_device.getProperties().apiVersion >= VK_API_VERSION_1_3;
+        if (!vo_.creation_feedback && vo_.validator.CheckDeviceExtensions(vo_.physical_device, DEVICE_CREATION_FEEDBACK_EXTENSIONS))
+            vo_.creation_feedback = feedback_extension = true;
+
+        std::vector<const char*> device_extensions = RequiredDeviceExtensions();
+        if (vo_.present_wait)
+            device_extensions.insert(device_extensions.end(), DEVICE_PRESENT_WAIT_EXTENSIONS.begin(), DEVICE_PRESENT_WAIT_EXTENSIONS.end());
+        if (feedback_extension)
+            device_extensions.insert(device_extensions.end(), DEVICE_CREATION_FEEDBACK_EXTENSIONS.begin(), DEVICE_CREATION_FEEDBACK_EXTENSIONS.end());
+        logical_device_info.setEnabledExtensionCount(static_cast<uint32_t>(device_extensions.size()));
+        logical_device_info.setPpEnabledExtensionNames(device_extensions.data());
 
         vk::PhysicalDeviceFeatures features{};
         features.setFillModeNonSolid(VK_TRUE);
         features.setSamplerAnisotropy(VK_TRUE);
+        features.setPipelineStatisticsQuery(supported_features.pipelineStatisticsQuery);
+        vo_.inherited_queries = supported_features.pipelineStatisticsQuery && supported_features.inheritedQueries;
+        features.setInheritedQueries(vo_.inherited_queries);
+        features.setMultiDrawIndirect(vo_.draw_indirect_count);
+        features.setDrawIndirectFirstInstance(vo_.draw_indirect_count);
         logical_device_info.setPEnabledFeatures(&features);
 
+        vk::PhysicalDeviceVulkan12Features vulkan12_features{};
+        vulkan12_features.sType = vk::StructureType::ePhysicalDeviceVulkan12Features;
+        vulkan12_features.setDrawIndirectCount(vo_.draw_indirect_count);
+        vulkan12_features.setDescriptorIndexing(VK_TRUE);
+        vulkan12_features.setRuntimeDescriptorArray(VK_TRUE);
+        vulkan12_features.setDescriptorBindingPartiallyBound(VK_TRUE);
+        vulkan12_features.setShaderSampledImageArrayNonUniformIndexing(VK_TRUE);
+        vulkan12_features.setDescriptorBindingSampledImageUpdateAfterBind(VK_TRUE);
+        vulkan12_features.setDescriptorBindingUpdateUnusedWhilePending(VK_TRUE);
+
+        vk::PhysicalDevicePresentWaitFeaturesKHR present_wait_features{};
+        present_wait_features.sType = vk::StructureType::ePhysicalDevicePresentWaitFeaturesKHR;
+        present_wait_features.setPresentWait(VK_TRUE);
+
+        vk::PhysicalDevicePresentIdFeaturesKHR present_id_features{};
+        present_id_features.sType = vk::StructureType::ePhysicalDevicePresentIdFeaturesKHR;
+        present_id_features.setPresentId(VK_TRUE);
+        present_id_features.setPNext(&present_wait_features);
+        if (vo_.present_wait)
+            vulkan12_features.setPNext(&present_id_features);
+
         vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT extended_features{};
         extended_features.sType = vk::StructureType::ePhysicalDeviceExtendedDynamicState3FeaturesEXT;
         extended_features.setExtendedDynamicState3PolygonMode(VK_TRUE);
+        extended_features.setPNext(&vulkan12_features);
         logical_device_info.setPNext(&extended_features);
 
         vo_.logical_device = vo_.physical_device.createDevice(logical_device_info);
+        vo_.dispatch.InitDevice(vo_.logical_device);
         vo_.graphics_queue = vo_.logical_device.getQueue(indices.graphics_family_.value(), 0);
         vo_.present_queue = vo_.logical_device.getQueue(indices.present_family_.value(), 0);
+        vo_.transfer_queue = vo_.logical_device.getQueue(transfer_family, 0);
+        vo_.compute_queue = vo_.logical_device.getQueue(compute_family, 0);
+    }
+
+    void VulkanManager::CreateAllocator() {
+        vo_.allocator.Init(vo_.physical_device, vo_.logical_device);
+    }
+
+    void VulkanManager::CreateFramePacer() {
+        vo_.pacer.Init(vo_.logical_device, vo_.dispatch, vo_.pacing, vo_.present_wait);
+        vo_.deletion.Init(vo_.pacer.frames_in_flight());
+        if (!vo_.headless && !vo_.present_wait)
+            std::cout << "\u001b[33mWARNING: VK_KHR_present_wait unavailable, present latency is not measured.\u001b[0m\n";
+    }
+
+    void VulkanManager::CreatePipelineCache() {
+        vo_.pipeline_cache.Init(vo_.physical_device, vo_.logical_device, AssetPaths::Output(PIPELINE_CACHE_PATH), vo_.creation_feedback);
+        vo_.pipelines.Init(vo_.logical_device, vo_.pipeline_cache);
     }
 
     void VulkanManager::CreateSwapChain(bool prev) {
+        if (vo_.headless) {
+            uint32_t image_count = std::max(vo_.pacing.swapchain_images, vo_.pacer.frames_in_flight() + 1);
+            vo_.offscreen.Init(vo_.logical_device, vo_.allocator, HEADLESS_FORMAT,
+                               vk::Extent2D(WIDTH, HEIGHT), image_count);
+            vo_.swapchain_images = vo_.offscreen.images();
+            vo_.sc_format = vo_.offscreen.format();
+            vo_.sc_extent = vo_.offscreen.extent();
+            return;
+        }
+
         SwapChainDetails sc_details(vo_.physical_device, vo_.surface);
 
         vk::SurfaceFormatKHR format = sc_details.ChooseSwapSurfaceFormat();
-        vk::PresentModeKHR present_mode = sc_details.ChooseSwapPresentMode();
+        vk::PresentModeKHR present_mode = sc_details.ChooseSwapPresentMode(vo_.pacing.present_mode);
         vk::Extent2D extent = sc_details.ChooseSwapExtent(window_);
+        uint32_t image_count = sc_details.ChooseImageCount(vo_.pacing.swapchain_images);
 
-        uint32_t image_count = sc_details.capabilities_.minImageCount + 1;
-        if (sc_details.capabilities_.maxImageCount > 0 &&
-            image_count > sc_details.capabilities_.maxImageCount)
-            image_count = sc_details.capabilities_.maxImageCount;
+        if (present_mode != vo_.pacing.present_mode)
+            std::cout << "\u001b[33mWARNING: Present mode " << vk::to_string(vo_.pacing.present_mode)
+                      << " unsupported by the surface, using " << vk::to_string(present_mode) << ".\u001b[0m\n";
 
         vk::SwapchainCreateInfoKHR sc_info{};
         sc_info.sType = vk::StructureType::eSwapchainCreateInfoKHR;
@@ -188,9 +282,18 @@ namespace mvk {
         vo_.swapchain_images = vo_.logical_device.getSwapchainImagesKHR(vo_.swapchain);
         vo_.sc_format = format.format;
         vo_.sc_extent = extent;
-
-        if (prev)
-            vo_.logical_device.destroySwapchainKHR(old_sc);
+        vo_.pacer.SetSwapchain(vo_.swapchain, present_mode, static_cast<uint32_t>(vo_.swapchain_images.size()));
+
+        // Frames in flight may still present from the retired swapchain, and the pacer's
+        // latency thread may still be waiting on one of those presents.
+        if (prev) {
+            vk::Device device = vo_.logical_device;
+            FramePacer* pacer = &vo_.pacer;
+            vo_.deletion.Retire([device, pacer, old_sc]() {
+                pacer->ReleaseSwapchain(old_sc);
+                device.destroySwapchainKHR(old_sc);
+            });
+        }
     }
 
     void VulkanManager::RecreateSwapChain() {
@@ -201,13 +304,16 @@ namespace mvk {
             glfwWaitEvents();
         }
 
-        vo_.logical_device.waitIdle();
+        // Nothing waits for the device: frames in flight finish with the old images while
+        // the next frame already renders into the new swapchain, and everything tied to
+        // the old one goes through the deletion queue.
+        CpuScope scope(vo_.profiler, "RecreateSwapChain");
+        RetireSwapchainImages();
 
-        DestroySwapchainImages();
-
-        CreateSwapChain(&vo_.swapchain);
+        CreateSwapChain(true);
         CreateImageViews();
         CreateFramebuffers();
+        CreatePresentSemaphores();
     }
 
     void VulkanManager::CreateImageViews() {
@@ -227,7 +333,8 @@ namespace mvk {
         color_attachment.setStencilLoadOp(vk::AttachmentLoadOp::eDontCare);
         color_attachment.setStencilStoreOp(vk::AttachmentStoreOp::eDontCare);
         color_attachment.setInitialLayout(vk::ImageLayout::eUndefined);
-        color_attachment.setFinalLayout(vk::ImageLayout::ePresentSrcKHR);
+        // Offscreen images are left ready to be copied out instead of presented.
+        color_attachment.setFinalLayout(vo_.headless ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR);
 
         vk::AttachmentReference color_attachment_ref{};
         color_attachment_ref.setAttachment(0);
@@ -262,18 +369,19 @@ namespace mvk {
         vk::DescriptorSetLayoutBinding descriptor_binding{};
         descriptor_binding.setBinding(0);
         descriptor_binding.setDescriptorCount(1);
-        descriptor_binding.setDescriptorType(vk::DescriptorType::eUniformBuffer);
+        descriptor_binding.setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
         descriptor_binding.setPImmutableSamplers(nullptr);
         descriptor_binding.setStageFlags(vk::ShaderStageFlagBits::eVertex);
 
-        vk::DescriptorSetLayoutBinding sampler_binding{};
-        sampler_binding.setBinding(1);
-        sampler_binding.setDescriptorCount(1);
-        sampler_binding.setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
-        sampler_binding.setPImmutableSamplers(nullptr);
-        sampler_binding.setStageFlags(vk::ShaderStageFlagBits::eFragment);
+        vk::DescriptorSetLayoutBinding objects_binding{};
+        objects_binding.setBinding(2);
+        objects_binding.setDescriptorCount(1);
+        objects_binding.setDescriptorType(vk::DescriptorType::eStorageBuffer);
+        objects_binding.setPImmutableSamplers(nullptr);
+        objects_binding.setStageFlags(vk::ShaderStageFlagBits::eVertex);
 
-        std::array<vk::DescriptorSetLayoutBinding, 2> bindings = { descriptor_binding, sampler_binding };
+        // Binding 1 used to be the texture; textures now live in the bindless table (set 1).
+        std::array<vk::DescriptorSetLayoutBinding, 2> bindings = { descriptor_binding, objects_binding };
 
         vk::DescriptorSetLayoutCreateInfo descriptor_info{};
         descriptor_info.sType = vk::StructureType::eDescriptorSetLayoutCreateInfo;
@@ -285,61 +393,33 @@ namespace mvk {
         }
     }
 
-    void VulkanManager::CreateGraphicsPipeline() {
-        vk::ShaderModuleCreateInfo vertex_info = ShadersHelper::LoadVertexShader();
-        vk::ShaderModuleCreateInfo fragment_info = ShadersHelper::LoadFragmentShader();
-        
-        vk::ShaderModule vertex_module = vo_.logical_device.createShaderModule(vertex_info);
-        vk::ShaderModule fragment_module = vo_.logical_device.createShaderModule(fragment_info);
-
-
-        mvk::GraphicsSettings graphics_settings;
-        auto shader_stages = graphics_settings.CreateShadersStages({vertex_module, fragment_module});
-        auto vertex_input_info = graphics_settings.CreateVertexInput();
-        auto input_assembly_info = graphics_settings.CreateInputAssembly();
-        auto viewport_info = graphics_settings.CreateViewport();
-        auto rasterizer_info = graphics_settings.CreateRasterizer();
-        auto multisampling_info = graphics_settings.CreateMultisampling();
-        auto colorblend = graphics_settings.CreateColorBlend();
-        auto colorblend_info = graphics_settings.CreateColorBlendInfo(colorblend);
-        auto dynamic_state_info = graphics_settings.CreateDynamicStates();
-
+    void VulkanManager::CreateBindlessTable() {
+        vo_.bindless.Init(vo_.physical_device, vo_.logical_device, vo_.allocator, MAX_BINDLESS_TEXTURES, MAX_MATERIALS, vo_.pacer.frames_in_flight());
+    }
 
+    void VulkanManager::CreateGraphicsPipeline() {
         vk::PipelineLayoutCreateInfo layout_info{};
         layout_info.sType = vk::StructureType::ePipelineLayoutCreateInfo;
-        layout_info.setSetLayoutCount(1);
-        layout_info.setPSetLayouts(&vo_.descriptor_set_layout);
-
-        vo_.layout = vo_.logical_device.createPipelineLayout(layout_info);
-        
+        std::array<vk::DescriptorSetLayout, 2> set_layouts = { vo_.descriptor_set_layout, vo_.bindless.layout() };
+        layout_info.setSetLayoutCount(set_layouts.size());
+        layout_info.setPSetLayouts(set_layouts.data());
 
-        vk::GraphicsPipelineCreateInfo pipeline_info{};
-        pipeline_info.sType = vk::StructureType::eGraphicsPipelineCreateInfo;
-        pipeline_info.setStageCount(shader_stages.size());
-        pipeline_info.setStages(shader_stages);
 
-        pipeline_info.setPVertexInputState(&vertex_input_info);
-        pipeline_info.setPInputAssemblyState(&input_assembly_info);
-        pipeline_info.setPViewportState(&viewport_info);
-        pipeline_info.setPRasterizationState(&rasterizer_info);
-        pipeline_info.setPMultisampleState(&multisampling_info);
-        pipeline_info.setPDepthStencilState(nullptr);
-        pipeline_info.setPDynamicState(&dynamic_state_info);
-        pipeline_info.setPColorBlendState(&colorblend_info);
-        pipeline_info.setLayout(vo_.layout);
-        pipeline_info.setRenderPass(vo_.render_pass);
-        pipeline_info.setSubpass(0);
-        pipeline_info.setBasePipelineHandle(VK_NULL_HANDLE);
-        pipeline_info.setBasePipelineIndex(-1);
+        vo_.layout = vo_.logical_device.createPipelineLayout(layout_info);
 
-        auto res = vo_.logical_device.createGraphicsPipeline(VK_NULL_HANDLE, pipeline_info);
-        if (res.result != vk::Result::eSuccess)
-            throw std::runtime_error("Cannot create pipeline.");
-        vo_.pipeline = res.value;
+        mvk::GraphicsSettings graphics_settings;
+        PipelineHandle handle = vo_.pipelines.Request(graphics_settings.CreateDescription(), vo_.layout, vo_.render_pass);
+        vo_.instanced_pipeline = vo_.pipelines.Request(graphics_settings.CreateInstancedDescription(), vo_.layout, vo_.render_pass);
 
+        // Further variants can be requested here and bound once IsReady(); only the
+        // pipeline the first frame needs is waited for.
+        vo_.pipeline = handle.Get();
+    }
 
-        vo_.logical_device.destroyShaderModule(vertex_module);
-        vo_.logical_device.destroyShaderModule(fragment_module);
+    void VulkanManager::CreateCullingPipeline() {
+        vo_.culling.Init(vo_.logical_device, vo_.allocator, vo_.dispatch, vo_.pipeline_cache.get_cache(), MAX_DRAW_OBJECTS, vo_.pacer.frames_in_flight());
+        if (!vo_.draw_indirect_count)
+            std::cout << "\u001b[33mWARNING: drawIndirectCount unsupported, culling is disabled and draws are recorded on the CPU.\u001b[0m\n";
     }
 
     void VulkanManager::CreateFramebuffers() {
@@ -360,218 +440,147 @@ namespace mvk {
         }
     }
 
-    void VulkanManager::CreateCommandPool() {
+    void VulkanManager::CreateUploader() {
         QueueFamilies queue = QueueFamilies::FindQueueFamily(vo_.physical_device, vo_.surface);
-        vk::CommandPoolCreateInfo cmd_pool_info{};
-        cmd_pool_info.sType = vk::StructureType::eCommandPoolCreateInfo;
-        cmd_pool_info.setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
-        cmd_pool_info.setQueueFamilyIndex(queue.graphics_family_.value());
-
-        vo_.command_pool = vo_.logical_device.createCommandPool(cmd_pool_info);
+        vo_.uploader.Init(vo_.logical_device, vo_.allocator,
+                          vo_.transfer_queue, queue.transfer_family_.value_or(queue.graphics_family_.value()),
+                          vo_.graphics_queue, queue.graphics_family_.value());
     }
 
-    void VulkanManager::CreateTextureImage() {
-        int tex_width, tex_height, tex_channels;
-        stbi_uc* pixels = stbi_load(TEXTURE_IMAGE_PATH.c_str(), &tex_width, &tex_height, &tex_channels, STBI_rgb_alpha);
-
-        vk::DeviceSize image_size = tex_width * tex_height * 4;
-
-        if (!pixels)
-            throw std::runtime_error("Failed to load texture image.");
-
-        vk::Buffer staging_buffer;
-        vk::DeviceMemory staging_memory;
-
-        CreateBuffer(image_size,
-                     vk::BufferUsageFlagBits::eTransferSrc,
-                     vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent),
-                     staging_buffer,
-                     staging_memory);
-        
-        void *data = vo_.logical_device.mapMemory(staging_memory, 0, image_size);
-        std::memcpy(data, pixels, image_size);
-        vo_.logical_device.unmapMemory(staging_memory);
-
-        stbi_image_free(pixels);
-
-        CreateImage(tex_width, tex_height, vk::Format::eR8G8B8A8Srgb, vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
-                    vk::MemoryPropertyFlagBits::eDeviceLocal, vo_.texture_image, vo_.texture_memory);
-    
-        TransitionImageLayout(vo_.texture_image, vk::Format::eR8G8B8A8Srgb, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
-        CopyBufferToImage(staging_buffer, vo_.texture_image, tex_width, tex_height);
-        TransitionImageLayout(vo_.texture_image, vk::Format::eR8G8B8A8Srgb, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
-    
-        vo_.logical_device.destroyBuffer(staging_buffer);
-        vo_.logical_device.freeMemory(staging_memory);
-    }
+    void VulkanManager::CreateTextureStreamer() {
+        vo_.streamer.Init(vo_.physical_device, vo_.logical_device, vo_.allocator, vo_.uploader, vo_.bindless, vo_.pacer.frames_in_flight());
 
-    void VulkanManager::CreateTextureImageView() {
-        vo_.texture_image_view = CreateImageView(vo_.texture_image, vk::Format::eR8G8B8A8Srgb);
+        // The default material samples the placeholder until the texture has streamed in.
+        std::string ktx2_path = AssetPaths::Asset(TEXTURE_KTX2_PATH);
+        std::string image_path = AssetPaths::Asset(TEXTURE_IMAGE_PATH);
+        if (std::filesystem::exists(ktx2_path))
+            vo_.default_material = vo_.streamer.Request(ktx2_path, MaterialData{}, image_path);
+        else
+            vo_.default_material = vo_.streamer.Request(image_path, MaterialData{});
     }
 
     void VulkanManager::CreateTextureSampler() {
-        auto texture_settings = GraphicsSettings::SetupTextureSettings(vo_.physical_device);
+        auto texture_settings = GraphicsSettings::SetupTextureSettings(vo_.physical_device, vo_.texture_max_lod);
 
         vo_.texture_sampler = vo_.logical_device.createSampler(texture_settings);
     }
 
     void VulkanManager::CreateVertexBuffer() {
-        vk::DeviceSize buffer_size = sizeof(vo_.loader.object[0]) * vo_.loader.object.size();
-        // vk::DeviceSize buffer_size = sizeof(VERTICES[0]) * VERTICES.size();
-
-        vk::Buffer staging_buffer;
-        vk::DeviceMemory staging_memory;
-
-        CreateBuffer(buffer_size,
-                     vk::BufferUsageFlagBits::eTransferSrc,
-                     vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent),
-                     staging_buffer,
-                     staging_memory);
-
-        void *data = vo_.logical_device.mapMemory(staging_memory, 0, buffer_size);
-        std::memcpy(data, vo_.loader.object.data(), buffer_size);
-        vo_.logical_device.unmapMemory(staging_memory);
+        vk::DeviceSize buffer_size = vo_.loader.vertex_data_size();
 
         CreateBuffer(buffer_size,
                      vk::BufferUsageFlags(vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer),
                      vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eDeviceLocal),
                      vo_.vertex_buffer,
-                     vo_.vertex_memory);
-
-        CopyBuffer(staging_buffer, vo_.vertex_buffer, buffer_size);
+                     vo_.vertex_allocation);
 
-        vo_.logical_device.destroyBuffer(staging_buffer);
-        vo_.logical_device.freeMemory(staging_memory);
+        vo_.uploader.UploadBuffer(vo_.vertex_buffer, 0, vo_.loader.vertex_data(), buffer_size);
     }
 
     void VulkanManager::CreateIndexBuffer() {
-        vk::DeviceSize buffer_size = sizeof(INDICES[0]) * INDICES.size();
-
-        vk::Buffer staging_buffer;
-        vk::DeviceMemory staging_memory;
-
-        CreateBuffer(buffer_size,
-                     vk::BufferUsageFlagBits::eTransferSrc,
-                     vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent),
-                     staging_buffer,
-                     staging_memory);
-
-        void *data = vo_.logical_device.mapMemory(staging_memory, 0, buffer_size);
-        std::memcpy(data, INDICES.data(), buffer_size);
-        vo_.logical_device.unmapMemory(staging_memory);
+        vk::DeviceSize buffer_size = vo_.loader.index_data_size();
 
         CreateBuffer(buffer_size,
                      vk::BufferUsageFlags(vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer),
                      vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eDeviceLocal),
                      vo_.indices_buffer,
-                     vo_.indices_memory);
+                     vo_.indices_allocation);
 
-        CopyBuffer(staging_buffer, vo_.indices_buffer, buffer_size);
+        vo_.uploader.UploadBuffer(vo_.indices_buffer, 0, vo_.loader.index_data(), buffer_size);
+    }
 
-        vo_.logical_device.destroyBuffer(staging_buffer);
-        vo_.logical_device.freeMemory(staging_memory);
+    // Uploads recorded during setup go out as one batch. Frames are submitted to the
+    // same queue afterwards, so nothing has to wait for the copies on the CPU.
+    void VulkanManager::SubmitUploads() {
+        vo_.uploader.Flush();
     }
 
     void VulkanManager::CreateUniformBuffers() {
-        vk::DeviceSize buffer_size = sizeof(MVP);
-
-        vo_.uniform_buffers.resize(MAX_FRAMES);
-        vo_.uniform_memories.resize(MAX_FRAMES);
-        vo_.uniform_maps.resize(MAX_FRAMES);
-        
-        for (size_t i = 0; i < MAX_FRAMES; ++i) {
-            CreateBuffer(buffer_size,
-                         vk::BufferUsageFlagBits::eUniformBuffer,
-                         vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent),
-                         vo_.uniform_buffers[i],
-                         vo_.uniform_memories[i]);
-
-            vo_.uniform_maps[i] = vo_.logical_device.mapMemory(vo_.uniform_memories[i], 0, buffer_size);
-        }
-
+        vk::DeviceSize alignment = vo_.physical_device.getProperties().limits.minUniformBufferOffsetAlignment;
+        vo_.uniforms.Init(vo_.logical_device, vo_.allocator, alignment, UNIFORM_BYTES_PER_FRAME, vo_.pacer.frames_in_flight());
     }
 
     void VulkanManager::CreateDescriptorPool() {
         vk::DescriptorPoolSize mvp_desc_pool_size{};
-        mvp_desc_pool_size.setType(vk::DescriptorType::eUniformBuffer);
-        mvp_desc_pool_size.setDescriptorCount(MAX_FRAMES);
+        mvp_desc_pool_size.setType(vk::DescriptorType::eUniformBufferDynamic);
+        mvp_desc_pool_size.setDescriptorCount(vo_.pacer.frames_in_flight());
 
-        vk::DescriptorPoolSize sampler_desc_pool_size{};
-        sampler_desc_pool_size.setType(vk::DescriptorType::eCombinedImageSampler);
-        sampler_desc_pool_size.setDescriptorCount(MAX_FRAMES);
+        vk::DescriptorPoolSize objects_desc_pool_size{};
+        objects_desc_pool_size.setType(vk::DescriptorType::eStorageBuffer);
+        objects_desc_pool_size.setDescriptorCount(vo_.pacer.frames_in_flight());
 
-        std::array<vk::DescriptorPoolSize, 2> desc_pool_sizes = { mvp_desc_pool_size, sampler_desc_pool_size };
+        std::array<vk::DescriptorPoolSize, 2> desc_pool_sizes = { mvp_desc_pool_size, objects_desc_pool_size };
 
         vk::DescriptorPoolCreateInfo desc_pool_info{};
         desc_pool_info.sType = vk::StructureType::eDescriptorPoolCreateInfo;
         desc_pool_info.setPoolSizeCount(desc_pool_sizes.size());
         desc_pool_info.setPPoolSizes(desc_pool_sizes.data());
-        desc_pool_info.setMaxSets(MAX_FRAMES);
+        desc_pool_info.setMaxSets(vo_.pacer.frames_in_flight());
 
         vo_.descriptor_pool = vo_.logical_device.createDescriptorPool(desc_pool_info);
     }
 
     void VulkanManager::CreateDescriptorSets() {
-        std::vector<vk::DescriptorSetLayout> layouts(MAX_FRAMES, vo_.descriptor_set_layout);
+        std::vector<vk::DescriptorSetLayout> layouts(vo_.pacer.frames_in_flight(), vo_.descriptor_set_layout);
 
         vk::DescriptorSetAllocateInfo desc_set_alloc_info{};
         desc_set_alloc_info.sType = vk::StructureType::eDescriptorSetAllocateInfo;
         desc_set_alloc_info.setDescriptorPool(vo_.descriptor_pool);
-        desc_set_alloc_info.setDescriptorSetCount(MAX_FRAMES);
+        desc_set_alloc_info.setDescriptorSetCount(vo_.pacer.frames_in_flight());
         desc_set_alloc_info.setPSetLayouts(layouts.data());
 
-        vo_.descriptor_sets.resize(MAX_FRAMES);
+        vo_.descriptor_sets.resize(vo_.pacer.frames_in_flight());
         if (vo_.logical_device.allocateDescriptorSets(&desc_set_alloc_info, vo_.descriptor_sets.data()) != vk::Result::eSuccess)
             throw std::runtime_error("Failed to create descriptor sets.");
         
-        for (size_t i = 0; i < MAX_FRAMES; ++i) {
+        for (size_t i = 0; i < vo_.pacer.frames_in_flight(); ++i) {
             vk::DescriptorBufferInfo desc_buffer_info{};
-            desc_buffer_info.setBuffer(vo_.uniform_buffers[i]);
+            // The range is one MVP; the dynamic offset given at bind time moves it through the buffer.
+            desc_buffer_info.setBuffer(vo_.uniforms.buffer(i));
             desc_buffer_info.setOffset(0);
             desc_buffer_info.setRange(sizeof(MVP));
 
-            vk::DescriptorImageInfo desc_image_info{};
-            desc_image_info.setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
-            desc_image_info.setImageView(vo_.texture_image_view);
-            desc_image_info.setSampler(vo_.texture_sampler);
-
             vk::WriteDescriptorSet write_uniform_desc_set{};
             write_uniform_desc_set.sType = vk::StructureType::eWriteDescriptorSet;
             write_uniform_desc_set.setDstSet(vo_.descriptor_sets[i]);
             write_uniform_desc_set.setDstBinding(0);
             write_uniform_desc_set.setDstArrayElement(0);
-            write_uniform_desc_set.setDescriptorType(vk::DescriptorType::eUniformBuffer);
+            write_uniform_desc_set.setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
             write_uniform_desc_set.setDescriptorCount(1);
             write_uniform_desc_set.setPBufferInfo(&desc_buffer_info);
             write_uniform_desc_set.setPImageInfo(nullptr);
             write_uniform_desc_set.setPTexelBufferView(nullptr);
 
-            vk::WriteDescriptorSet write_texture_desc_set{};
-            write_texture_desc_set.sType = vk::StructureType::eWriteDescriptorSet;
-            write_texture_desc_set.setDstSet(vo_.descriptor_sets[i]);
-            write_texture_desc_set.setDstBinding(1);
-            write_texture_desc_set.setDstArrayElement(0);
-            write_texture_desc_set.setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
-            write_texture_desc_set.setDescriptorCount(1);
-            write_texture_desc_set.setPImageInfo(&desc_image_info);
-            write_texture_desc_set.setPTexelBufferView(nullptr);
+            vk::DescriptorBufferInfo desc_objects_info{};
+            desc_objects_info.setBuffer(vo_.culling.object_buffer(i));
+            desc_objects_info.setOffset(0);
+            desc_objects_info.setRange(vo_.culling.object_buffer_size());
 
-            std::array<vk::WriteDescriptorSet, 2> write_desc_sets = { write_uniform_desc_set, write_texture_desc_set };
+            vk::WriteDescriptorSet write_objects_desc_set{};
+            write_objects_desc_set.sType = vk::StructureType::eWriteDescriptorSet;
+            write_objects_desc_set.setDstSet(vo_.descriptor_sets[i]);
+            write_objects_desc_set.setDstBinding(2);
+            write_objects_desc_set.setDstArrayElement(0);
+            write_objects_desc_set.setDescriptorType(vk::DescriptorType::eStorageBuffer);
+            write_objects_desc_set.setDescriptorCount(1);
+            write_objects_desc_set.setPBufferInfo(&desc_objects_info);
+
+            std::array<vk::WriteDescriptorSet, 2> write_desc_sets = { write_uniform_desc_set, write_objects_desc_set };
 
             vo_.logical_device.updateDescriptorSets(write_desc_sets.size(), write_desc_sets.data(), 0, nullptr);
         }
+
+        // Material 0 is the loaded texture untinted, the default for every draw.
+        vo_.bindless.SetSampler(vo_.texture_sampler);
     }
 
     void VulkanManager::CreateCommandBuffers() {
-        vk::CommandBufferAllocateInfo cmd_buff_ainfo{};
-        cmd_buff_ainfo.sType = vk::StructureType::eCommandBufferAllocateInfo;
-        cmd_buff_ainfo.setCommandPool(vo_.command_pool);
-        cmd_buff_ainfo.setLevel(vk::CommandBufferLevel::ePrimary);
+        QueueFamilies queue = QueueFamilies::FindQueueFamily(vo_.physical_device, vo_.surface);
+        vo_.recorder.Init(vo_.logical_device, vo_.dispatch, queue.graphics_family_.value(), vo_.pacer.frames_in_flight());
+    }
 
-        vo_.command_buffers.resize(MAX_FRAMES);
-        cmd_buff_ainfo.setCommandBufferCount(vo_.command_buffers.size());
-        if (vo_.logical_device.allocateCommandBuffers(&cmd_buff_ainfo, vo_.command_buffers.data()) != vk::Result::eSuccess)
-            throw std::runtime_error("Failed to allocate command buffer.");
+    void VulkanManager::CreateInstanceBuffers() {
+        vo_.instances.Init(vo_.logical_device, vo_.allocator, MAX_INSTANCES, vo_.pacer.frames_in_flight());
     }
 
     void VulkanManager::CreateSyncObjects() {
@@ -582,15 +591,45 @@ namespace mvk {
         fence_info.sType = vk::StructureType::eFenceCreateInfo;
         fence_info.setFlags(vk::FenceCreateFlagBits::eSignaled);
 
-        vo_.image_available_sems.resize(MAX_FRAMES);
-        vo_.render_finished_sems.resize(MAX_FRAMES);
-        vo_.in_flight_fences.resize(MAX_FRAMES);
+        vo_.image_available_sems.resize(vo_.pacer.frames_in_flight());
+        vo_.in_flight_fences.resize(vo_.pacer.frames_in_flight());
 
-        for (size_t i = 0; i < MAX_FRAMES; i++) {
+        for (size_t i = 0; i < vo_.pacer.frames_in_flight(); i++) {
             vo_.image_available_sems[i] = vo_.logical_device.createSemaphore(sem_info);
-            vo_.render_finished_sems[i] = vo_.logical_device.createSemaphore(sem_info);
             vo_.in_flight_fences[i] = vo_.logical_device.createFence(fence_info);
         }
+
+        CreatePresentSemaphores();
+    }
+
+    void VulkanManager::CreatePresentSemaphores() {
+        if (vo_.headless)
+            return;
+
+        // Presents to the old swapchain may not have waited on theirs yet, so the new
+        // swapchain gets a fresh set even when the image count is unchanged.
+        if (!vo_.render_finished_sems.empty()) {
+            vk::Device device = vo_.logical_device;
+            vo_.deletion.Retire([device, semaphores = vo_.render_finished_sems]() {
+                for (auto semaphore : semaphores)
+                    device.destroySemaphore(semaphore);
+            });
+        }
+
+        vk::SemaphoreCreateInfo sem_info{};
+        sem_info.sType = vk::StructureType::eSemaphoreCreateInfo;
+
+        vo_.render_finished_sems.resize(vo_.swapchain_images.size());
+        for (auto &semaphore : vo_.render_finished_sems)
+            semaphore = vo_.logical_device.createSemaphore(sem_info);
+    }
+
+    void VulkanManager::CreateProfiler() {
+        QueueFamilies queue = QueueFamilies::FindQueueFamily(vo_.physical_device, vo_.surface);
+        ProfilerSettings settings = vo_.profiling;
+        settings.enabled = settings.enabled || ProfilingRequestedByEnvironment();
+        vo_.profiler.Init(vo_.physical_device, vo_.logical_device, vo_.dispatch, queue.graphics_family_.value(), vo_.pacer.frames_in_flight(),
+                          vo_.inherited_queries, settings);
     }
 
     void VulkanManager::CreateObject() {
@@ -598,47 +637,71 @@ namespace mvk {
     }
 
     void VulkanManager::DestroyEverything() {
+        vo_.pacer.Destroy();
+        vo_.deletion.Flush();
         DestroySwapchainImages();
-        vo_.logical_device.destroySwapchainKHR(vo_.swapchain);
+        if (vo_.headless)
+            vo_.offscreen.Destroy();
+        else
+            vo_.logical_device.destroySwapchainKHR(vo_.swapchain);
 
         vo_.logical_device.destroySampler(vo_.texture_sampler);
-        vo_.logical_device.destroyImageView(vo_.texture_image_view);
-        vo_.logical_device.destroyImage(vo_.texture_image);
-        vo_.logical_device.freeMemory(vo_.texture_memory);
+        vo_.streamer.Destroy();
 
-        for (size_t i = 0; i < MAX_FRAMES; ++i) {
-            vo_.logical_device.destroyBuffer(vo_.uniform_buffers[i]);
-            vo_.logical_device.freeMemory(vo_.uniform_memories[i]);
-        }
+        vo_.uniforms.Destroy();
 
         vo_.logical_device.destroyDescriptorPool(vo_.descriptor_pool);
         vo_.logical_device.destroyDescriptorSetLayout(vo_.descriptor_set_layout);
+        vo_.bindless.Destroy();
 
-        for (size_t i = 0; i < MAX_FRAMES; ++i) {
+        for (size_t i = 0; i < vo_.pacer.frames_in_flight(); ++i) {
             vo_.logical_device.destroySemaphore(vo_.image_available_sems[i]);
-            vo_.logical_device.destroySemaphore(vo_.render_finished_sems[i]);
             vo_.logical_device.destroyFence(vo_.in_flight_fences[i]);
         }
+        for (auto semaphore : vo_.render_finished_sems)
+            vo_.logical_device.destroySemaphore(semaphore);
+
+        vo_.profiler.Destroy();
+        if (vo_.profiler.enabled())
+            vo_.profiler.WriteChromeTrace(AssetPaths::Output(PROFILER_TRACE_PATH));
 
         vo_.logical_device.destroyBuffer(vo_.vertex_buffer);
-        vo_.logical_device.freeMemory(vo_.vertex_memory);
+        vo_.allocator.Free(vo_.vertex_allocation);
 
         vo_.logical_device.destroyBuffer(vo_.indices_buffer);
-        vo_.logical_device.freeMemory(vo_.indices_memory);
+        vo_.allocator.Free(vo_.indices_allocation);
+
+        vo_.culling.Destroy();
+        vo_.instances.Destroy();
+        vo_.uploader.Destroy();
+        vo_.allocator.Destroy();
 
-        vo_.logical_device.destroyCommandPool(vo_.command_pool);
-        vo_.logical_device.destroyPipeline(vo_.pipeline);
+        vo_.recorder.Destroy();
+        vo_.pipelines.Destroy();
+        vo_.pipeline_cache.Save();
+        vo_.pipeline_cache.Destroy();
         vo_.logical_device.destroyPipelineLayout(vo_.layout);
         vo_.logical_device.destroyRenderPass(vo_.render_pass);
 
         if (ENABLE_VALIDATION_LAYERS)
-            vo_.instance.destroyDebugUtilsMessengerEXT(vo_.debug_messenger, nullptr, vk::DispatchLoaderDynamic(vo_.instance, vkGetInstanceProcAddr));
+            vo_.instance.destroyDebugUtilsMessengerEXT(vo_.debug_messenger, nullptr, vo_.dispatch.get());
 
         vo_.logical_device.destroy();
-        vo_.instance.destroySurfaceKHR(vo_.surface);
+        if (!vo_.headless)
+            vo_.instance.destroySurfaceKHR(vo_.surface);
         vo_.instance.destroy();
     }
 
+    std::vector<const char*> VulkanManager::RequiredDeviceExtensions() const {
+        std::vector<const char*> extensions;
+        for (const char* extension : DEVICE_REQUIRED_EXTENSIONS) {
+            if (vo_.headless && std::strcmp(extension, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0)
+                continue;
+            extensions.push_back(extension);
+        }
+        return extensions;
+    }
+
     void VulkanManager::DestroySwapchainImages() {
         for (auto framebuffer : vo_.framebuffers)
             vo_.logical_device.destroyFramebuffer(framebuffer);
@@ -647,6 +710,20 @@ namespace mvk {
             vo_.logical_device.destroyImageView(image_view);
     }
 
+    void VulkanManager::RetireSwapchainImages() {
+        vk::Device device = vo_.logical_device;
+        vo_.deletion.Retire([device, framebuffers = vo_.framebuffers, image_views = vo_.image_views]() {
+            for (auto framebuffer : framebuffers)
+                device.destroyFramebuffer(framebuffer);
+
+            for (auto image_view : image_views)
+                device.destroyImageView(image_view);
+        });
+
+        vo_.framebuffers.clear();
+        vo_.image_views.clear();
+    }
+
     vk::ImageView VulkanManager::CreateImageView(vk::Image image, vk::Format format) {
         vk::ImageViewCreateInfo image_info{};
         image_info.sType = vk::StructureType::eImageViewCreateInfo;
@@ -668,7 +745,7 @@ namespace mvk {
         return vo_.logical_device.createImageView(image_info);
     }
 
-    void VulkanManager::CreateBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer &buffer, vk::DeviceMemory &memory)
+    void VulkanManager::CreateBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer &buffer, Allocation &allocation)
     {
         vk::BufferCreateInfo buffer_info{};
         buffer_info.sType = vk::StructureType::eBufferCreateInfo;
@@ -679,161 +756,9 @@ namespace mvk {
         buffer = vo_.logical_device.createBuffer(buffer_info);
 
         vk::MemoryRequirements mem_reqs = vo_.logical_device.getBufferMemoryRequirements(buffer);
-        
-        vk::MemoryAllocateInfo alloc_info{};
-        alloc_info.sType = vk::StructureType::eMemoryAllocateInfo;
-        alloc_info.setAllocationSize(mem_reqs.size);
-        alloc_info.setMemoryTypeIndex(
-            vo_.validator.ChooseDeviceMemoryType(
-                mem_reqs.memoryTypeBits,
-                properties,
-                vo_.physical_device
-            )
-        );
-
-        memory = vo_.logical_device.allocateMemory(alloc_info);
-        vo_.logical_device.bindBufferMemory(buffer, memory, 0);
-    }
-
-    void VulkanManager::CopyBuffer(vk::Buffer src, vk::Buffer dst, vk::DeviceSize size) {
-        vk::CommandBuffer cmd_buffer = BeginSingletimeCommand();
-
-        vk::BufferCopy buff_copy{};
-        buff_copy.setDstOffset(0);
-        buff_copy.setSrcOffset(0);
-        buff_copy.setSize(size);
-
-        cmd_buffer.copyBuffer(src, dst, 1, &buff_copy);
-
-        EndSingletimeCommand(cmd_buffer);
-    }
-
-    void VulkanManager::CreateImage(uint32_t width,
-                                    uint32_t height,
-                                    vk::Format format,
-                                    vk::ImageTiling tiling,
-                                    vk::ImageUsageFlags usage,
-                                    vk::MemoryPropertyFlags properties,
-                                    vk::Image &image,
-                                    vk::DeviceMemory &memory) {
-        vk::ImageCreateInfo image_info{};
-        image_info.sType = vk::StructureType::eImageCreateInfo;
-        image_info.setImageType(vk::ImageType::e2D);
-        image_info.setExtent(vk::Extent3D(width, height, 1));
-        image_info.setMipLevels(1);
-        image_info.setArrayLayers(1);
-        image_info.setFormat(format);
-        image_info.setTiling(tiling);
-        image_info.setInitialLayout(vk::ImageLayout::eUndefined);
-        image_info.setUsage(usage);
-        image_info.setSharingMode(vk::SharingMode::eExclusive);
-        image_info.setSamples(vk::SampleCountFlagBits::e1);
-
-        image = vo_.logical_device.createImage(image_info);
-
-        vk::MemoryRequirements mem_reqs = vo_.logical_device.getImageMemoryRequirements(image);
-
-        vk::MemoryAllocateInfo mem_alloc_info{};
-        mem_alloc_info.sType = vk::StructureType::eMemoryAllocateInfo;
-        mem_alloc_info.setAllocationSize(mem_reqs.size);
-        mem_alloc_info.setMemoryTypeIndex(vo_.validator.ChooseDeviceMemoryType(mem_reqs.memoryTypeBits, properties, vo_.physical_device));
-
-        memory = vo_.logical_device.allocateMemory(mem_alloc_info);
-        vo_.logical_device.bindImageMemory(image, memory, 0);
-    }
-
-    void VulkanManager::TransitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout old_layout, vk::ImageLayout new_layout) {
-        vk::CommandBuffer cmd_buffer = BeginSingletimeCommand();
-
-        vk::ImageMemoryBarrier memory_barrier{};
-        memory_barrier.sType = vk::StructureType::eImageMemoryBarrier;
-        memory_barrier.setOldLayout(old_layout);
-        memory_barrier.setNewLayout(new_layout);
-
-        memory_barrier.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
-        memory_barrier.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
-
-        memory_barrier.setImage(image);
-        memory_barrier.setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
-
-
-        vk::PipelineStageFlags source_stage;
-        vk::PipelineStageFlags dest_stage;
-
-        if (old_layout == vk::ImageLayout::eUndefined && new_layout == vk::ImageLayout::eTransferDstOptimal) {
-            memory_barrier.setSrcAccessMask(vk::AccessFlagBits::eNone);
-            memory_barrier.setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
-
-            source_stage = vk::PipelineStageFlagBits::eTopOfPipe;
-            dest_stage = vk::PipelineStageFlagBits::eTransfer;
-        } else if (old_layout == vk::ImageLayout::eTransferDstOptimal && new_layout == vk::ImageLayout::eShaderReadOnlyOptimal) {
-            memory_barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
-            memory_barrier.setDstAccessMask(vk::AccessFlagBits::eShaderRead);
-
-            source_stage = vk::PipelineStageFlagBits::eTransfer;
-            dest_stage = vk::PipelineStageFlagBits::eFragmentShader;
-        }
-
-        cmd_buffer.pipelineBarrier(
-            source_stage, dest_stage,
-            vk::DependencyFlags(),
-            0, nullptr,
-            0, nullptr,
-            1, &memory_barrier
-        );
-
-        EndSingletimeCommand(cmd_buffer);
-    }
-
-    void VulkanManager::CopyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height) {
-        vk::CommandBuffer cmd_buffer = BeginSingletimeCommand();
-
-        vk::BufferImageCopy image_copy{};
-        image_copy.setBufferOffset(0);
-        image_copy.setBufferRowLength(0);
-        image_copy.setBufferImageHeight(0);
-        image_copy.setImageSubresource({vk::ImageAspectFlagBits::eColor, 0, 0, 1});
-        image_copy.setImageOffset({0, 0, 0});
-        image_copy.setImageExtent({width, height, 1});
-
-        cmd_buffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, 1, &image_copy);
-
-        EndSingletimeCommand(cmd_buffer);
-    }
-
-    vk::CommandBuffer VulkanManager::BeginSingletimeCommand() {
-        vk::CommandBufferAllocateInfo alloc_info{};
-        alloc_info.sType = vk::StructureType::eCommandBufferAllocateInfo;
-        alloc_info.setLevel(vk::CommandBufferLevel::ePrimary);
-        alloc_info.setCommandPool(vo_.command_pool);
-        alloc_info.setCommandBufferCount(1);
-
-        vk::CommandBuffer cmd_buffer;
-        if (vo_.logical_device.allocateCommandBuffers(&alloc_info, &cmd_buffer) != vk::Result::eSuccess)
-            throw std::runtime_error("Cannot allocate singletime command buffer.");
-
-        vk::CommandBufferBeginInfo begin_info{};
-        begin_info.sType = vk::StructureType::eCommandBufferBeginInfo;
-        begin_info.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-        cmd_buffer.begin(begin_info);
-
-        return cmd_buffer;
-    }
-
-    void VulkanManager::EndSingletimeCommand(vk::CommandBuffer cmd_buffer) {
-        cmd_buffer.end();
-
-        vk::SubmitInfo submit{};
-        submit.sType = vk::StructureType::eSubmitInfo;
-        submit.setCommandBufferCount(1);
-        submit.setPCommandBuffers(&cmd_buffer);
-
-        if (vo_.graphics_queue.submit(1, &submit, VK_NULL_HANDLE) != vk::Result::eSuccess)
-            throw std::runtime_error("Cannot submit singletime command to graphic queue.");
-
-        vo_.graphics_queue.waitIdle();
 
-        vo_.logical_device.freeCommandBuffers(vo_.command_pool, 1, &cmd_buffer);
+        allocation = vo_.allocator.Allocate(mem_reqs, properties, ResourceKind::eLinear);
+        vo_.logical_device.bindBufferMemory(buffer, allocation.memory, allocation.offset);
     }
 
     void VulkanManager::FillDebugInfo(vk::DebugUtilsMessengerCreateInfoEXT &debug_info)
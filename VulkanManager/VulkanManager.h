@@ -5,6 +5,7 @@
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.hpp>
 
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 #include <vector>
@@ -26,6 +27,9 @@ namespace mvk {
         void CreateSurface(GLFWwindow *window);
         void TakeVideocard();
         void CreateLogicalDevice();
+        void CreateAllocator();
+        void CreateFramePacer();
+        void CreatePipelineCache();
         
         void CreateSwapChain(bool prev = false);
         void RecreateSwapChain();
@@ -33,23 +37,27 @@ namespace mvk {
         void CreateImageViews();
         void CreateRenderPass();
         void CreateDescriptorSetLayout();
+        void CreateBindlessTable();
         void CreateGraphicsPipeline();
+        void CreateCullingPipeline();
         void CreateFramebuffers();
-        void CreateCommandPool();
+        void CreateUploader();
 
-        void CreateTextureImage();
-        void CreateTextureImageView();
+        void CreateTextureStreamer();
         void CreateTextureSampler();
         
         void CreateVertexBuffer();
         void CreateIndexBuffer();
+        void SubmitUploads();
         void CreateUniformBuffers();
         void CreateDescriptorPool();
         void CreateDescriptorSets();
 
 
         void CreateCommandBuffers();
+        void CreateInstanceBuffers();
         void CreateSyncObjects();
+        void CreateProfiler();
         void CreateObject();
 
         void DestroyEverything();
@@ -65,18 +73,16 @@ namespace mvk {
        private:
         vk::ImageView CreateImageView(vk::Image image, vk::Format format);
 
-        void CreateBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer &buffer, vk::DeviceMemory &memory);
-        void CopyBuffer(vk::Buffer src, vk::Buffer dst, vk::DeviceSize size);
-
-        void CreateImage(uint32_t width, uint32_t heigth, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Image &image, vk::DeviceMemory &memory);
-        void TransitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout old_layout, vk::ImageLayout new_layout);
-        void CopyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height);
-
-        vk::CommandBuffer BeginSingletimeCommand();
-        void EndSingletimeCommand(vk::CommandBuffer cmd_buffer);
+        void CreateBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer &buffer, Allocation &allocation);
 
         void FillDebugInfo(vk::DebugUtilsMessengerCreateInfoEXT &debug_info);
+        // DEVICE_REQUIRED_EXTENSIONS without VK_KHR_swapchain when headless.
+        std::vector<const char*> RequiredDeviceExtensions() const;
         void DestroySwapchainImages();
+        // Hands the image views and framebuffers to the deletion queue.
+        void RetireSwapchainImages();
+        // A fresh set for every swapchain; the previous set is retired.
+        void CreatePresentSemaphores();
         GLFWwindow *window_;
     };
 }
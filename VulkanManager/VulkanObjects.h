@@ -7,20 +7,49 @@
 
 #include "../VulkanValidator/VulkanValidator.h"
 #include "../ObjectLoader/ObjectLoader.h"
+#include "../MemoryAllocator/DeviceMemoryAllocator.h"
+#include "../StagingUploader/StagingUploader.h"
+#include "../PipelineCache/PipelineCache.h"
+#include "../PipelineRegistry/PipelineRegistry.h"
+#include "../OffscreenSwapchain/OffscreenSwapchain.h"
+#include "../GpuProfiler/GpuProfiler.h"
+#include "../DispatchTable/DispatchTable.h"
+#include "../CommandRecorder/CommandRecorder.h"
+#include "../GpuCulling/GpuCulling.h"
+#include "../InstanceBuffer/InstanceBuffer.h"
+#include "../UniformAllocator/UniformAllocator.h"
+#include "../BindlessTable/BindlessTable.h"
+#include "../TextureStreamer/TextureStreamer.h"
+#include "../FramePacer/FramePacer.h"
+#include "../DeletionQueue/DeletionQueue.h"
 
 namespace mvk {
     struct VulkanObjects {
         vk::Instance instance;
         vk::DebugUtilsMessengerEXT debug_messenger;
+        DispatchTable dispatch;
 
         vk::PhysicalDevice physical_device = VK_NULL_HANDLE;
         vk::Device logical_device;
         
         vk::Queue graphics_queue;
         vk::Queue present_queue;
+        vk::Queue transfer_queue;
+        vk::Queue compute_queue;
         
+        // No window, surface or VK_KHR_swapchain: frames go to the offscreen ring.
+        bool headless = false;
+        OffscreenSwapchain offscreen;
+
         vk::SurfaceKHR surface;
+        // Read by Setup and by every swapchain (re)creation.
+        FramePacingSettings pacing;
+        FramePacer pacer;
+        // VK_KHR_present_id and VK_KHR_present_wait are enabled.
+        bool present_wait = false;
         vk::SwapchainKHR swapchain;
+        // Swapchains, image views, framebuffers and semaphores replaced while frames are in flight.
+        DeletionQueue deletion;
         std::vector<vk::Image> swapchain_images;
         vk::Extent2D sc_extent;
         vk::Format sc_format;
@@ -30,36 +59,58 @@ namespace mvk {
         vk::PipelineLayout layout;
         vk::RenderPass render_pass;
         vk::Pipeline pipeline;
+        PipelineCache pipeline_cache;
+        // Vulkan 1.3 device or VK_EXT_pipeline_creation_feedback enabled.
+        bool creation_feedback = false;
+        PipelineRegistry pipelines;
+        // Same state as pipeline plus the per-instance stream; compiled in the background
+        // and only waited for by the first frame that draws instances.
+        PipelineHandle instanced_pipeline;
+        InstanceBuffer instances;
+        GpuCulling culling;
+        // drawIndexedIndirectCount with multiDrawIndirect and drawIndirectFirstInstance.
+        bool draw_indirect_count = false;
 
         std::vector<vk::Framebuffer> framebuffers;
 
-        vk::CommandPool command_pool;
-        std::vector<vk::CommandBuffer> command_buffers;
+        CommandRecorder recorder;
 
         std::vector<vk::Semaphore> image_available_sems;
+        // One per swapchain image: a present may still wait on it after the frame's
+        // fence has signalled, so it is reused only when its image comes round again.
+        // Recreating the swapchain retires the whole set.
         std::vector<vk::Semaphore> render_finished_sems;
         std::vector<vk::Fence> in_flight_fences;
+        // Read by Setup; MVK_PROFILE turns the profiler on as well.
+        ProfilerSettings profiling;
+        GpuProfiler profiler;
+        // Secondary buffers may run inside the profiler's pipeline-statistics query.
+        bool inherited_queries = false;
 
         VulkanValidator validator;
+        DeviceMemoryAllocator allocator;
+        StagingUploader uploader;
         
         ObjectLoader loader;
         vk::Buffer vertex_buffer;
-        vk::DeviceMemory vertex_memory;
+        Allocation vertex_allocation;
 
         vk::Buffer indices_buffer;
-        vk::DeviceMemory indices_memory;   
+        Allocation indices_allocation;   
 
-        std::vector<vk::Buffer> uniform_buffers; 
-        std::vector<vk::DeviceMemory> uniform_memories; 
-        std::vector<void*> uniform_maps;
+        // Binding 0 is eUniformBufferDynamic: draws pick their chunk with a dynamic offset.
+        UniformAllocator uniforms;
 
         vk::DescriptorPool descriptor_pool;
         std::vector<vk::DescriptorSet> descriptor_sets;
+        // Set 1 of every graphics pipeline: all textures and materials, bound once per pass.
+        BindlessTable bindless;
+        TextureStreamer streamer;
+        uint32_t default_material = 0;
 
-        vk::Image texture_image;
-        vk::DeviceMemory texture_memory;
-        vk::ImageView texture_image_view;
         vk::Sampler texture_sampler;
+        // Sampler maxLod; 0 samples only the base level, VK_LOD_CLAMP_NONE the whole chain.
+        float texture_max_lod = VK_LOD_CLAMP_NONE;
     };
 }
 
@@ -1,11 +1,15 @@
 #include "VulkanValidator.h"
 
 namespace mvk {
-    std::vector<const char*> VulkanValidator::SetRequirmentInstanceExtension(bool enable_validation_layers, std::vector<const char*> instance_extensions) {
-        uint32_t glfwExtensionCount;
-        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-        std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    std::vector<const char*> VulkanValidator::SetRequirmentInstanceExtension(bool enable_validation_layers, std::vector<const char*> instance_extensions, bool headless) {
+        std::vector<const char*> extensions;
+
+        // GLFW is never initialized without a window and has no surface extensions to ask for.
+        if (!headless) {
+            uint32_t glfwExtensionCount;
+            const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         if (enable_validation_layers) {
             extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -58,12 +62,12 @@ namespace mvk {
         bool ext_check = CheckDeviceExtensions(device, device_required_ext);
 
         bool swap_chain_support = false;
-        if (ext_check) {
+        if (ext_check && surface) {
             SwapChainDetails sc(device, surface);
             swap_chain_support = !sc.format_.empty() && !sc.present_modes_.empty();
         }
 
-        return family.IsComplete() && ext_check;
+        return family.IsComplete() && ext_check && CheckDescriptorIndexing(device);
     }
 
     bool VulkanValidator::CheckDeviceExtensions(vk::PhysicalDevice device, std::vector<const char *> device_required_ext) {
@@ -82,6 +86,18 @@ namespace mvk {
 
         return true;
     }
+    bool VulkanValidator::CheckDescriptorIndexing(vk::PhysicalDevice device) {
+        // The 1.2 feature struct may only be queried on 1.2 devices.
+        if (device.getProperties().apiVersion < VK_API_VERSION_1_2)
+            return false;
+
+        auto features = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        const vk::PhysicalDeviceVulkan12Features &vulkan12 = features.get<vk::PhysicalDeviceVulkan12Features>();
+        return vulkan12.descriptorIndexing && vulkan12.runtimeDescriptorArray && vulkan12.descriptorBindingPartiallyBound &&
+               vulkan12.shaderSampledImageArrayNonUniformIndexing && vulkan12.descriptorBindingSampledImageUpdateAfterBind &&
+               vulkan12.descriptorBindingUpdateUnusedWhilePending;
+    }
+
     uint32_t VulkanValidator::ChooseDeviceMemoryType(uint32_t filter, vk::MemoryPropertyFlags mem_properties, vk::PhysicalDevice& physical_device) {
         vk::PhysicalDeviceMemoryProperties physical_memory_props = physical_device.getMemoryProperties();
 
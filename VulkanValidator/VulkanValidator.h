@@ -12,13 +12,15 @@
 namespace mvk {
     class VulkanValidator {
        public:
-        std::vector<const char*> SetRequirmentInstanceExtension(bool enable_validation_layers, std::vector<const char*> instance_extensions);
+        std::vector<const char*> SetRequirmentInstanceExtension(bool enable_validation_layers, std::vector<const char*> instance_extensions, bool headless = false);
         
         void CheckRequestedInstanceExtensions(std::vector<const char*> requiement_extensions);
         bool CheckValidationLayersSupport(std::vector<const char *> validation_layers);
         bool CheckVideocard(vk::PhysicalDevice device, vk::SurfaceKHR surface, std::vector<const char *> device_required_ext);
         bool CheckDeviceExtensions(vk::PhysicalDevice device, std::vector<const char *> device_required_ext);
-        uint32_t ChooseDeviceMemoryType(uint32_t filter, vk::MemoryPropertyFlags mem_properties, vk::PhysicalDevice& physical_device);
+        // Vulkan 1.2 with the descriptor indexing features the bindless table is built on.
+        bool CheckDescriptorIndexing(vk::PhysicalDevice device);
+        static uint32_t ChooseDeviceMemoryType(uint32_t filter, vk::MemoryPropertyFlags mem_properties, vk::PhysicalDevice& physical_device);
     };
 }
 
@@ -2,19 +2,70 @@
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.hpp>
 
+#include <cstdlib>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 
+#include "AssetPaths/AssetPaths.h"
 #include "DisplayWindow/DisplayWindow.h"
 
-int main() {
+static vk::PresentModeKHR ParsePresentMode(const std::string& name) {
+    if (name == "fifo") return vk::PresentModeKHR::eFifo;
+    if (name == "fifo-relaxed") return vk::PresentModeKHR::eFifoRelaxed;
+    if (name == "mailbox") return vk::PresentModeKHR::eMailbox;
+    if (name == "immediate") return vk::PresentModeKHR::eImmediate;
+    throw std::runtime_error("Unknown present mode: " + name);
+}
+
+// Usage: mvk [--headless [frames]] [--present-mode fifo|fifo-relaxed|mailbox|immediate]
+//            [--images count] [--frames-in-flight count] [--max-fps fps]
+//            [--assets dir] [--output dir] [--profile [max events]]
+int main(int argc, char** argv) {
     mvk::DisplayWindow t;
 
+    bool headless = false;
+    uint32_t frames = 1000;
+    mvk::FramePacingSettings pacing;
+    mvk::ProfilerSettings profiling;
+
     try {
-        t.Run();
+        mvk::AssetPaths::TakeArguments(argc, argv);
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--headless") {
+                headless = true;
+                if (has_value && argv[i + 1][0] != '-')
+                    frames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--present-mode" && has_value) {
+                pacing.present_mode = ParsePresentMode(argv[++i]);
+            } else if (arg == "--images" && has_value) {
+                pacing.swapchain_images = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--frames-in-flight" && has_value) {
+                pacing.frames_in_flight = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--max-fps" && has_value) {
+                pacing.max_fps = std::strtod(argv[++i], nullptr);
+            } else if (arg == "--profile") {
+                // The trace goes to the output directory on exit.
+                profiling.enabled = true;
+                if (has_value && argv[i + 1][0] != '-')
+                    profiling.max_events = std::strtoull(argv[++i], nullptr, 10);
+            } else {
+                throw std::runtime_error("Unknown argument: " + arg);
+            }
+        }
+
+        t.SetFramePacing(pacing);
+        t.SetProfiling(profiling);
+        if (headless)
+            t.RunHeadless(frames);
+        else
+            t.Run();
     } catch(const std::exception& e) {
         std::cerr << e.what() << '\n';
         return -1;
     }
-    
+
     return 0;
 }